@@ -7,6 +7,7 @@
 //------------------------------------------------------------------------------
 #include "column.h"
 #include <cstdlib>     // atoll
+#include <memory>      // std::unique_ptr
 #include "datatable_check.h"
 #include "py_utils.h"
 #include "rowindex.h"
@@ -135,8 +136,15 @@ Column* Column::shallowcopy(const RowIndex& new_rowindex) const {
   if (new_rowindex) {
     col->ri = new_rowindex;
     col->nrows = new_rowindex.length();
-  } else if (ri) {
-    col->ri = ri;
+  } else {
+    if (ri) col->ri = ri;
+    // The copy has the same values, so the HyperLogLog sketch remains valid
+    // (and can be merged later, if the copy is rbound to another column).
+    const HyperLogLog* hll = stats? stats->get_hll() : nullptr;
+    if (hll) {
+      col->get_stats()->set_hll(
+        std::unique_ptr<HyperLogLog>(new HyperLogLog(*hll)));
+    }
   }
   return col;
 }
@@ -203,11 +211,28 @@ Column* Column::rbind(std::vector<const Column*>& columns)
   }
   xassert(res->stype() == new_stype);
 
+  // The HyperLogLog sketches of the parts can be merged into the sketch of
+  // the result, provided that all the parts have them. The parts must also
+  // have the same stype, since the values are hashed differently when cast.
+  std::unique_ptr<HyperLogLog> hll;
+  if (!col_empty && stype() == new_stype && stats && stats->get_hll()) {
+    hll.reset(new HyperLogLog(*stats->get_hll()));
+    for (const Column* col : columns) {
+      const HyperLogLog* colhll = col->stats? col->stats->get_hll() : nullptr;
+      if (!colhll || col->stype() != new_stype) {
+        hll.reset();
+        break;
+      }
+      hll->merge(*colhll);
+    }
+  }
+
   // TODO: Temporary Fix. To be resolved in #301
   if (res->stats != nullptr) res->stats->reset();
 
   // Use the appropriate strategy to continue appending the columns.
   res->rbind_impl(columns, new_nrows, col_empty);
+  if (hll) res->get_stats()->set_hll(std::move(hll));
 
   // If everything is fine, then the current column can be safely discarded
   // -- the upstream caller will replace this column with the `res`.
@@ -216,9 +241,16 @@ Column* Column::rbind(std::vector<const Column*>& columns)
 }
 
 
+Column* Column::reified() {
+  reify();
+  return this;
+}
+
+
 void Column::replace_rowindex(const RowIndex& newri) {
   ri = newri;
   nrows = ri.length();
+  if (stats != nullptr) stats->reset();
 }
 
 
@@ -251,8 +283,16 @@ size_t Column::memory_footprint() const
 
 int64_t Column::countna() const { return get_stats()->countna(this); }
 int64_t Column::nunique() const { return get_stats()->nunique(this); }
+int64_t Column::nunique_approx() const {
+  return get_stats()->nunique_approx(this);
+}
 int64_t Column::nmodal() const  { return get_stats()->nmodal(this); }
 
+double Column::quantile(double q, bool approx) const {
+  Stats* s = get_stats();
+  return s? s->quantile(this, q, approx) : GETNA<double>();
+}
+
 
 /**
  * Methods for retrieving stats but in column form. These should be populated
@@ -277,6 +317,18 @@ Column* Column::nunique_column() const {
   return col;
 }
 
+Column* Column::nunique_approx_column() const {
+  IntColumn<int64_t>* col = new IntColumn<int64_t>(1);
+  col->set_elem(0, nunique_approx());
+  return col;
+}
+
+Column* Column::quantile_column(double q, bool approx) const {
+  RealColumn<double>* col = new RealColumn<double>(1);
+  col->set_elem(0, quantile(q, approx));
+  return col;
+}
+
 Column* Column::nmodal_column() const {
   IntColumn<int64_t>* col = new IntColumn<int64_t>(1);
   col->set_elem(0, nmodal());
@@ -292,6 +344,12 @@ PyObject* Column::sum_pyscalar() const { return none(); }
 PyObject* Column::countna_pyscalar() const { return int_to_py(countna()); }
 PyObject* Column::nunique_pyscalar() const { return int_to_py(nunique()); }
 PyObject* Column::nmodal_pyscalar() const { return int_to_py(nmodal()); }
+PyObject* Column::quantile_pyscalar(double q, bool approx) const {
+  return float_to_py(quantile(q, approx));
+}
+PyObject* Column::nunique_approx_pyscalar() const {
+  return int_to_py(nunique_approx());
+}
 
 
 
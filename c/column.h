@@ -107,6 +107,7 @@ public:
   MemoryBuffer* mbuf_shallowcopy() const;
   size_t memory_footprint() const;
   RowIndex sort(bool make_groups) const;
+  RowIndex topk(size_t k, bool descending, bool make_groups) const;
 
   /**
    * Resize the column up to `nrows` elements, and fill all new elements with
@@ -185,10 +186,25 @@ public:
    */
   virtual void reify() = 0;
 
+  /**
+   * Same as `reify()`, except that the column may be converted into a wider
+   * stype if its materialized data does not fit into the current one: a str32
+   * column whose rowindex repeats rows may need more than 2GB for its strings,
+   * in which case `reify()` throws an error, while `reified()` produces a
+   * str64 column. Similar to `rbind()`, the current column is modified
+   * in-place if possible; otherwise a new Column object is returned, and this
+   * Column is deleted:
+   *
+   *   column = column->reified();
+   */
+  virtual Column* reified();
+
   virtual void save_to_disk(const std::string&, WritableBuffer::Strategy);
 
   int64_t countna() const;
   int64_t nunique() const;
+  int64_t nunique_approx() const;
+  double quantile(double q, bool approx) const;
   int64_t nmodal() const;
   virtual int64_t min_int64() const { return GETNA<int64_t>(); }
   virtual int64_t max_int64() const { return GETNA<int64_t>(); }
@@ -210,6 +226,8 @@ public:
   virtual Column* sd_column() const;
   virtual Column* countna_column() const;
   virtual Column* nunique_column() const;
+  virtual Column* nunique_approx_column() const;
+  Column* quantile_column(double q, bool approx) const;
   virtual Column* nmodal_column() const;
   virtual Column* mode_column() const;
 
@@ -220,6 +238,8 @@ public:
   virtual PyObject* sd_pyscalar() const;
   virtual PyObject* countna_pyscalar() const;
   virtual PyObject* nunique_pyscalar() const;
+  virtual PyObject* nunique_approx_pyscalar() const;
+  PyObject* quantile_pyscalar(double q, bool approx) const;
   virtual PyObject* nmodal_pyscalar() const;
   virtual PyObject* mode_pyscalar() const;
 
@@ -373,8 +393,8 @@ protected:
   void cast_into(RealColumn<float>*) const override;
   void cast_into(RealColumn<double>*) const override;
   void cast_into(PyObjectColumn*) const override;
-  // void cast_into(StringColumn<int32_t>*) const;
-  // void cast_into(StringColumn<int64_t>*) const;
+  void cast_into(StringColumn<int32_t>*) const override;
+  void cast_into(StringColumn<int64_t>*) const override;
 
   bool verify_integrity(IntegrityCheckContext&,
                         const std::string& name = "Column") const override;
@@ -428,8 +448,8 @@ protected:
   void cast_into(RealColumn<float>*) const override;
   void cast_into(RealColumn<double>*) const override;
   void cast_into(PyObjectColumn*) const override;
-  // void cast_into(StringColumn<int32_t>*) const;
-  // void cast_into(StringColumn<int64_t>*) const;
+  void cast_into(StringColumn<int32_t>*) const override;
+  void cast_into(StringColumn<int64_t>*) const override;
 
   using Column::stats;
   using Column::mbuf;
@@ -489,8 +509,8 @@ protected:
   void cast_into(RealColumn<float>*) const override;
   void cast_into(RealColumn<double>*) const override;
   void cast_into(PyObjectColumn*) const override;
-  // void cast_into(StringColumn<int32_t>*) const;
-  // void cast_into(StringColumn<int64_t>*) const;
+  void cast_into(StringColumn<int32_t>*) const override;
+  void cast_into(StringColumn<int64_t>*) const override;
 
   using Column::stats;
   using Column::new_data_column;
@@ -580,6 +600,7 @@ public:
   bool is_fixedwidth() const override;
 
   void reify() override;
+  Column* reified() override;
   void resize_and_fill(int64_t nrows) override;
   void apply_na_mask(const BoolColumn* mask) override;
 
@@ -588,6 +609,9 @@ public:
   static size_t padding(size_t datasize);
   char* strdata() const;
   T* offsets() const;
+  // Replace the content of this column with the string representations of
+  // the values of a (non-view) boolean, integer or real column `col`.
+  void fill_from_numeric(const Column* col);
 
   CString mode() const;
   PyObject* mode_pyscalar() const override;
@@ -610,14 +634,15 @@ protected:
                   bool isempty) override;
 
   StringStats<T>* get_stats() const override;
+  Column* reify_impl(bool upcast);
 
-  // void cast_into(BoolColumn*) const override;
-  // void cast_into(IntColumn<int8_t>*) const override;
-  // void cast_into(IntColumn<int16_t>*) const override;
-  // void cast_into(IntColumn<int32_t>*) const override;
-  // void cast_into(IntColumn<int64_t>*) const override;
-  // void cast_into(RealColumn<float>*) const override;
-  // void cast_into(RealColumn<double>*) const override;
+  void cast_into(BoolColumn*) const override;
+  void cast_into(IntColumn<int8_t>*) const override;
+  void cast_into(IntColumn<int16_t>*) const override;
+  void cast_into(IntColumn<int32_t>*) const override;
+  void cast_into(IntColumn<int64_t>*) const override;
+  void cast_into(RealColumn<float>*) const override;
+  void cast_into(RealColumn<double>*) const override;
   void cast_into(PyObjectColumn*) const override;
   // void cast_into(StringColumn<int32_t>*) const;
   // void cast_into(StringColumn<int64_t>*) const;
@@ -140,6 +140,14 @@ void BoolColumn::cast_into(PyObjectColumn* target) const {
   }
 }
 
+void BoolColumn::cast_into(StringColumn<int32_t>* target) const {
+  target->fill_from_numeric(this);
+}
+
+void BoolColumn::cast_into(StringColumn<int64_t>* target) const {
+  target->fill_from_numeric(this);
+}
+
 
 
 //------------------------------------------------------------------------------
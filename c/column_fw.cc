@@ -149,20 +149,14 @@ void FwColumn<T>::reify() {
     memmove(new_mbuf->get(), elements() + start, newsize);
 
   } else {
-    // In all other cases we have to manually loop over the rowindex and
-    // copy array elements onto the new positions. This can be done in-place
-    // only if we know that the indices are monotonically increasing (otherwise
-    // there is a risk of scrambling the data).
-    if (mbuf == new_mbuf && !(ri.isslice() && ri.slice_step() > 0)) {
+    // In all other cases the elements are gathered in parallel into a new
+    // buffer. (Gathering in-place would be possible for slices with positive
+    // step, but not in parallel: a chunk of rows could then overwrite the
+    // data that another chunk has not read yet.)
+    if (mbuf == new_mbuf) {
       new_mbuf = new MemoryMemBuf(newsize);
     }
-    T* data_src = elements();
-    T* data_dest = static_cast<T*>(new_mbuf->get());
-    ri.strided_loop(0, nrows, 1,
-      [&](int64_t i) {
-        *data_dest = data_src[i];
-        ++data_dest;
-      });
+    ri.gather(elements(), static_cast<T*>(new_mbuf->get()));
   }
 
   if (mbuf == new_mbuf) {
@@ -172,6 +166,8 @@ void FwColumn<T>::reify() {
     mbuf = new_mbuf;
   }
   ri.clear(true);
+  // The cached ordering refers to the rows of the old data buffer
+  if (stats != nullptr) stats->reset_ordering();
 }
 
 
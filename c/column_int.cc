@@ -185,6 +185,16 @@ void IntColumn<T>::cast_into(PyObjectColumn* target) const {
   }
 }
 
+template <typename T>
+void IntColumn<T>::cast_into(StringColumn<int32_t>* target) const {
+  target->fill_from_numeric(this);
+}
+
+template <typename T>
+void IntColumn<T>::cast_into(StringColumn<int64_t>* target) const {
+  target->fill_from_numeric(this);
+}
+
 template <>
 void IntColumn<int8_t>::cast_into(IntColumn<int8_t>* target) const {
   memcpy(target->data(), this->data(), alloc_size());
@@ -184,6 +184,16 @@ void RealColumn<T>::cast_into(PyObjectColumn* target) const {
   }
 }
 
+template <typename T>
+void RealColumn<T>::cast_into(StringColumn<int32_t>* target) const {
+  target->fill_from_numeric(this);
+}
+
+template <typename T>
+void RealColumn<T>::cast_into(StringColumn<int64_t>* target) const {
+  target->fill_from_numeric(this);
+}
+
 
 
 
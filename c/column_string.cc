@@ -6,13 +6,24 @@
 // © H2O.ai 2018
 //------------------------------------------------------------------------------
 #include "column.h"
+#include <algorithm> // std::min, std::max
 #include <cmath>  // abs
+#include <cstdlib> // std::strtod
+#include <clocale> // std::localeconv
+#include <cstring> // std::memcpy
 #include <limits> // numeric_limits::max()
+#include <string> // std::string
+#include <vector> // std::vector
 #include "py_utils.h"
 #include "utils.h"
+#include "csv/dtoa.h"
+#include "csv/fread.h"
+#include "csv/itoa.h"
+#include "csv/reader_parsers.h"
 #include "datatable_check.h"
 #include "encodings.h"
 #include "utils/assert.h"
+#include "utils/omp.h"
 
 // Returns the expected path of the string data file given
 // the path to the offsets
@@ -228,10 +239,136 @@ T* StringColumn<T>::offsets() const {
 }
 
 
+// Second pass of `gather_strings()`: write the offsets of type `U` (for the
+// chunks starting at `starts`), and copy the characters.
+template <typename T, typename U, typename F>
+static void gather_strings_into(const T* offs1, const char* strs_src,
+                                size_t n, const std::vector<size_t>& starts,
+                                U* offs_dest, char* strs_dest, F row)
+{
+  const T* offs0 = offs1 - 1;
+  size_t nchunks = starts.size() - 1;
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < nchunks; ++c) {
+    size_t i0 = c * n / nchunks;
+    size_t i1 = (c + 1) * n / nchunks;
+    char* dest = strs_dest + starts[c];
+    U off = static_cast<U>(starts[c]) + 1;
+    for (size_t i = i0; i < i1; ++i) {
+      int64_t j = row(i);
+      if (offs1[j] > 0) {
+        T start = std::abs(offs0[j]);
+        T len = offs1[j] - start;
+        if (len) {
+          std::memcpy(dest, strs_src + start, static_cast<size_t>(len));
+          dest += len;
+          off += static_cast<U>(len);
+        }
+        offs_dest[i] = off;
+      } else {
+        offs_dest[i] = -off;
+      }
+    }
+  }
+}
+
+
+/**
+ * Gather the strings at rows `row(i)` (for `i < n`) of a string column with
+ * offsets `offs1` and character data `strs_src` (as returned by `offsets()`
+ * and `strdata()`), into the new offsets buffer `*offbuf` and the new
+ * character data buffer `*strbuf`.
+ *
+ * The rows are split into chunks, and the work is done in two parallel
+ * passes over these chunks. The first pass computes the total size of the
+ * strings in each chunk. After the prefix sum of the chunk sizes, the total
+ * size of the result is known before anything is written: if it does not fit
+ * into the offsets of type `T` (which may happen for a str32 column when the
+ * RowIndex repeats rows), then the offsets are written as int64_t if `upcast`
+ * is true, and an error is thrown otherwise. The second pass writes the
+ * offsets, and copies the characters.
+ *
+ * Returns true if the offsets were written as int64_t instead of `T`.
+ */
+template <typename T, typename F>
+static bool gather_strings(const T* offs1, const char* strs_src, size_t n,
+                           F row, bool upcast, MemoryBuffer** offbuf,
+                           MemoryBuffer** strbuf)
+{
+  constexpr size_t PREFETCH = 16;
+  const T* offs0 = offs1 - 1;
+  size_t nth = static_cast<size_t>(omp_get_max_threads());
+  size_t nchunks = std::max(std::min(n / 1000, 4 * nth), size_t(1));
+  std::vector<size_t> starts(nchunks + 1, 0);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < nchunks; ++c) {
+    size_t i0 = c * n / nchunks;
+    size_t i1 = (c + 1) * n / nchunks;
+    size_t size = 0;
+    for (size_t i = i0; i < i1; ++i) {
+      if (i + PREFETCH < i1) __builtin_prefetch(offs1 + row(i + PREFETCH));
+      int64_t j = row(i);
+      if (offs1[j] > 0) {
+        size += static_cast<size_t>(offs1[j] - std::abs(offs0[j]));
+      }
+    }
+    starts[c + 1] = size;
+  }
+  for (size_t c = 0; c < nchunks; ++c) {
+    starts[c + 1] += starts[c];
+  }
+
+  size_t strs_size = starts[nchunks];
+  bool wide = strs_size >= static_cast<size_t>(std::numeric_limits<T>::max());
+  if (wide && !upcast) {
+    throw ValueError() << "Cannot materialize a str32 column with "
+                       << strs_size << " bytes of string data";
+  }
+  size_t elemsize = wide? sizeof(int64_t) : sizeof(T);
+  *offbuf = new MemoryMemBuf((n + 1) * elemsize);
+  *strbuf = new MemoryMemBuf(strs_size);
+  char* strs_dest = static_cast<char*>((*strbuf)->get());
+  if (wide) {
+    int64_t* offs_dest = static_cast<int64_t*>((*offbuf)->get());
+    offs_dest[0] = -1;
+    gather_strings_into(offs1, strs_src, n, starts, offs_dest + 1, strs_dest,
+                        row);
+  } else {
+    T* offs_dest = static_cast<T*>((*offbuf)->get());
+    offs_dest[0] = -1;
+    gather_strings_into(offs1, strs_src, n, starts, offs_dest + 1, strs_dest,
+                        row);
+  }
+  return wide;
+}
+
+
 template <typename T>
 void StringColumn<T>::reify() {
+  Column* res = reify_impl(false);
+  xassert(res == this);
+  (void) res;
+}
+
+
+template <typename T>
+Column* StringColumn<T>::reified() {
+  Column* res = reify_impl(true);
+  if (res != this) delete this;
+  return res;
+}
+
+
+/**
+ * Materialize the column, see `reify()` / `reified()`. Returns either this
+ * column, or (only if `upcast` is true) a new str64 column with the gathered
+ * data, in which case this column is left unmodified.
+ */
+template <typename T>
+Column* StringColumn<T>::reify_impl(bool upcast) {
   // If our rowindex is null, then we're already done
-  if (ri.isabsent()) return;
+  if (ri.isabsent()) return this;
 
   //size_t new_offoff = static_cast<size_t>(offoff);
   size_t new_mbuf_size = (ri.zlength() + 1) * sizeof(T);
@@ -257,85 +394,42 @@ void StringColumn<T>::reify() {
     data_dest[0] = -1;
     data_dest += 1;
     --off0;
+    // When the offsets are shifted in-place, the loop must be sequential
+    #pragma omp parallel for schedule(static) if(new_mbuf != mbuf)
     for (int64_t i = 0; i < nrows; ++i) {
       data_dest[i] = data_src[i] > 0 ? data_src[i] - off0 : data_src[i] + off0;
     }
-  } else if (ri.isslice() && ri.slice_step() > 0) {
-    // Special case: We can still do this in-place
-    // (assuming the buffers are not read-only)
-    if (mbuf->is_readonly())
-      new_mbuf = new MemoryMemBuf(new_mbuf_size);
-    if (strbuf->is_readonly())
-      new_strbuf = new MemoryMemBuf(strbuf->size()); // We don't know the actual size yet
-                                                     // but it can't be larger than this
-    T step = static_cast<T>(ri.slice_step());
-    T start = static_cast<T>(ri.slice_start());
-    T* offs1 = offsets();
-    T* offs0 = offs1 - 1;
-    T* off_dest = static_cast<T*>(new_mbuf->get());
-    char* str_src = strdata();
-    char* str_dest = static_cast<char*>(new_strbuf->get());
-    // We know that the resulting strbuf/mbuf size will be smaller, so no need to
-    // worry about resizing beforehand
-    *off_dest = -1;
-    ++off_dest;
-    T prev_off = 1;
-    for (T i = 0, j = start; i < nrows; ++i, j += step) {
-      if (offs1[j] > 0) {
-        T off0 = abs(offs0[j]);
-        T str_len = offs1[j] - off0;
-        if (str_len != 0) {
-          memmove(str_dest, str_src + off0, static_cast<size_t>(str_len));
-          str_dest += str_len;
-        }
-        prev_off += str_len;
-        off_dest[i] = prev_off;
-      } else {
-        off_dest[i] = -prev_off;
-      }
-    }
-    new_strbuf_size = static_cast<size_t>(
-        str_dest - static_cast<char*>(new_strbuf->get()));
-    // Note: We can also do a special case with slice.step = 0, but we have to
-    //       be careful about cases where nrows > T_MAX
   } else {
-    // We have to make a copy otherwise :(
-    new_mbuf = new MemoryMemBuf(new_mbuf_size);
-
-    T* offs1 = offsets();
-    T* offs0 = offs1 - 1;
-    T strs_size = 0;
-    ri.strided_loop(0, nrows, 1,
-      [&](int64_t i) {
-        if (offs1[i] > 0) {
-          strs_size += offs1[i] - abs(offs0[i]);
-        }
-      });
-    new_strbuf_size = static_cast<size_t>(strs_size);
-    new_strbuf = new MemoryMemBuf(new_strbuf_size);
-    T* offs_dest = static_cast<T*>(new_mbuf->get());
-    offs_dest[0] = -1;
-    ++offs_dest;
-    char *strs_src = strdata();
-    char *strs_dest = static_cast<char*>(new_strbuf->get());
-    T prev_off = 1;
-    ri.strided_loop(0, nrows, 1,
-      [&](int64_t i) {
-        if (offs1[i] > 0) {
-          T off0 = abs(offs0[i]);
-          T str_len = offs1[i] - off0;
-          if (str_len != 0) {
-            memcpy(strs_dest, strs_src + off0, static_cast<size_t>(str_len));
-            strs_dest += str_len;
-            prev_off += str_len;
-          }
-          *offs_dest = prev_off;
-          ++offs_dest;
-        } else {
-          *offs_dest = -prev_off;
-          ++offs_dest;
-        }
-      });
+    // General case: gather the strings in parallel into new buffers
+    const T* offs1 = offsets();
+    const char* strs_src = strdata();
+    size_t n = ri.zlength();
+    bool wide;
+    if (ri.isarr32()) {
+      const int32_t* indices = ri.indices32();
+      wide = gather_strings(offs1, strs_src, n,
+          [=](size_t i) { return static_cast<int64_t>(indices[i]); },
+          upcast, &new_mbuf, &new_strbuf);
+    } else if (ri.isarr64()) {
+      const int64_t* indices = ri.indices64();
+      wide = gather_strings(offs1, strs_src, n,
+          [=](size_t i) { return indices[i]; },
+          upcast, &new_mbuf, &new_strbuf);
+    } else {
+      int64_t start = ri.slice_start();
+      int64_t step = ri.slice_step();
+      wide = gather_strings(offs1, strs_src, n,
+          [=](size_t i) { return start + static_cast<int64_t>(i) * step; },
+          upcast, &new_mbuf, &new_strbuf);
+    }
+    if (wide) {
+      Column* res = new StringColumn<int64_t>(nrows, new_mbuf, new_strbuf);
+      RowIndex groups = ri;
+      groups.clear(true);
+      if (groups) res->replace_rowindex(groups);
+      return res;
+    }
+    new_strbuf_size = new_strbuf->size();
   }
   if (new_mbuf == mbuf) {
     mbuf->resize(new_mbuf_size);
@@ -350,6 +444,9 @@ void StringColumn<T>::reify() {
     strbuf = new_strbuf;
   }
   ri.clear(true);
+  // The cached ordering refers to the rows of the old data buffer
+  if (stats != nullptr) stats->reset_ordering();
+  return this;
 }
 
 
@@ -604,6 +701,292 @@ void StringColumn<T>::cast_into(PyObjectColumn* target) const {
 }
 
 
+/**
+ * Parse each string in the column with the function `parse`, and store the
+ * results into `trg`. The strings that cannot be parsed as a whole become NAs.
+ *
+ * The fread parsers expect the input to be terminated by a character that
+ * cannot continue the value, so each string is first copied into a thread-
+ * local NUL-terminated buffer. The parser accepts a string iff it consumes
+ * all of it.
+ */
+template <typename T, typename OT>
+static void parse_strings(const char* strdata, const T* offsets, int64_t n,
+                          OT* trg, OT (*parse)(FreadTokenizer&))
+{
+  constexpr OT na = GETNA<OT>();
+  #pragma omp parallel
+  {
+    std::vector<char> buf(64);
+    field64 value;
+    FreadTokenizer ctx;
+    ctx.target = &value;
+    ctx.dec = '.';
+    ctx.quote = '"';
+
+    #pragma omp for schedule(static)
+    for (int64_t i = 0; i < n; ++i) {
+      T off = offsets[i];
+      T start = std::abs(offsets[i - 1]);
+      if (off <= start) {  // NA or empty string
+        trg[i] = na;
+        continue;
+      }
+      size_t len = static_cast<size_t>(off - start);
+      if (len >= buf.size()) buf.resize(len * 2);
+      std::memcpy(buf.data(), strdata + start, len);
+      buf[len] = '\0';
+      ctx.ch = buf.data();
+      ctx.eof = buf.data() + len;
+      OT x = parse(ctx);
+      trg[i] = ctx.ch == ctx.eof? x : na;
+    }
+  }
+}
+
+static int8_t parse_as_bool(FreadTokenizer& ctx) {
+  static const ParserFnPtr parsers[] = {
+    parse_bool8_numeric, parse_bool8_titlecase, parse_bool8_lowercase,
+    parse_bool8_uppercase
+  };
+  const char* ch = ctx.ch;
+  for (ParserFnPtr parser : parsers) {
+    ctx.ch = ch;
+    parser(ctx);
+    if (ctx.ch == ctx.eof) break;
+  }
+  return ctx.target->int8;
+}
+
+template <typename OT>
+static OT parse_as_small_int(FreadTokenizer& ctx) {
+  parse_int32_simple(ctx);
+  int32_t x = ctx.target->int32;
+  bool fits = x > std::numeric_limits<OT>::min() &&
+              x <= std::numeric_limits<OT>::max();
+  return fits? static_cast<OT>(x) : GETNA<OT>();
+}
+
+static int32_t parse_as_int32(FreadTokenizer& ctx) {
+  parse_int32_simple(ctx);
+  return ctx.target->int32;
+}
+
+static int64_t parse_as_int64(FreadTokenizer& ctx) {
+  parse_int64_simple(ctx);
+  return ctx.target->int64;
+}
+
+// Check whether `[ch; end)` is a decimal number in the same format as the one
+// accepted by fread's float parser: an optional sign, digits with an optional
+// decimal point (at least one digit in total), and an optional exponent.
+static bool is_decimal_number(const char* ch, const char* end) {
+  if (ch < end && (*ch == '-' || *ch == '+')) ch++;
+  int ndigits = 0;
+  for (; ch < end && *ch >= '0' && *ch <= '9'; ++ch) ndigits++;
+  if (ch < end && *ch == '.') {
+    for (++ch; ch < end && *ch >= '0' && *ch <= '9'; ++ch) ndigits++;
+  }
+  if (!ndigits) return false;
+  if (ch < end && (*ch == 'e' || *ch == 'E')) {
+    ch++;
+    if (ch < end && (*ch == '-' || *ch == '+')) ch++;
+    if (ch == end || *ch < '0' || *ch > '9') return false;
+    while (ch < end && *ch >= '0' && *ch <= '9') ch++;
+  }
+  return ch == end;
+}
+
+// The fread parser gives up on some valid numbers (too many significant
+// digits, or an exponent out of range): such strings are re-parsed with the
+// full-precision `strtod()`. Only the decimal numbers are re-parsed, so that
+// the hexadecimal numbers, leading whitespace, etc. that `strtod()` accepts
+// still become NAs (as they do in the casts into integers). Since `strtod()`
+// expects the decimal point of the current locale, the '.' is replaced with
+// that decimal point first.
+static double parse_as_float64(FreadTokenizer& ctx) {
+  const char* ch = ctx.ch;
+  parse_float64_extended(ctx);
+  if (ctx.ch != ctx.eof && is_decimal_number(ch, ctx.eof)) {
+    std::string num(ch, ctx.eof);
+    const char* dp = std::localeconv()->decimal_point;
+    if (!(dp[0] == '.' && dp[1] == '\0')) {
+      size_t pos = num.find('.');
+      if (pos != std::string::npos) num.replace(pos, 1, dp);
+    }
+    char* end;
+    double x = std::strtod(num.c_str(), &end);
+    if (end == num.c_str() + num.size()) {
+      ctx.ch = ctx.eof;
+      return x;
+    }
+  }
+  return ctx.target->float64;
+}
+
+static float parse_as_float32(FreadTokenizer& ctx) {
+  return static_cast<float>(parse_as_float64(ctx));
+}
+
+template <typename T>
+void StringColumn<T>::cast_into(BoolColumn* target) const {
+  parse_strings(strdata(), offsets(), nrows, target->elements(),
+                parse_as_bool);
+}
+
+template <typename T>
+void StringColumn<T>::cast_into(IntColumn<int8_t>* target) const {
+  parse_strings(strdata(), offsets(), nrows, target->elements(),
+                parse_as_small_int<int8_t>);
+}
+
+template <typename T>
+void StringColumn<T>::cast_into(IntColumn<int16_t>* target) const {
+  parse_strings(strdata(), offsets(), nrows, target->elements(),
+                parse_as_small_int<int16_t>);
+}
+
+template <typename T>
+void StringColumn<T>::cast_into(IntColumn<int32_t>* target) const {
+  parse_strings(strdata(), offsets(), nrows, target->elements(),
+                parse_as_int32);
+}
+
+template <typename T>
+void StringColumn<T>::cast_into(IntColumn<int64_t>* target) const {
+  parse_strings(strdata(), offsets(), nrows, target->elements(),
+                parse_as_int64);
+}
+
+template <typename T>
+void StringColumn<T>::cast_into(RealColumn<float>* target) const {
+  parse_strings(strdata(), offsets(), nrows, target->elements(),
+                parse_as_float32);
+}
+
+template <typename T>
+void StringColumn<T>::cast_into(RealColumn<double>* target) const {
+  parse_strings(strdata(), offsets(), nrows, target->elements(),
+                parse_as_float64);
+}
+
+
+
+/**
+ * Write each element of `src` (an array of `n` values of type `IT`) with the
+ * function `write`, producing the string data and the offsets `offs` of a
+ * string column. NA values become NA strings. No value may produce more than
+ * `maxlen` characters.
+ *
+ * The rows are split into chunks, each chunk is written in parallel into its
+ * own buffer, with the offsets relative to the chunk's start. After the prefix
+ * sum of the chunk sizes, the buffers are copied into the resulting string
+ * buffer, and the offsets are shifted by the chunk's start (also in parallel).
+ */
+template <typename T, typename IT>
+static MemoryBuffer* format_values(const void* src_data, size_t n, T* offs,
+                                   size_t maxlen, void (*write)(char**, IT))
+{
+  const IT* src = static_cast<const IT*>(src_data);
+  size_t nth = static_cast<size_t>(omp_get_max_threads());
+  size_t nchunks = std::max(std::min(n / 1000, 4 * nth), size_t(1));
+  std::vector<std::vector<char>> chunk_strs(nchunks);
+  std::vector<size_t> chunk_starts(nchunks + 1);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < nchunks; ++c) {
+    size_t i0 = c * n / nchunks;
+    size_t i1 = (c + 1) * n / nchunks;
+    std::vector<char>& buf = chunk_strs[c];
+    buf.resize(std::max((i1 - i0) * 8, maxlen));
+    size_t pos = 0;
+    for (size_t i = i0; i < i1; ++i) {
+      IT x = src[i];
+      if (ISNA<IT>(x)) {
+        offs[i] = -static_cast<T>(pos + 1);
+        continue;
+      }
+      if (buf.size() - pos < maxlen) buf.resize(buf.size() * 2);
+      char* ch0 = buf.data() + pos;
+      char* ch = ch0;
+      write(&ch, x);
+      pos += static_cast<size_t>(ch - ch0);
+      offs[i] = static_cast<T>(pos + 1);
+    }
+    chunk_starts[c + 1] = pos;
+  }
+  for (size_t c = 0; c < nchunks; ++c) {
+    chunk_starts[c + 1] += chunk_starts[c];
+  }
+
+  size_t strs_size = chunk_starts[nchunks];
+  if (strs_size >= static_cast<size_t>(std::numeric_limits<T>::max())) {
+    throw ValueError() << "Total size of the strings in the column is too "
+                          "large for the str32 stype";
+  }
+  MemoryBuffer* strbuf = new MemoryMemBuf(strs_size);
+  char* strs_dest = static_cast<char*>(strbuf->get());
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < nchunks; ++c) {
+    size_t i0 = c * n / nchunks;
+    size_t i1 = (c + 1) * n / nchunks;
+    T base = static_cast<T>(chunk_starts[c]);
+    size_t size = chunk_starts[c + 1] - chunk_starts[c];
+    if (size) std::memcpy(strs_dest + base, chunk_strs[c].data(), size);
+    for (size_t i = i0; i < i1; ++i) {
+      offs[i] += offs[i] > 0? base : -base;
+    }
+    std::vector<char>().swap(chunk_strs[c]);
+  }
+  return strbuf;
+}
+
+static void write_bool(char** pch, int8_t x) {
+  if (x) {
+    std::memcpy(*pch, "True", 4);
+    *pch += 4;
+  } else {
+    std::memcpy(*pch, "False", 5);
+    *pch += 5;
+  }
+}
+static void write_i1(char** pch, int8_t x)  { itoa(pch, x); }
+static void write_i2(char** pch, int16_t x) { itoa(pch, x); }
+static void write_i4(char** pch, int32_t x) { itoa(pch, x); }
+static void write_i8(char** pch, int64_t x) { ltoa(pch, x); }
+static void write_f4(char** pch, float x)   { ftoa(pch, x); }
+static void write_f8(char** pch, double x)  { dtoa(pch, x); }
+
+template <typename T>
+void StringColumn<T>::fill_from_numeric(const Column* col) {
+  xassert(!ri && !col->rowindex());
+  size_t n = static_cast<size_t>(col->nrows);
+  MemoryBuffer* new_mbuf = new MemoryMemBuf((n + 1) * sizeof(T));
+  T* offs = static_cast<T*>(new_mbuf->get()) + 1;
+  offs[-1] = -1;
+  const void* src = col->data();
+  MemoryBuffer* new_strbuf = nullptr;
+  try {
+    switch (col->stype()) {
+      case ST_BOOLEAN_I1: new_strbuf = format_values(src, n, offs, 5, write_bool); break;
+      case ST_INTEGER_I1: new_strbuf = format_values(src, n, offs, 4, write_i1); break;
+      case ST_INTEGER_I2: new_strbuf = format_values(src, n, offs, 6, write_i2); break;
+      case ST_INTEGER_I4: new_strbuf = format_values(src, n, offs, 11, write_i4); break;
+      case ST_INTEGER_I8: new_strbuf = format_values(src, n, offs, 20, write_i8); break;
+      case ST_REAL_F4:    new_strbuf = format_values(src, n, offs, 16, write_f4); break;
+      case ST_REAL_F8:    new_strbuf = format_values(src, n, offs, 25, write_f8); break;
+      default:
+        throw ValueError() << "Cannot convert " << col->stype() << " into "
+                           << stype();
+    }
+  } catch (...) {
+    new_mbuf->release();
+    throw;
+  }
+  replace_buffer(new_mbuf, new_strbuf);
+}
+
+
 //------------------------------------------------------------------------------
 // Integrity checks
 //------------------------------------------------------------------------------
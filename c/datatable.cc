@@ -140,7 +140,7 @@ void DataTable::apply_na_mask(DataTable* maskdt)
 void DataTable::reify() {
   if (rowindex.isabsent()) return;
   for (int64_t i = 0; i < ncols; ++i) {
-    columns[i]->reify();
+    columns[i] = columns[i]->reified();
   }
   rowindex.clear(true);
 }
@@ -180,6 +180,17 @@ DataTable* DataTable::_statdt(colmakerfn f) const {
 
 DataTable* DataTable::countna_datatable() const { return _statdt(&Column::countna_column); }
 DataTable* DataTable::nunique_datatable() const { return _statdt(&Column::nunique_column); }
+DataTable* DataTable::nunique_approx_datatable() const {
+  return _statdt(&Column::nunique_approx_column);
+}
+DataTable* DataTable::quantile_datatable(double q, bool approx) const {
+  Column** out_cols = new Column*[ncols + 1];
+  for (int64_t i = 0; i < ncols; ++i) {
+    out_cols[i] = columns[i]->quantile_column(q, approx);
+  }
+  out_cols[ncols] = nullptr;
+  return new DataTable(out_cols);
+}
 DataTable* DataTable::nmodal_datatable() const  { return _statdt(&Column::nmodal_column); }
 DataTable* DataTable::mean_datatable() const    { return _statdt(&Column::mean_column); }
 DataTable* DataTable::sd_datatable() const      { return _statdt(&Column::sd_column); }
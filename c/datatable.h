@@ -71,13 +71,23 @@ class DataTable {
     /**
      * Sort the DataTable by specified columns, and return the corresponding
      * RowIndex. The array `colindices` provides the indices of columns to
-     * sort on. If an index is negative, it indicates that the column must be
-     * sorted in descending order instead of default ascending.
+     * sort on. If an index `i` is negative, it indicates that the column `~i`
+     * must be sorted in descending order instead of default ascending.
      *
      * If `make_groups` is true, then in addition to sorting, the grouping
-     * information will be computed and stored with the RowIndex.
+     * information will be computed and stored with the RowIndex. If `na_last`
+     * is true, then NA values are placed at the end instead of the beginning.
      */
-    RowIndex sortby(const arr32_t& colindices, bool make_groups) const;
+    RowIndex sortby(const arr32_t& colindices, bool make_groups,
+                    bool na_last = false) const;
+
+    /**
+     * Group the DataTable by the columns `colindices` using a hash table,
+     * and return a RowIndex where the rows of each group are contiguous,
+     * together with the groups information. Unlike `sortby()`, the groups
+     * are not ordered by their keys.
+     */
+    RowIndex hash_groupby(const arr32_t& colindices) const;
 
     DataTable* min_datatable() const;
     DataTable* max_datatable() const;
@@ -87,6 +97,8 @@ class DataTable {
     DataTable* sd_datatable() const;
     DataTable* countna_datatable() const;
     DataTable* nunique_datatable() const;
+    DataTable* nunique_approx_datatable() const;
+    DataTable* quantile_datatable(double q, bool approx) const;
     DataTable* nmodal_datatable() const;
 
     bool verify_integrity(IntegrityCheckContext& icc) const;
@@ -45,7 +45,7 @@ DataTable* DataTable::cbind(DataTable **dts, int ndts)
         int64_t nrowsi = dts[i]->nrows;
         for (int64_t ii = 0; ii < ncolsi; ++ii) {
             Column *c = dts[i]->columns[ii]->shallowcopy();
-            c->reify();
+            c = c->reified();
             if (nrowsi < t_nrows) c->resize_and_fill(t_nrows);
             columns[j++] = c;
         }
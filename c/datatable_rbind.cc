@@ -50,7 +50,7 @@ void DataTable::rbind(DataTable** dts, int** cols, int ndts, int64_t new_ncols)
       int k = cols[i][j];
       Column* col = k < 0 ? new VoidColumn(dts[j]->nrows)
                           : dts[j]->columns[k]->shallowcopy();
-      col->reify();
+      col = col->reified();
       cols_to_append[j] = col;
     }
     columns[i] = columns[i]->rbind(cols_to_append);
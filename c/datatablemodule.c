@@ -167,7 +167,11 @@ static PyMethodDef DatatableModuleMethods[] = {
     METHODv(expr_binaryop),
     METHODv(expr_cast),
     METHODv(expr_column),
+    METHODv(expr_fused),
+    METHODv(expr_fused_filter),
+    METHODv(expr_isin),
     METHODv(expr_reduceop),
+    METHODv(expr_reduceops),
     METHODv(expr_unaryop),
     METHOD0(is_debug_mode),
 
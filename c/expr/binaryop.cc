@@ -18,17 +18,31 @@
 // `x` and `y` (which could be different), on the `op`, and on the type of
 // column compatibility (n-to-n, n-to-1, or 1-to-n). We require that columns be
 // reified already (i.e. have no rowindices), otherwise it would have required
-// 16 (or 25) times more code...
+// 16 (or 25) times more code... Columns that do have a rowindex are instead
+// gathered chunk-by-chunk into small buffers by the fused evaluator (see
+// "expr/fused.cc"), before the mappers are applied.
 //
 // In order to help tame this explosion of possibilities, templates are used
 // heavily in this source file.
 //------------------------------------------------------------------------------
 #include "expr/py_expr.h"
 #include <cmath>               // std::fmod
-#include <type_traits>         // std::is_integral
+#include <cstring>             // std::memcpy
+#include <type_traits>         // std::is_integral, std::is_floating_point
+#include "options.h"
 #include "types.h"
 #include "utils/exceptions.h"
 
+// Vectorized kernels require the GCC/Clang vector extensions (including
+// `__builtin_convertvector`), and per-function target attributes for x86.
+// With Clang, these attributes are applied via `#pragma clang attribute`,
+// which is available since Clang 5.
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    ((defined(__clang__) && __clang_major__ >= 5) || \
+     (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 9))
+  #define DT_SIMD_KERNELS
+#endif
+
 
 namespace expr
 {
@@ -54,23 +68,15 @@ enum OpCode {
   LessOrEqual    = 17,  // <=
 };
 
-enum OpMode {
-  N_to_N = 1,
-  N_to_One = 2,
-  One_to_N = 3
-};
-
-
-
 //------------------------------------------------------------------------------
 // Final mapper functions
 //------------------------------------------------------------------------------
 
 template<typename LT, typename RT, typename VT, VT (*OP)(LT, RT)>
 static void map_n_to_n(int64_t row0, int64_t row1, void** params) {
-  LT* lhs_data = static_cast<LT*>(static_cast<Column*>(params[0])->data());
-  RT* rhs_data = static_cast<RT*>(static_cast<Column*>(params[1])->data());
-  VT* res_data = static_cast<VT*>(static_cast<Column*>(params[2])->data());
+  LT* lhs_data = static_cast<LT*>(params[0]);
+  RT* rhs_data = static_cast<RT*>(params[1]);
+  VT* res_data = static_cast<VT*>(params[2]);
   for (int64_t i = row0; i < row1; ++i) {
     res_data[i] = OP(lhs_data[i], rhs_data[i]);
   }
@@ -78,9 +84,9 @@ static void map_n_to_n(int64_t row0, int64_t row1, void** params) {
 
 template<typename LT, typename RT, typename VT, VT (*OP)(LT, RT)>
 static void map_n_to_1(int64_t row0, int64_t row1, void** params) {
-  LT* lhs_data = static_cast<LT*>(static_cast<Column*>(params[0])->data());
-  RT rhs_value = static_cast<RT*>(static_cast<Column*>(params[1])->data())[0];
-  VT* res_data = static_cast<VT*>(static_cast<Column*>(params[2])->data());
+  LT* lhs_data = static_cast<LT*>(params[0]);
+  RT rhs_value = static_cast<RT*>(params[1])[0];
+  VT* res_data = static_cast<VT*>(params[2]);
   for (int64_t i = row0; i < row1; ++i) {
     res_data[i] = OP(lhs_data[i], rhs_value);
   }
@@ -88,9 +94,9 @@ static void map_n_to_1(int64_t row0, int64_t row1, void** params) {
 
 template<typename LT, typename RT, typename VT, VT (*OP)(LT, RT)>
 static void map_1_to_n(int64_t row0, int64_t row1, void** params) {
-  LT lhs_value = static_cast<LT*>(static_cast<Column*>(params[0])->data())[0];
-  RT* rhs_data = static_cast<RT*>(static_cast<Column*>(params[1])->data());
-  VT* res_data = static_cast<VT*>(static_cast<Column*>(params[2])->data());
+  LT lhs_value = static_cast<LT*>(params[0])[0];
+  RT* rhs_data = static_cast<RT*>(params[1]);
+  VT* res_data = static_cast<VT*>(params[2]);
   for (int64_t i = row0; i < row1; ++i) {
     res_data[i] = OP(lhs_value, rhs_data[i]);
   }
@@ -196,6 +202,92 @@ inline static int8_t op_le(LT x, RT y) {  // x <= y
 
 
 
+//------------------------------------------------------------------------------
+// Vectorized mapper functions
+//------------------------------------------------------------------------------
+// When both operands have the same stype (int32, int64, float32 or float64)
+// and the mode is n-to-n, the arithmetic and relational operators are also
+// evaluated on whole vectors of elements at once. The same kernels (see
+// "expr/binaryop_simd.h") are compiled for several instruction sets (SSE4.2,
+// AVX2 and AVX-512), and the widest one that is supported by the CPU (and
+// allowed by the `simd` option) is selected at runtime.
+//------------------------------------------------------------------------------
+#ifdef DT_SIMD_KERNELS
+  #define SIMD_NS sse42
+  #define SIMD_TARGET "sse4.2"
+  #define SIMD_VS 16
+  #include "expr/binaryop_simd.h"
+  #define SIMD_NS avx2
+  #define SIMD_TARGET "avx2"
+  #define SIMD_VS 32
+  #include "expr/binaryop_simd.h"
+  #define SIMD_NS avx512
+  #define SIMD_TARGET "avx512f,avx512dq"
+  #define SIMD_VS 64
+  #include "expr/binaryop_simd.h"
+
+
+template <typename T, int OPCODE, T (*OP)(T, T)>
+static mapperfn vresolve_arith() {
+  switch (config::simd_level) {
+    case config::SIMD_AVX512: return avx512::vmap_arith<T, OPCODE, OP>;
+    case config::SIMD_AVX2:   return avx2::vmap_arith<T, OPCODE, OP>;
+    case config::SIMD_SSE42:  return sse42::vmap_arith<T, OPCODE, OP>;
+    default:                  return nullptr;
+  }
+}
+
+template <typename T, int OPCODE, int8_t (*OP)(T, T)>
+static mapperfn vresolve_cmp() {
+  switch (config::simd_level) {
+    case config::SIMD_AVX512: return avx512::vmap_cmp<T, OPCODE, OP>;
+    case config::SIMD_AVX2:   return avx2::vmap_cmp<T, OPCODE, OP>;
+    case config::SIMD_SSE42:  return sse42::vmap_cmp<T, OPCODE, OP>;
+    default:                  return nullptr;
+  }
+}
+
+#endif
+
+
+// Return the vectorized mapper function for the operator `opcode` applied to
+// two columns of types `LT` and `RT` in the n-to-n mode, or nullptr if there
+// is no such function (in which case the scalar mapper should be used).
+template <typename LT, typename RT, typename VT>
+struct SimdResolver {
+  static mapperfn resolve(int) { return nullptr; }
+};
+
+#ifdef DT_SIMD_KERNELS
+template <typename T>
+struct SimdResolverT {
+  static mapperfn resolve(int opcode) {
+    switch (opcode) {
+      case OpCode::Plus:     return vresolve_arith<T, OpCode::Plus, op_add<T, T, T>>();
+      case OpCode::Minus:    return vresolve_arith<T, OpCode::Minus, op_sub<T, T, T>>();
+      case OpCode::Multiply: return vresolve_arith<T, OpCode::Multiply, op_mul<T, T, T>>();
+      case OpCode::Divide:
+        if (std::is_integral<T>::value) return nullptr;
+        return vresolve_arith<T, OpCode::Divide, op_div<T, T, T>>();
+      case OpCode::Equal:          return vresolve_cmp<T, OpCode::Equal, op_eq<T, T, T>>();
+      case OpCode::NotEqual:       return vresolve_cmp<T, OpCode::NotEqual, op_ne<T, T, T>>();
+      case OpCode::Greater:        return vresolve_cmp<T, OpCode::Greater, op_gt<T, T, T>>();
+      case OpCode::Less:           return vresolve_cmp<T, OpCode::Less, op_lt<T, T, T>>();
+      case OpCode::GreaterOrEqual: return vresolve_cmp<T, OpCode::GreaterOrEqual, op_ge<T, T, T>>();
+      case OpCode::LessOrEqual:    return vresolve_cmp<T, OpCode::LessOrEqual, op_le<T, T, T>>();
+    }
+    return nullptr;
+  }
+};
+
+template <> struct SimdResolver<int32_t, int32_t, int32_t> : SimdResolverT<int32_t> {};
+template <> struct SimdResolver<int64_t, int64_t, int64_t> : SimdResolverT<int64_t> {};
+template <> struct SimdResolver<float, float, float> : SimdResolverT<float> {};
+template <> struct SimdResolver<double, double, double> : SimdResolverT<double> {};
+#endif
+
+
+
 //------------------------------------------------------------------------------
 // Resolve the right mapping function
 //------------------------------------------------------------------------------
@@ -211,14 +303,18 @@ static mapperfn resolve2(OpMode mode) {
 
 
 template<typename LT, typename RT, typename VT>
-static mapperfn resolve1(int opcode, SType stype, void** params, int64_t nrows, OpMode mode) {
+static mapperfn resolve1(int opcode, SType stype, OpMode mode, SType* res_type) {
   if (opcode >= OpCode::Equal) {
     // override stype for relational operators
     stype = ST_BOOLEAN_I1;
   } else if (opcode == OpCode::Divide && std::is_integral<VT>::value) {
     stype = ST_REAL_F8;
   }
-  params[2] = Column::new_data_column(stype, nrows);
+  *res_type = stype;
+  if (mode == OpMode::N_to_N) {
+    mapperfn simdfn = SimdResolver<LT, RT, VT>::resolve(opcode);
+    if (simdfn) return simdfn;
+  }
   switch (opcode) {
     case OpCode::Plus:      return resolve2<LT, RT, VT, op_add<LT, RT, VT>>(mode);
     case OpCode::Minus:     return resolve2<LT, RT, VT, op_sub<LT, RT, VT>>(mode);
@@ -243,18 +339,18 @@ static mapperfn resolve1(int opcode, SType stype, void** params, int64_t nrows,
 }
 
 
-static mapperfn resolve0(SType lhs_type, SType rhs_type, int opcode, void** params, int64_t nrows, OpMode mode) {
+static mapperfn resolve0(SType lhs_type, SType rhs_type, int opcode, OpMode mode, SType* res_type) {
   switch (lhs_type) {
     case ST_BOOLEAN_I1:
     case ST_INTEGER_I1:
       switch (rhs_type) {
         case ST_BOOLEAN_I1:
-        case ST_INTEGER_I1: return resolve1<int8_t, int8_t, int8_t>(opcode, ST_INTEGER_I1, params, nrows, mode);
-        case ST_INTEGER_I2: return resolve1<int8_t, int16_t, int16_t>(opcode, ST_INTEGER_I2, params, nrows, mode);
-        case ST_INTEGER_I4: return resolve1<int8_t, int32_t, int32_t>(opcode, ST_INTEGER_I4, params, nrows, mode);
-        case ST_INTEGER_I8: return resolve1<int8_t, int64_t, int64_t>(opcode, ST_INTEGER_I8, params, nrows, mode);
-        case ST_REAL_F4:    return resolve1<int8_t, float, float>(opcode, ST_REAL_F4, params, nrows, mode);
-        case ST_REAL_F8:    return resolve1<int8_t, double, double>(opcode, ST_REAL_F8, params, nrows, mode);
+        case ST_INTEGER_I1: return resolve1<int8_t, int8_t, int8_t>(opcode, ST_INTEGER_I1, mode, res_type);
+        case ST_INTEGER_I2: return resolve1<int8_t, int16_t, int16_t>(opcode, ST_INTEGER_I2, mode, res_type);
+        case ST_INTEGER_I4: return resolve1<int8_t, int32_t, int32_t>(opcode, ST_INTEGER_I4, mode, res_type);
+        case ST_INTEGER_I8: return resolve1<int8_t, int64_t, int64_t>(opcode, ST_INTEGER_I8, mode, res_type);
+        case ST_REAL_F4:    return resolve1<int8_t, float, float>(opcode, ST_REAL_F4, mode, res_type);
+        case ST_REAL_F8:    return resolve1<int8_t, double, double>(opcode, ST_REAL_F8, mode, res_type);
         default: break;
       }
       break;
@@ -262,12 +358,12 @@ static mapperfn resolve0(SType lhs_type, SType rhs_type, int opcode, void** para
     case ST_INTEGER_I2:
       switch (rhs_type) {
         case ST_BOOLEAN_I1:
-        case ST_INTEGER_I1: return resolve1<int16_t, int8_t, int16_t>(opcode, ST_INTEGER_I2, params, nrows, mode);
-        case ST_INTEGER_I2: return resolve1<int16_t, int16_t, int16_t>(opcode, ST_INTEGER_I2, params, nrows, mode);
-        case ST_INTEGER_I4: return resolve1<int16_t, int32_t, int32_t>(opcode, ST_INTEGER_I4, params, nrows, mode);
-        case ST_INTEGER_I8: return resolve1<int16_t, int64_t, int64_t>(opcode, ST_INTEGER_I8, params, nrows, mode);
-        case ST_REAL_F4:    return resolve1<int16_t, float, float>(opcode, ST_REAL_F4, params, nrows, mode);
-        case ST_REAL_F8:    return resolve1<int16_t, double, double>(opcode, ST_REAL_F8, params, nrows, mode);
+        case ST_INTEGER_I1: return resolve1<int16_t, int8_t, int16_t>(opcode, ST_INTEGER_I2, mode, res_type);
+        case ST_INTEGER_I2: return resolve1<int16_t, int16_t, int16_t>(opcode, ST_INTEGER_I2, mode, res_type);
+        case ST_INTEGER_I4: return resolve1<int16_t, int32_t, int32_t>(opcode, ST_INTEGER_I4, mode, res_type);
+        case ST_INTEGER_I8: return resolve1<int16_t, int64_t, int64_t>(opcode, ST_INTEGER_I8, mode, res_type);
+        case ST_REAL_F4:    return resolve1<int16_t, float, float>(opcode, ST_REAL_F4, mode, res_type);
+        case ST_REAL_F8:    return resolve1<int16_t, double, double>(opcode, ST_REAL_F8, mode, res_type);
         default: break;
       }
       break;
@@ -275,12 +371,12 @@ static mapperfn resolve0(SType lhs_type, SType rhs_type, int opcode, void** para
     case ST_INTEGER_I4:
       switch (rhs_type) {
         case ST_BOOLEAN_I1:
-        case ST_INTEGER_I1: return resolve1<int32_t, int8_t, int32_t>(opcode, ST_INTEGER_I4, params, nrows, mode);
-        case ST_INTEGER_I2: return resolve1<int32_t, int16_t, int32_t>(opcode, ST_INTEGER_I4, params, nrows, mode);
-        case ST_INTEGER_I4: return resolve1<int32_t, int32_t, int32_t>(opcode, ST_INTEGER_I4, params, nrows, mode);
-        case ST_INTEGER_I8: return resolve1<int32_t, int64_t, int64_t>(opcode, ST_INTEGER_I8, params, nrows, mode);
-        case ST_REAL_F4:    return resolve1<int32_t, float, float>(opcode, ST_REAL_F4, params, nrows, mode);
-        case ST_REAL_F8:    return resolve1<int32_t, double, double>(opcode, ST_REAL_F8, params, nrows, mode);
+        case ST_INTEGER_I1: return resolve1<int32_t, int8_t, int32_t>(opcode, ST_INTEGER_I4, mode, res_type);
+        case ST_INTEGER_I2: return resolve1<int32_t, int16_t, int32_t>(opcode, ST_INTEGER_I4, mode, res_type);
+        case ST_INTEGER_I4: return resolve1<int32_t, int32_t, int32_t>(opcode, ST_INTEGER_I4, mode, res_type);
+        case ST_INTEGER_I8: return resolve1<int32_t, int64_t, int64_t>(opcode, ST_INTEGER_I8, mode, res_type);
+        case ST_REAL_F4:    return resolve1<int32_t, float, float>(opcode, ST_REAL_F4, mode, res_type);
+        case ST_REAL_F8:    return resolve1<int32_t, double, double>(opcode, ST_REAL_F8, mode, res_type);
         default: break;
       }
       break;
@@ -288,12 +384,12 @@ static mapperfn resolve0(SType lhs_type, SType rhs_type, int opcode, void** para
     case ST_INTEGER_I8:
       switch (rhs_type) {
         case ST_BOOLEAN_I1:
-        case ST_INTEGER_I1: return resolve1<int64_t, int8_t, int64_t>(opcode, ST_INTEGER_I8, params, nrows, mode);
-        case ST_INTEGER_I2: return resolve1<int64_t, int16_t, int64_t>(opcode, ST_INTEGER_I8, params, nrows, mode);
-        case ST_INTEGER_I4: return resolve1<int64_t, int32_t, int64_t>(opcode, ST_INTEGER_I8, params, nrows, mode);
-        case ST_INTEGER_I8: return resolve1<int64_t, int64_t, int64_t>(opcode, ST_INTEGER_I8, params, nrows, mode);
-        case ST_REAL_F4:    return resolve1<int64_t, float, float>(opcode, ST_REAL_F4, params, nrows, mode);
-        case ST_REAL_F8:    return resolve1<int64_t, double, double>(opcode, ST_REAL_F8, params, nrows, mode);
+        case ST_INTEGER_I1: return resolve1<int64_t, int8_t, int64_t>(opcode, ST_INTEGER_I8, mode, res_type);
+        case ST_INTEGER_I2: return resolve1<int64_t, int16_t, int64_t>(opcode, ST_INTEGER_I8, mode, res_type);
+        case ST_INTEGER_I4: return resolve1<int64_t, int32_t, int64_t>(opcode, ST_INTEGER_I8, mode, res_type);
+        case ST_INTEGER_I8: return resolve1<int64_t, int64_t, int64_t>(opcode, ST_INTEGER_I8, mode, res_type);
+        case ST_REAL_F4:    return resolve1<int64_t, float, float>(opcode, ST_REAL_F4, mode, res_type);
+        case ST_REAL_F8:    return resolve1<int64_t, double, double>(opcode, ST_REAL_F8, mode, res_type);
         default: break;
       }
       break;
@@ -301,12 +397,12 @@ static mapperfn resolve0(SType lhs_type, SType rhs_type, int opcode, void** para
     case ST_REAL_F4:
       switch (rhs_type) {
         case ST_BOOLEAN_I1:
-        case ST_INTEGER_I1: return resolve1<float, int8_t, float>(opcode, ST_REAL_F4, params, nrows, mode);
-        case ST_INTEGER_I2: return resolve1<float, int16_t, float>(opcode, ST_REAL_F4, params, nrows, mode);
-        case ST_INTEGER_I4: return resolve1<float, int32_t, float>(opcode, ST_REAL_F4, params, nrows, mode);
-        case ST_INTEGER_I8: return resolve1<float, int64_t, float>(opcode, ST_REAL_F4, params, nrows, mode);
-        case ST_REAL_F4:    return resolve1<float, float, float>(opcode, ST_REAL_F4, params, nrows, mode);
-        case ST_REAL_F8:    return resolve1<float, double, double>(opcode, ST_REAL_F8, params, nrows, mode);
+        case ST_INTEGER_I1: return resolve1<float, int8_t, float>(opcode, ST_REAL_F4, mode, res_type);
+        case ST_INTEGER_I2: return resolve1<float, int16_t, float>(opcode, ST_REAL_F4, mode, res_type);
+        case ST_INTEGER_I4: return resolve1<float, int32_t, float>(opcode, ST_REAL_F4, mode, res_type);
+        case ST_INTEGER_I8: return resolve1<float, int64_t, float>(opcode, ST_REAL_F4, mode, res_type);
+        case ST_REAL_F4:    return resolve1<float, float, float>(opcode, ST_REAL_F4, mode, res_type);
+        case ST_REAL_F8:    return resolve1<float, double, double>(opcode, ST_REAL_F8, mode, res_type);
         default: break;
       }
       break;
@@ -314,12 +410,12 @@ static mapperfn resolve0(SType lhs_type, SType rhs_type, int opcode, void** para
     case ST_REAL_F8:
       switch (rhs_type) {
         case ST_BOOLEAN_I1:
-        case ST_INTEGER_I1: return resolve1<double, int8_t, double>(opcode, ST_REAL_F8, params, nrows, mode);
-        case ST_INTEGER_I2: return resolve1<double, int16_t, double>(opcode, ST_REAL_F8, params, nrows, mode);
-        case ST_INTEGER_I4: return resolve1<double, int32_t, double>(opcode, ST_REAL_F8, params, nrows, mode);
-        case ST_INTEGER_I8: return resolve1<double, int64_t, double>(opcode, ST_REAL_F8, params, nrows, mode);
-        case ST_REAL_F4:    return resolve1<double, float, double>(opcode, ST_REAL_F8, params, nrows, mode);
-        case ST_REAL_F8:    return resolve1<double, double, double>(opcode, ST_REAL_F8, params, nrows, mode);
+        case ST_INTEGER_I1: return resolve1<double, int8_t, double>(opcode, ST_REAL_F8, mode, res_type);
+        case ST_INTEGER_I2: return resolve1<double, int16_t, double>(opcode, ST_REAL_F8, mode, res_type);
+        case ST_INTEGER_I4: return resolve1<double, int32_t, double>(opcode, ST_REAL_F8, mode, res_type);
+        case ST_INTEGER_I8: return resolve1<double, int64_t, double>(opcode, ST_REAL_F8, mode, res_type);
+        case ST_REAL_F4:    return resolve1<double, float, double>(opcode, ST_REAL_F8, mode, res_type);
+        case ST_REAL_F8:    return resolve1<double, double, double>(opcode, ST_REAL_F8, mode, res_type);
         default: break;
       }
       break;
@@ -335,26 +431,30 @@ static mapperfn resolve0(SType lhs_type, SType rhs_type, int opcode, void** para
 // Exported binaryop function
 //------------------------------------------------------------------------------
 
+mapperfn binaryop_mapper(int opcode, SType lhs_type, SType rhs_type,
+                         OpMode mode, SType* res_type)
+{
+  return resolve0(lhs_type, rhs_type, opcode, mode, res_type);
+}
+
+
 Column* binaryop(int opcode, Column* lhs, Column* rhs)
 {
   int64_t lhs_nrows = lhs->nrows;
   int64_t rhs_nrows = rhs->nrows;
   SType lhs_type = lhs->stype();
   SType rhs_type = rhs->stype();
-  void* params[3];
-  params[0] = lhs;
-  params[1] = rhs;
-  params[2] = nullptr;
+  SType res_type = ST_VOID;
 
   mapperfn mapfn = nullptr;
   if (lhs_nrows == rhs_nrows) {
-    mapfn = resolve0(lhs_type, rhs_type, opcode, params, lhs_nrows, OpMode::N_to_N);
+    mapfn = resolve0(lhs_type, rhs_type, opcode, OpMode::N_to_N, &res_type);
   }
   else if (rhs_nrows == 1) {
-    mapfn = resolve0(lhs_type, rhs_type, opcode, params, lhs_nrows, OpMode::N_to_One);
+    mapfn = resolve0(lhs_type, rhs_type, opcode, OpMode::N_to_One, &res_type);
   }
   else if (lhs_nrows == 1) {
-    mapfn = resolve0(lhs_type, rhs_type, opcode, params, rhs_nrows, OpMode::One_to_N);
+    mapfn = resolve0(lhs_type, rhs_type, opcode, OpMode::One_to_N, &res_type);
   }
   if (!mapfn) {
     throw RuntimeError()
@@ -364,9 +464,14 @@ Column* binaryop(int opcode, Column* lhs, Column* rhs)
   }
 
   int64_t nrows = std::max(lhs_nrows, rhs_nrows);
-  (*mapfn)(0, nrows, params);
+  Column* res = Column::new_data_column(res_type, nrows);
+  void* params[3];
+  params[0] = lhs->data();
+  params[1] = rhs->data();
+  params[2] = res->data();
+  map_chunked(mapfn, nrows, params);
 
-  return static_cast<Column*>(params[2]);
+  return res;
 }
 
 };  // namespace expr
@@ -0,0 +1,198 @@
+//------------------------------------------------------------------------------
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// © H2O.ai 2018
+//------------------------------------------------------------------------------
+// Vectorized kernels for the arithmetic and relational operators, used from
+// "expr/binaryop.cc". This file has no include guard: it is included once for
+// each supported instruction set, with the following macros defined:
+//
+//   SIMD_NS      namespace where the kernels for this instruction set go;
+//   SIMD_TARGET  the target specification string, e.g. "avx2";
+//   SIMD_VS      the size of a vector register, in bytes.
+//
+// Every function here (including the small helpers) is compiled for the target
+// instruction set: the compiler would otherwise lower the operations on wide
+// vectors inside the helpers into scalar code before they get inlined into
+// the kernels.
+//
+// Instead of checking each element for NA with a branch, the NA flags of a
+// vector are computed as compare masks, and the NA sentinel is then blended
+// into the result:
+//
+//     res = ((x op y) & ~na) | (NA & na),    where na = isna(x) | isna(y)
+//
+// For the floating-point types no blending is needed in `+`, `-` and `*`,
+// since NaNs propagate on their own. The trailing rows that do not fill an
+// entire vector are processed with the scalar operators, so that the results
+// are exactly the same as in the scalar mappers.
+//------------------------------------------------------------------------------
+#define SIMD_PRAGMA(x) _Pragma(#x)
+#ifdef __clang__
+  #define SIMD_BEGIN_TARGET(t) \
+    SIMD_PRAGMA(clang attribute push(__attribute__((target(t))), apply_to = function))
+  #define SIMD_END_TARGET SIMD_PRAGMA(clang attribute pop)
+#else
+  #define SIMD_BEGIN_TARGET(t) \
+    SIMD_PRAGMA(GCC push_options) SIMD_PRAGMA(GCC target(t))
+  #define SIMD_END_TARGET SIMD_PRAGMA(GCC pop_options)
+#endif
+
+SIMD_BEGIN_TARGET(SIMD_TARGET)
+namespace SIMD_NS {
+
+
+// Vector of elements of type `T`, and the corresponding vector of masks
+// (signed integers of the same size as `T`).
+template <typename T>
+struct Vec {
+  typedef T type __attribute__((vector_size(SIMD_VS)));
+  typedef decltype(type() == type()) mask;
+  static constexpr int64_t width = SIMD_VS / sizeof(T);
+};
+
+template <typename T, typename V, typename M>
+inline static M vec_isna(V x) {
+  return std::is_floating_point<T>::value? static_cast<M>(x != x)
+                                         : static_cast<M>(x == GETNA<T>());
+}
+
+
+template <int OPCODE> struct VOp;
+
+template <> struct VOp<OpCode::Plus> {
+  template <typename T, typename V>
+  inline static V calc(V x, V y) { return x + y; }
+};
+
+template <> struct VOp<OpCode::Minus> {
+  template <typename T, typename V>
+  inline static V calc(V x, V y) { return x - y; }
+};
+
+template <> struct VOp<OpCode::Multiply> {
+  template <typename T, typename V>
+  inline static V calc(V x, V y) { return x * y; }
+};
+
+// Used for floating-point types only: division by zero gives NA
+template <> struct VOp<OpCode::Divide> {
+  template <typename T, typename V>
+  inline static V calc(V x, V y) {
+    typedef decltype(x == y) M;
+    M zero = (y == 0);
+    return (V)(((M)(x / y) & ~zero) | ((M)(V() + GETNA<T>()) & zero));
+  }
+};
+
+template <> struct VOp<OpCode::Equal> {
+  template <typename T, typename V, typename M>
+  inline static M calc(V x, V y) {
+    M xna = vec_isna<T, V, M>(x), yna = vec_isna<T, V, M>(y);
+    return ((x == y) & ~xna & ~yna) | (xna & yna);
+  }
+};
+
+template <> struct VOp<OpCode::NotEqual> {
+  template <typename T, typename V, typename M>
+  inline static M calc(V x, V y) {
+    return ~VOp<OpCode::Equal>::calc<T, V, M>(x, y);
+  }
+};
+
+template <> struct VOp<OpCode::Greater> {
+  template <typename T, typename V, typename M>
+  inline static M calc(V x, V y) {
+    M xna = vec_isna<T, V, M>(x), yna = vec_isna<T, V, M>(y);
+    return (x > y) & ~xna & ~yna;
+  }
+};
+
+template <> struct VOp<OpCode::Less> {
+  template <typename T, typename V, typename M>
+  inline static M calc(V x, V y) {
+    M xna = vec_isna<T, V, M>(x), yna = vec_isna<T, V, M>(y);
+    return (x < y) & ~xna & ~yna;
+  }
+};
+
+template <> struct VOp<OpCode::GreaterOrEqual> {
+  template <typename T, typename V, typename M>
+  inline static M calc(V x, V y) {
+    M xna = vec_isna<T, V, M>(x), yna = vec_isna<T, V, M>(y);
+    return ((x >= y) & ~xna & ~yna) | (xna & yna);
+  }
+};
+
+template <> struct VOp<OpCode::LessOrEqual> {
+  template <typename T, typename V, typename M>
+  inline static M calc(V x, V y) {
+    M xna = vec_isna<T, V, M>(x), yna = vec_isna<T, V, M>(y);
+    return ((x <= y) & ~xna & ~yna) | (xna & yna);
+  }
+};
+
+
+
+template <typename T, int OPCODE, T (*OP)(T, T)>
+static void vmap_arith(int64_t row0, int64_t row1, void** params) {
+  typedef typename Vec<T>::type V;
+  typedef typename Vec<T>::mask M;
+  constexpr int64_t W = Vec<T>::width;
+  const T* lhs_data = static_cast<const T*>(params[0]);
+  const T* rhs_data = static_cast<const T*>(params[1]);
+  T* res_data = static_cast<T*>(params[2]);
+  int64_t i = row0;
+  for (; i + W <= row1; i += W) {
+    V x, y;
+    std::memcpy(&x, lhs_data + i, SIMD_VS);
+    std::memcpy(&y, rhs_data + i, SIMD_VS);
+    V r = VOp<OPCODE>::template calc<T, V>(x, y);
+    if (!std::is_floating_point<T>::value) {
+      M na = vec_isna<T, V, M>(x) | vec_isna<T, V, M>(y);
+      r = (V)(((M)r & ~na) | ((M)(V() + GETNA<T>()) & na));
+    }
+    std::memcpy(res_data + i, &r, SIMD_VS);
+  }
+  for (; i < row1; ++i) {
+    res_data[i] = OP(lhs_data[i], rhs_data[i]);
+  }
+}
+
+
+template <typename T, int OPCODE, int8_t (*OP)(T, T)>
+static void vmap_cmp(int64_t row0, int64_t row1, void** params) {
+  typedef typename Vec<T>::type V;
+  typedef typename Vec<T>::mask M;
+  constexpr int64_t W = Vec<T>::width;
+  typedef int8_t B __attribute__((vector_size(W)));
+  const T* lhs_data = static_cast<const T*>(params[0]);
+  const T* rhs_data = static_cast<const T*>(params[1]);
+  int8_t* res_data = static_cast<int8_t*>(params[2]);
+  int64_t i = row0;
+  for (; i + W <= row1; i += W) {
+    V x, y;
+    std::memcpy(&x, lhs_data + i, SIMD_VS);
+    std::memcpy(&y, rhs_data + i, SIMD_VS);
+    M m = VOp<OPCODE>::template calc<T, V, M>(x, y);
+    // Mask lanes are -1 (true) or 0 (false); narrow them into 1/0 bytes
+    B r = -__builtin_convertvector(m, B);
+    std::memcpy(res_data + i, &r, W);
+  }
+  for (; i < row1; ++i) {
+    res_data[i] = OP(lhs_data[i], rhs_data[i]);
+  }
+}
+
+
+}  // namespace SIMD_NS
+SIMD_END_TARGET
+
+#undef SIMD_BEGIN_TARGET
+#undef SIMD_END_TARGET
+#undef SIMD_PRAGMA
+#undef SIMD_NS
+#undef SIMD_TARGET
+#undef SIMD_VS
@@ -0,0 +1,451 @@
+//------------------------------------------------------------------------------
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// © H2O.ai 2018
+//------------------------------------------------------------------------------
+// Fused evaluation of expression trees.
+//
+// Evaluating an expression such as `f.A * 2 + f.B > f.C` one operator at a time
+// creates a full-length temporary column for each intermediate result, which
+// is then read back by the next operator. Instead, the whole tree is compiled
+// here into a sequence of steps, each step being the mapper function of one
+// operator (the same functions that `unaryop()` and `binaryop()` use). The
+// steps are then applied to the rows chunk by chunk: the intermediate results
+// of a chunk are kept in small scratch "registers", and only the final result
+// is written into a newly allocated column.
+//
+// The input columns may also carry a RowIndex (when the expression is applied
+// to a view, or to a subset of rows of a frame). Such columns are not
+// materialized: instead, the rows of each chunk are gathered into a register
+// before the steps are applied.
+//
+// The same program may also be used to filter rows: in that case the result
+// of each chunk is never stored at all, instead the indices of the selected
+// rows are written directly into the RowIndex being constructed.
+//------------------------------------------------------------------------------
+#include "expr/py_expr.h"
+#include <algorithm>   // std::min
+#include <memory>      // std::unique_ptr
+#include "rowindex.h"
+#include "types.h"
+#include "utils/exceptions.h"
+#include "utils/omp.h"
+
+namespace expr
+{
+
+// Number of rows in one chunk. A register with 8-byte elements takes 16KB,
+// so that the registers of a typical expression fit into the L1/L2 cache.
+static constexpr int64_t FUSED_CHUNK = 1 << 11;
+
+
+enum ValueKind : uint8_t {
+  Input,     // a column of the full length: read at the current chunk
+  Scalar,    // a single value (1-row column, or a constant subexpression)
+  Register,  // a scratch buffer holding the current chunk of a subexpression
+  Gathered,  // a register holding the current chunk of a column with RowIndex
+  Output,    // the resulting column
+};
+
+struct Value {
+  const void* data;  // data pointer for Input / Scalar values
+  size_t elemsize;
+  int index;         // register index for Register values
+  SType stype;
+  ValueKind kind;
+  int64_t : 56;
+};
+
+struct Gather {
+  const Column* col;
+  const void* data;
+  RowIndex ri;
+  size_t elemsize;
+  int index;
+  int : 32;
+};
+
+struct Step {
+  mapperfn fn;
+  Value args[2];
+  Value out;
+  int nargs;
+  int : 32;
+};
+
+
+class FusedProgram {
+  std::vector<Step> steps;
+  std::vector<Gather> gathers;
+  std::vector<Value> stack;
+  std::vector<bool> reg_used;
+  // Storage for the values of constant subexpressions; each value occupies
+  // one 8-byte slot.
+  std::unique_ptr<int64_t[]> scalars;
+  size_t nscalars;
+  int64_t nrows;
+
+  public:
+    FusedProgram(const std::vector<int>& kinds, const std::vector<int>& args,
+                 const std::vector<Column*>& cols, int64_t nrows = -1);
+    Column* execute();
+    RowIndex filter(bool inverse, const RowIndex& ri);
+
+  private:
+    void push_column(Column* col);
+    void apply(int opcode, int nargs);
+    Value make_register(SType stype, bool fresh = false);
+    void run_chunk(int64_t row0, int64_t row1, int64_t* regs,
+                   void* res_data) const;
+    template <typename T>
+    void filter_rows(int64_t row0, int64_t row1, T* out, int32_t* nouts,
+                     bool inverse, const RowIndex& ri) const;
+};
+
+
+FusedProgram::FusedProgram(const std::vector<int>& kinds,
+                           const std::vector<int>& args,
+                           const std::vector<Column*>& cols,
+                           int64_t nrows_)
+  : scalars(new int64_t[kinds.size()]), nscalars(0)
+{
+  // Columns with a single row are broadcast against the others. If the number
+  // of rows is given explicitly, then all 1-row columns are broadcast.
+  nrows = nrows_ >= 0? nrows_ : 1;
+  for (Column* col : cols) {
+    if (col->nrows != 1 && nrows_ < 0) nrows = col->nrows;
+  }
+  for (Column* col : cols) {
+    if (col->nrows != 1 && col->nrows != nrows) {
+      throw ValueError() << "Cannot apply an operator to incompatible "
+                            "columns of sizes " << nrows << " and "
+                         << col->nrows;
+    }
+  }
+  for (size_t i = 0; i < kinds.size(); ++i) {
+    int arg = args[i];
+    switch (kinds[i]) {
+      case 0:
+        if (arg < 0 || static_cast<size_t>(arg) >= cols.size()) {
+          throw ValueError() << "Invalid column index " << arg;
+        }
+        push_column(cols[static_cast<size_t>(arg)]);
+        break;
+      case 1: apply(arg, 1); break;
+      case 2: apply(arg, 2); break;
+      default:
+        throw ValueError() << "Invalid instruction kind " << kinds[i];
+    }
+  }
+  if (stack.size() != 1) {
+    throw ValueError() << "Invalid program: it leaves " << stack.size()
+                       << " values on the stack";
+  }
+}
+
+
+void FusedProgram::push_column(Column* col) {
+  const RowIndex& ri = col->rowindex();
+  Value v;
+  v.data = mapper_data(col);
+  v.elemsize = col->elemsize();
+  v.index = 0;
+  v.stype = col->stype();
+  v.kind = (col->nrows == 1 && nrows != 1)? Scalar : Input;
+  if (ri && v.kind == Scalar) {
+    v.data = static_cast<const char*>(v.data) +
+             static_cast<size_t>(ri.nth(0)) * v.elemsize;
+  }
+  else if (ri && col->nrows) {
+    if (v.stype < ST_BOOLEAN_I1 || v.stype > ST_REAL_F8) {
+      throw ValueError() << "Column of stype " << v.stype << " must be "
+                            "materialized before it can be used in an "
+                            "expression";
+    }
+    // The same column may be pushed several times, but it is gathered once
+    for (const Gather& g : gathers) {
+      if (g.col == col) {
+        v.data = nullptr;
+        v.index = g.index;
+        v.kind = Gathered;
+        stack.push_back(v);
+        return;
+      }
+    }
+    // All columns are gathered at the start of each chunk, before any step is
+    // run: thus the register must not be shared with any step, even with the
+    // steps that precede this column in the program.
+    Value r = make_register(v.stype, true);
+    r.kind = Gathered;
+    gathers.push_back(Gather {col, v.data, ri, v.elemsize, r.index});
+    v = r;
+  }
+  stack.push_back(v);
+}
+
+
+Value FusedProgram::make_register(SType stype, bool fresh) {
+  size_t i = fresh? reg_used.size() : 0;
+  while (i < reg_used.size() && reg_used[i]) ++i;
+  if (i == reg_used.size()) reg_used.push_back(false);
+  reg_used[i] = true;
+  Value v;
+  v.data = nullptr;
+  v.elemsize = stype_info[stype].elemsize;
+  v.index = static_cast<int>(i);
+  v.stype = stype;
+  v.kind = Register;
+  return v;
+}
+
+
+void FusedProgram::apply(int opcode, int nargs) {
+  if (stack.size() < static_cast<size_t>(nargs)) {
+    throw ValueError() << "Invalid program: operator " << opcode
+                       << " has too few arguments";
+  }
+  Step step;
+  step.nargs = nargs;
+  for (int j = 0; j < nargs; ++j) {
+    step.args[j] = stack[stack.size() - static_cast<size_t>(nargs - j)];
+  }
+  stack.resize(stack.size() - static_cast<size_t>(nargs));
+  const Value& x = step.args[0];
+  const Value& y = step.args[nargs - 1];
+  bool all_scalar = (x.kind == Scalar && y.kind == Scalar);
+
+  SType res_type = ST_VOID;
+  if (nargs == 1) {
+    step.fn = unaryop_mapper(opcode, x.stype, &res_type);
+  } else {
+    OpMode mode = all_scalar || (x.kind != Scalar && y.kind != Scalar)
+                    ? OpMode::N_to_N
+                    : x.kind == Scalar? OpMode::One_to_N : OpMode::N_to_One;
+    step.fn = binaryop_mapper(opcode, x.stype, y.stype, mode, &res_type);
+  }
+  if (!step.fn && nargs == 1) {
+    throw RuntimeError()
+      << "Unable to apply unary op " << opcode << " to column(stype="
+      << x.stype << ")";
+  }
+  if (!step.fn) {
+    throw RuntimeError()
+      << "Unable to apply op " << opcode << " to column1(stype=" << x.stype
+      << ") and column2(stype=" << y.stype << ")";
+  }
+
+  if (all_scalar) {
+    // Constant subexpression: evaluate it right away
+    Value v;
+    v.data = scalars.get() + nscalars++;
+    v.elemsize = stype_info[res_type].elemsize;
+    v.index = 0;
+    v.stype = res_type;
+    v.kind = Scalar;
+    void* params[3] = {const_cast<void*>(x.data), const_cast<void*>(y.data),
+                       nullptr};
+    params[nargs] = const_cast<void*>(v.data);
+    step.fn(0, 1, params);
+    stack.push_back(v);
+    return;
+  }
+  // The output register must differ from the registers of the arguments, since
+  // the elements of the result may be wider than those of the arguments.
+  step.out = make_register(res_type);
+  for (int j = 0; j < nargs; ++j) {
+    if (step.args[j].kind == Register) {
+      reg_used[static_cast<size_t>(step.args[j].index)] = false;
+    }
+  }
+  steps.push_back(step);
+  stack.push_back(step.out);
+}
+
+
+template <typename T>
+static void gather_chunk(const Gather& g, int64_t row0, int64_t row1,
+                         void* out)
+{
+  const T* src = static_cast<const T*>(g.data);
+  T* dest = static_cast<T*>(out);
+  g.ri.strided_loop(row0, row1, 1,
+    [&](int64_t j) {
+      *dest++ = src[j];
+    });
+}
+
+
+void FusedProgram::run_chunk(int64_t row0, int64_t row1, int64_t* regs,
+                             void* res_data) const
+{
+  int64_t n = row1 - row0;
+  for (const Gather& g : gathers) {
+    int64_t* out = regs + g.index * FUSED_CHUNK;
+    switch (g.elemsize) {
+      case 1: gather_chunk<int8_t>(g, row0, row1, out); break;
+      case 2: gather_chunk<int16_t>(g, row0, row1, out); break;
+      case 4: gather_chunk<int32_t>(g, row0, row1, out); break;
+      default: gather_chunk<int64_t>(g, row0, row1, out); break;
+    }
+  }
+  void* params[3];
+  for (const Step& step : steps) {
+    for (int j = 0; j <= step.nargs; ++j) {
+      const Value& v = j < step.nargs? step.args[j] : step.out;
+      switch (v.kind) {
+        case Input:
+          params[j] = const_cast<char*>(static_cast<const char*>(v.data)) +
+                      static_cast<size_t>(row0) * v.elemsize;
+          break;
+        case Scalar:
+          params[j] = const_cast<void*>(v.data);
+          break;
+        case Register:
+        case Gathered:
+          params[j] = regs + v.index * FUSED_CHUNK;
+          break;
+        case Output:
+          params[j] = static_cast<char*>(res_data) +
+                      static_cast<size_t>(row0) * v.elemsize;
+          break;
+      }
+    }
+    step.fn(0, n, params);
+  }
+}
+
+
+Column* FusedProgram::execute() {
+  const Value& top = stack[0];
+  if (top.kind != Register) {
+    throw ValueError() << "Invalid program: it contains no operators";
+  }
+  // The last step writes directly into the resulting column
+  steps.back().out.kind = Output;
+  Column* res = Column::new_data_column(top.stype, nrows);
+  void* res_data = res->data();
+  size_t regsize = reg_used.size() * static_cast<size_t>(FUSED_CHUNK);
+  int64_t nchunks = (nrows + FUSED_CHUNK - 1) / FUSED_CHUNK;
+  if (nchunks <= 1) {
+    std::unique_ptr<int64_t[]> regs(new int64_t[regsize]);
+    run_chunk(0, nrows, regs.get(), res_data);
+    return res;
+  }
+  #pragma omp parallel
+  {
+    std::unique_ptr<int64_t[]> regs(new int64_t[regsize]);
+    #pragma omp for schedule(dynamic)
+    for (int64_t c = 0; c < nchunks; ++c) {
+      int64_t row0 = c * FUSED_CHUNK;
+      int64_t row1 = std::min(row0 + FUSED_CHUNK, nrows);
+      run_chunk(row0, row1, regs.get(), res_data);
+    }
+  }
+  return res;
+}
+
+
+// Evaluate the program over rows `[row0; row1)`, and write into `out` the
+// indices of the rows where the result is true (or, if `inverse` is set, where
+// the result is false or NA). If `ri` is given, then the index of each selected
+// row `i` is mapped into `ri.nth(i)`.
+template <typename T>
+void FusedProgram::filter_rows(int64_t row0, int64_t row1, T* out,
+                               int32_t* nouts, bool inverse,
+                               const RowIndex& ri) const
+{
+  const Value& top = stack[0];
+  const int32_t* ri32 = ri.isarr32()? ri.indices32() : nullptr;
+  const int64_t* ri64 = ri.isarr64()? ri.indices64() : nullptr;
+  int64_t ristart = ri.isslice()? ri.slice_start() : 0;
+  int64_t ristep = ri.isslice()? ri.slice_step() : 1;
+  std::unique_ptr<int64_t[]> regs(
+      new int64_t[reg_used.size() * static_cast<size_t>(FUSED_CHUNK)]);
+  int32_t k = 0;
+  for (int64_t i0 = row0; i0 < row1; i0 += FUSED_CHUNK) {
+    int64_t i1 = std::min(i0 + FUSED_CHUNK, row1);
+    run_chunk(i0, i1, regs.get(), nullptr);
+    const int8_t* x;
+    int64_t xstep = 1;
+    switch (top.kind) {
+      case Register:
+      case Gathered:
+        x = reinterpret_cast<const int8_t*>(regs.get() + top.index * FUSED_CHUNK);
+        break;
+      case Scalar:
+        x = static_cast<const int8_t*>(top.data);
+        xstep = 0;
+        break;
+      default:
+        x = static_cast<const int8_t*>(top.data) + i0;
+    }
+    for (int64_t j = 0; j < i1 - i0; ++j) {
+      if ((x[j * xstep] == 1) == inverse) continue;
+      int64_t i = i0 + j;
+      out[k++] = static_cast<T>(ri32? ri32[i] : ri64? ri64[i]
+                                                    : ristart + i * ristep);
+    }
+  }
+  *nouts = k;
+}
+
+
+RowIndex FusedProgram::filter(bool inverse, const RowIndex& ri) {
+  const Value& top = stack[0];
+  if (top.stype != ST_BOOLEAN_I1) {
+    throw ValueError() << "Filter expression must be boolean, instead it "
+                          "produces a column of stype " << top.stype;
+  }
+  if (ri && ri.length() != nrows) {
+    throw ValueError() << "RowIndex of length " << ri.length() << " cannot "
+                          "be applied to a filter over " << nrows << " rows";
+  }
+  bool sorted = !ri || (ri.isslice() && ri.slice_step() >= 0);
+  if (nrows <= INT32_MAX && ri.max() <= INT32_MAX) {
+    return RowIndex::from_filterfn32(
+      [&](int64_t row0, int64_t row1, int32_t* out, int32_t* nouts) {
+        filter_rows(row0, row1, out, nouts, inverse, ri);
+      }, nrows, sorted);
+  } else {
+    return RowIndex::from_filterfn64(
+      [&](int64_t row0, int64_t row1, int64_t* out, int32_t* nouts) {
+        filter_rows(row0, row1, out, nouts, inverse, ri);
+      }, nrows, sorted);
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+// Exported function
+//------------------------------------------------------------------------------
+
+Column* fused(const std::vector<int>& kinds, const std::vector<int>& args,
+              const std::vector<Column*>& cols)
+{
+  if (kinds.size() != args.size()) {
+    throw ValueError() << "Lists of instruction kinds and arguments must have "
+                          "the same length";
+  }
+  FusedProgram program(kinds, args, cols);
+  return program.execute();
+}
+
+
+RowIndex fused_filter(const std::vector<int>& kinds,
+                      const std::vector<int>& args,
+                      const std::vector<Column*>& cols, int64_t nrows,
+                      bool inverse, const RowIndex& ri)
+{
+  if (kinds.size() != args.size()) {
+    throw ValueError() << "Lists of instruction kinds and arguments must have "
+                          "the same length";
+  }
+  FusedProgram program(kinds, args, cols, nrows);
+  return program.filter(inverse, ri);
+}
+
+
+};  // namespace expr
@@ -0,0 +1,400 @@
+//------------------------------------------------------------------------------
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// © H2O.ai 2018
+//------------------------------------------------------------------------------
+// Set membership test `isin(col, values)`.
+//
+// The values are first collected into a set, which is then probed (in
+// parallel) by each element of the column. Integer values spanning a small
+// range are stored in a bitmap; all other values go into an open-addressing
+// hash table with linear probing, which is kept at most half full. The string
+// set refers to the data of the `values` column, without copying it.
+//
+// The result is never NA: an NA in the column is "in" the values iff the
+// values contain an NA too.
+//------------------------------------------------------------------------------
+#include "expr/py_expr.h"
+#include <algorithm>   // std::max
+#include <cstdlib>     // std::abs
+#include <cstring>     // std::memcmp, std::memcpy
+#include <limits>      // std::numeric_limits
+#include <memory>      // std::unique_ptr
+#include <vector>      // std::vector
+#include "types.h"
+#include "utils/exceptions.h"
+#include "utils/hash.h"
+#include "utils/omp.h"
+
+namespace expr
+{
+
+enum ValueKind {
+  NotSupported = 0,
+  Integer      = 1,
+  Real         = 2,
+  String       = 3,
+};
+
+static ValueKind value_kind(SType st) {
+  switch (st) {
+    case ST_BOOLEAN_I1:
+    case ST_INTEGER_I1:
+    case ST_INTEGER_I2:
+    case ST_INTEGER_I4:
+    case ST_INTEGER_I8:       return Integer;
+    case ST_REAL_F4:
+    case ST_REAL_F8:          return Real;
+    case ST_STRING_I4_VCHAR:
+    case ST_STRING_I8_VCHAR:  return String;
+    default:                  return NotSupported;
+  }
+}
+
+
+// Number of slots in a hash table for `n` values: a power of 2, such that the
+// table is at most half full.
+static size_t table_size(size_t n) {
+  size_t size = 16;
+  while (size < 2 * n) size <<= 1;
+  return size;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Sets of values
+//------------------------------------------------------------------------------
+
+/**
+ * Hash set of 64-bit keys (integers, or the bits of doubles). The key
+ * `EMPTY` marks the unused slots, and thus cannot be stored: this is the
+ * NA value for int64, and the bits of -0.0 for doubles (which is normalized
+ * into +0.0 by `real_key()`).
+ */
+class HashSet64 {
+  static constexpr uint64_t EMPTY = 0x8000000000000000ULL;
+  std::vector<uint64_t> table;
+  size_t mask;
+
+  public:
+    explicit HashSet64(size_t n)
+      : table(table_size(n), EMPTY), mask(table.size() - 1) {}
+
+    void insert(uint64_t key) { table[slot(key)] = key; }
+    bool contains(uint64_t key) const { return table[slot(key)] == key; }
+
+  private:
+    size_t slot(uint64_t key) const {
+      size_t i = hash_finalize(key) & mask;
+      while (table[i] != key && table[i] != EMPTY) i = (i + 1) & mask;
+      return i;
+    }
+};
+
+static inline uint64_t real_key(double x) {
+  if (x == 0) x = 0.0;
+  uint64_t r;
+  std::memcpy(&r, &x, sizeof(double));
+  return r;
+}
+
+// Lookup of a floating-point value in the set of doubles
+struct RealProbe {
+  const HashSet64& set;
+  template <typename T> int8_t operator()(T x) const {
+    return set.contains(real_key(static_cast<double>(x)));
+  }
+};
+
+
+// Convert `x` into an int64 if it is an integer within the range of (non-NA)
+// int64 values. The comparison of integers with reals is done this way, so
+// that no int64 value is ever rounded into a double.
+static inline bool real_to_int(double x, int64_t* out) {
+  if (!(x > -9223372036854775808.0 && x < 9223372036854775808.0)) return false;
+  int64_t r = static_cast<int64_t>(x);
+  if (static_cast<double>(r) != x) return false;
+  *out = r;
+  return true;
+}
+
+
+/**
+ * Set of integers. If the values span a range that is not much larger than
+ * the number of values, then they are stored in a bitmap. Otherwise the set
+ * is a `HashSet64`.
+ */
+class IntSet {
+  std::vector<uint64_t> bitmap;
+  HashSet64 hashset;
+  uint64_t vmin;
+  uint64_t range;
+
+  public:
+    IntSet(const int64_t* values, size_t n, int64_t min, int64_t max)
+      : hashset(0), vmin(static_cast<uint64_t>(min)), range(0)
+    {
+      if (n == 0) return;
+      uint64_t span = static_cast<uint64_t>(max) - vmin;
+      if (span < std::max(size_t(1) << 16, 64 * n)) {
+        range = span + 1;
+        bitmap.resize(static_cast<size_t>((range + 63) / 64));
+        for (size_t i = 0; i < n; ++i) {
+          int64_t x = values[i];
+          if (ISNA<int64_t>(x)) continue;
+          uint64_t d = static_cast<uint64_t>(x) - vmin;
+          bitmap[d >> 6] |= 1ULL << (d & 63);
+        }
+      } else {
+        hashset = HashSet64(n);
+        for (size_t i = 0; i < n; ++i) {
+          int64_t x = values[i];
+          if (!ISNA<int64_t>(x)) hashset.insert(static_cast<uint64_t>(x));
+        }
+      }
+    }
+
+    bool contains(int64_t x) const {
+      if (bitmap.empty()) {
+        return hashset.contains(static_cast<uint64_t>(x));
+      }
+      uint64_t d = static_cast<uint64_t>(x) - vmin;
+      return d < range && ((bitmap[d >> 6] >> (d & 63)) & 1);
+    }
+};
+
+// Set of the `n` int64 `values` (which may include NAs)
+static IntSet make_int_set(const int64_t* values, size_t n) {
+  int64_t min = std::numeric_limits<int64_t>::max();
+  int64_t max = std::numeric_limits<int64_t>::min();
+  for (size_t i = 0; i < n; ++i) {
+    int64_t x = values[i];
+    if (ISNA<int64_t>(x)) continue;
+    if (x < min) min = x;
+    if (x > max) max = x;
+  }
+  return IntSet(values, n, min, max);
+}
+
+// Lookup of a floating-point value in the set of integers
+struct RealInIntSetProbe {
+  const IntSet& set;
+  template <typename T> int8_t operator()(T x) const {
+    int64_t r;
+    return real_to_int(static_cast<double>(x), &r) && set.contains(r);
+  }
+};
+
+
+/**
+ * Hash set of strings, which point into the data of some string column. The
+ * slots with `ch == nullptr` are empty.
+ */
+class StringSet {
+  struct Slot {
+    const char* ch;
+    size_t len;
+    uint64_t hash;
+  };
+  std::vector<Slot> table;
+  size_t mask;
+
+  public:
+    explicit StringSet(size_t n)
+      : table(table_size(n), Slot {nullptr, 0, 0}), mask(table.size() - 1) {}
+
+    void insert(const char* ch, size_t len) {
+      uint64_t h = hash_of(ch, len);
+      Slot& s = table[slot(ch, len, h)];
+      s.ch = ch;
+      s.len = len;
+      s.hash = h;
+    }
+
+    bool contains(const char* ch, size_t len) const {
+      return table[slot(ch, len, hash_of(ch, len))].ch != nullptr;
+    }
+
+  private:
+    static uint64_t hash_of(const char* ch, size_t len) {
+      return hash_finalize(
+          hash_bytes(reinterpret_cast<const uint8_t*>(ch), len));
+    }
+
+    size_t slot(const char* ch, size_t len, uint64_t h) const {
+      size_t i = h & mask;
+      while (true) {
+        const Slot& s = table[i];
+        if (!s.ch || (s.hash == h && s.len == len &&
+                      std::memcmp(s.ch, ch, len) == 0)) return i;
+        i = (i + 1) & mask;
+      }
+    }
+};
+
+
+
+//------------------------------------------------------------------------------
+// Probing
+//------------------------------------------------------------------------------
+
+template <typename T, typename F>
+static void probe(const Column* col, int8_t* trg, int8_t na_res, F contains) {
+  const T* src = static_cast<const T*>(col->data());
+  int64_t n = col->nrows;
+  #pragma omp parallel for schedule(static)
+  for (int64_t i = 0; i < n; ++i) {
+    T x = src[i];
+    trg[i] = ISNA<T>(x)? na_res : contains(x);
+  }
+}
+
+template <typename T>
+static StringSet make_string_set(const Column* col) {
+  auto scol = static_cast<const StringColumn<T>*>(col);
+  const char* strdata = scol->strdata();
+  const T* offsets = scol->offsets();
+  size_t n = static_cast<size_t>(col->nrows);
+  StringSet set(n);
+  for (size_t i = 0; i < n; ++i) {
+    T off = offsets[i];
+    if (off < 0) continue;
+    T start = std::abs(offsets[i - 1]);
+    set.insert(strdata + start, static_cast<size_t>(off - start));
+  }
+  return set;
+}
+
+template <typename T>
+static void probe_strings(const Column* col, int8_t* trg, int8_t na_res,
+                          const StringSet& set)
+{
+  auto scol = static_cast<const StringColumn<T>*>(col);
+  const char* strdata = scol->strdata();
+  const T* offsets = scol->offsets();
+  int64_t n = col->nrows;
+  #pragma omp parallel for schedule(static)
+  for (int64_t i = 0; i < n; ++i) {
+    T off = offsets[i];
+    if (off < 0) {
+      trg[i] = na_res;
+    } else {
+      T start = std::abs(offsets[i - 1]);
+      trg[i] = set.contains(strdata + start, static_cast<size_t>(off - start));
+    }
+  }
+}
+
+template <typename F>
+static void probe_integer(const Column* col, int8_t* trg, int8_t na_res,
+                          F contains)
+{
+  switch (col->stype()) {
+    case ST_BOOLEAN_I1:
+    case ST_INTEGER_I1: probe<int8_t>(col, trg, na_res, contains); break;
+    case ST_INTEGER_I2: probe<int16_t>(col, trg, na_res, contains); break;
+    case ST_INTEGER_I4: probe<int32_t>(col, trg, na_res, contains); break;
+    case ST_INTEGER_I8: probe<int64_t>(col, trg, na_res, contains); break;
+    default: throw RuntimeError() << "Unexpected stype " << col->stype();
+  }
+}
+
+template <typename F>
+static void probe_real(const Column* col, int8_t* trg, int8_t na_res,
+                       F contains)
+{
+  switch (col->stype()) {
+    case ST_REAL_F4: probe<float>(col, trg, na_res, contains); break;
+    case ST_REAL_F8: probe<double>(col, trg, na_res, contains); break;
+    default: throw RuntimeError() << "Unexpected stype " << col->stype();
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+// Main function
+//------------------------------------------------------------------------------
+
+Column* isin(Column* col, Column* values) {
+  if (col->rowindex() || values->rowindex()) {
+    throw RuntimeError() << "Operator `isin` requires materialized columns";
+  }
+  int64_t nas = values->countna();
+  int8_t na_res = nas > 0;
+  // Values that are all NA are compatible with a column of any type: replace
+  // them with an empty column of the same type as `col`.
+  std::unique_ptr<Column> empty;
+  if (nas == values->nrows) {
+    empty.reset(Column::new_data_column(col->stype(), 0));
+    values = empty.get();
+  }
+  ValueKind lkind = value_kind(col->stype());
+  ValueKind rkind = value_kind(values->stype());
+  int64_t nvalues = values->nrows;
+  if (lkind == NotSupported || rkind == NotSupported ||
+      (lkind == String) != (rkind == String)) {
+    throw TypeError() << "Operator `isin` cannot be applied to a column of "
+                         "type " << col->stype() << " with values of type "
+                      << values->stype();
+  }
+
+  Column* res = Column::new_data_column(ST_BOOLEAN_I1, col->nrows);
+  int8_t* trg = static_cast<int8_t*>(res->data());
+  if (lkind == String) {
+    bool str64 = values->stype() == ST_STRING_I8_VCHAR;
+    StringSet set = str64? make_string_set<int64_t>(values)
+                         : make_string_set<int32_t>(values);
+    if (col->stype() == ST_STRING_I8_VCHAR) {
+      probe_strings<int64_t>(col, trg, na_res, set);
+    } else {
+      probe_strings<int32_t>(col, trg, na_res, set);
+    }
+  }
+  else if (lkind == Real && rkind == Real) {
+    std::unique_ptr<Column> vals(values->cast(ST_REAL_F8));
+    const double* data = static_cast<const double*>(vals->data());
+    HashSet64 set(static_cast<size_t>(nvalues));
+    for (int64_t i = 0; i < nvalues; ++i) {
+      if (!ISNA<double>(data[i])) set.insert(real_key(data[i]));
+    }
+    probe_real(col, trg, na_res, RealProbe {set});
+  }
+  else if (lkind == Real) {
+    // Real column, integer values: only the integral reals may match
+    std::unique_ptr<Column> vals(values->cast(ST_INTEGER_I8));
+    const int64_t* data = static_cast<const int64_t*>(vals->data());
+    IntSet set = make_int_set(data, static_cast<size_t>(nvalues));
+    probe_real(col, trg, na_res, RealInIntSetProbe {set});
+  }
+  else {
+    // Integer column: the values are converted into int64 exactly. Real
+    // values that are not integers cannot match any element, and are
+    // replaced with NAs.
+    std::vector<int64_t> ivals;
+    const int64_t* data;
+    std::unique_ptr<Column> vals;
+    if (rkind == Real) {
+      vals.reset(values->cast(ST_REAL_F8));
+      const double* rdata = static_cast<const double*>(vals->data());
+      ivals.resize(static_cast<size_t>(nvalues));
+      for (size_t i = 0; i < ivals.size(); ++i) {
+        if (!real_to_int(rdata[i], &ivals[i])) ivals[i] = GETNA<int64_t>();
+      }
+      data = ivals.data();
+    } else {
+      vals.reset(values->cast(ST_INTEGER_I8));
+      data = static_cast<const int64_t*>(vals->data());
+    }
+    IntSet set = make_int_set(data, static_cast<size_t>(nvalues));
+    probe_integer(col, trg, na_res,
+      [&](int64_t x) -> int8_t { return set.contains(x); });
+  }
+  return res;
+}
+
+
+};  // namespace expr
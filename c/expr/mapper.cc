@@ -0,0 +1,44 @@
+//------------------------------------------------------------------------------
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// © H2O.ai 2018
+//------------------------------------------------------------------------------
+#include "expr/py_expr.h"
+#include <algorithm>   // std::min
+#include "utils/omp.h"
+
+namespace expr
+{
+
+// Number of rows processed by a single call of a mapper function. With up to
+// three 8-byte columns involved (two inputs and the output), one chunk spans
+// about 200KB of memory, i.e. fits into the L2 cache.
+static constexpr int64_t MAP_CHUNK = 1 << 13;
+
+
+/**
+ * Apply the mapper function `fn` to all rows in the range `[0; nrows)`. The
+ * rows are split into chunks of `MAP_CHUNK` rows, which are then distributed
+ * dynamically among the threads. Each chunk writes into its own range of the
+ * output, so no synchronization is needed. Small inputs (a single chunk) are
+ * processed in the calling thread, avoiding the overhead of the parallel
+ * region.
+ */
+void map_chunked(mapperfn fn, int64_t nrows, void** params) {
+  if (nrows <= MAP_CHUNK) {
+    (*fn)(0, nrows, params);
+    return;
+  }
+  int64_t nchunks = (nrows + MAP_CHUNK - 1) / MAP_CHUNK;
+  #pragma omp parallel for schedule(dynamic)
+  for (int64_t c = 0; c < nchunks; ++c) {
+    int64_t row0 = c * MAP_CHUNK;
+    int64_t row1 = std::min(row0 + MAP_CHUNK, nrows);
+    (*fn)(row0, row1, params);
+  }
+}
+
+
+};  // namespace expr
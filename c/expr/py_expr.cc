@@ -8,8 +8,11 @@
 #define dt_EXPR_PY_EXPR_CC
 #include <Python.h>
 #include "expr/py_expr.h"
+#include <vector>
+#include "python/list.h"
 #include "utils/pyobj.h"
 #include "py_column.h"
+#include "py_rowindex.h"
 
 
 PyObject* expr_binaryop(PyObject*, PyObject* args)
@@ -46,8 +49,10 @@ PyObject* expr_cast(PyObject*, PyObject* args)
 PyObject* expr_column(PyObject*, PyObject* args)
 {
   int64_t index;
+  int reify = 1;
   PyObject* arg1, *arg3;
-  if (!PyArg_ParseTuple(args, "OlO:expr_column", &arg1, &index, &arg3))
+  if (!PyArg_ParseTuple(args, "OlO|p:expr_column", &arg1, &index, &arg3,
+                        &reify))
     return nullptr;
   PyObj pyarg1(arg1);
   PyObj pyarg3(arg3);
@@ -58,25 +63,147 @@ PyObject* expr_column(PyObject*, PyObject* args)
     PyErr_Format(PyExc_ValueError, "Invalid column index %lld", index);
   }
   Column* col = dt->columns[index]->shallowcopy(ri);
-  col->reify();
+  // Only the numeric columns may be read through a RowIndex by the mappers
+  // and the reducers; all others are always materialized.
+  SType st = col->stype();
+  if (reify || st < ST_BOOLEAN_I1 || st > ST_REAL_F8) {
+    col = col->reified();
+  }
   return pycolumn::from_column(col, NULL, 0);
 }
 
 
+// Parse the lists `kinds`, `args` and `cols` of a fused program
+static void parse_fused_program(PyObject* arg1, PyObject* arg2, PyObject* arg3,
+                                std::vector<int>& kinds,
+                                std::vector<int>& iargs,
+                                std::vector<Column*>& cols)
+{
+  PyyList pykinds(arg1);
+  PyyList pyargs(arg2);
+  PyyList pycols(arg3);
+  kinds.resize(pykinds.size());
+  iargs.resize(pyargs.size());
+  cols.resize(pycols.size());
+  for (size_t i = 0; i < kinds.size(); ++i) {
+    kinds[i] = PyObj(pykinds[i]).as_int32();
+  }
+  for (size_t i = 0; i < iargs.size(); ++i) {
+    iargs[i] = PyObj(pyargs[i]).as_int32();
+  }
+  for (size_t i = 0; i < cols.size(); ++i) {
+    cols[i] = PyObj(pycols[i]).as_column();
+  }
+}
+
+
+PyObject* expr_fused(PyObject*, PyObject* args)
+{
+  PyObject* arg1;
+  PyObject* arg2;
+  PyObject* arg3;
+  if (!PyArg_ParseTuple(args, "O!O!O!:expr_fused",
+                        &PyList_Type, &arg1, &PyList_Type, &arg2,
+                        &PyList_Type, &arg3))
+    return nullptr;
+  std::vector<int> kinds, iargs;
+  std::vector<Column*> cols;
+  parse_fused_program(arg1, arg2, arg3, kinds, iargs, cols);
+  Column* res = expr::fused(kinds, iargs, cols);
+  return pycolumn::from_column(res, nullptr, 0);
+}
+
+
+PyObject* expr_fused_filter(PyObject*, PyObject* args)
+{
+  PyObject* arg1;
+  PyObject* arg2;
+  PyObject* arg3;
+  PyObject* arg6;
+  int64_t nrows;
+  int inverse;
+  if (!PyArg_ParseTuple(args, "O!O!O!lpO:expr_fused_filter",
+                        &PyList_Type, &arg1, &PyList_Type, &arg2,
+                        &PyList_Type, &arg3, &nrows, &inverse, &arg6))
+    return nullptr;
+  std::vector<int> kinds, iargs;
+  std::vector<Column*> cols;
+  parse_fused_program(arg1, arg2, arg3, kinds, iargs, cols);
+  RowIndex ri = PyObj(arg6).as_rowindex();
+  RowIndex res = expr::fused_filter(kinds, iargs, cols, nrows, inverse, ri);
+  return pyrowindex::wrap(res);
+}
+
+
+PyObject* expr_isin(PyObject*, PyObject* args)
+{
+  PyObject* arg1, *arg2;
+  if (!PyArg_ParseTuple(args, "OO:expr_isin", &arg1, &arg2))
+    return nullptr;
+  PyObj pyarg1(arg1);
+  PyObj pyarg2(arg2);
+
+  Column* col = pyarg1.as_column();
+  Column* values = pyarg2.as_column();
+  Column* res = expr::isin(col, values);
+  return pycolumn::from_column(res, nullptr, 0);
+}
+
+
 PyObject* expr_reduceop(PyObject*, PyObject* args)
 {
   int opcode;
   PyObject* arg1;
-  if (!PyArg_ParseTuple(args, "iO:expr_reduceop", &opcode, &arg1))
+  double param = 0.0;
+  if (!PyArg_ParseTuple(args, "iO|d:expr_reduceop", &opcode, &arg1, &param))
     return nullptr;
   PyObj pyarg1(arg1);
 
   Column* col = pyarg1.as_column();
-  Column* res = expr::reduceop(opcode, col);
+  Column* res = expr::reduceop(opcode, col, param);
   return pycolumn::from_column(res, nullptr, 0);
 }
 
 
+PyObject* expr_reduceops(PyObject*, PyObject* args)
+{
+  PyObject* arg1;
+  PyObject* arg2;
+  PyObject* arg3 = nullptr;
+  if (!PyArg_ParseTuple(args, "O!O!|O!:expr_reduceops",
+                        &PyList_Type, &arg1, &PyList_Type, &arg2,
+                        &PyList_Type, &arg3))
+    return nullptr;
+  PyyList pyopcodes(arg1);
+  PyyList pycols(arg2);
+  size_t n = pyopcodes.size();
+  if (pycols.size() != n) {
+    throw ValueError() << "Lists of opcodes and columns must have the same "
+                          "length";
+  }
+  std::vector<int> opcodes(n);
+  std::vector<Column*> cols(n);
+  std::vector<double> params;
+  for (size_t i = 0; i < n; ++i) {
+    opcodes[i] = PyObj(pyopcodes[i]).as_int32();
+    cols[i] = PyObj(pycols[i]).as_column();
+  }
+  if (arg3) {
+    PyyList pyparams(arg3);
+    params.resize(pyparams.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+      params[i] = PyObj(pyparams[i]).as_double();
+    }
+  }
+  std::vector<Column*> res = expr::reduceops(opcodes, cols, params);
+  PyyList out(n);
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = pycolumn::from_column(res[i], nullptr, 0);
+  }
+  return out.release();
+}
+
+
 PyObject* expr_unaryop(PyObject*, PyObject* args)
 {
   int opcode;
@@ -7,8 +7,10 @@
 //------------------------------------------------------------------------------
 #ifndef dt_EXPR_PY_EXPR_h
 #define dt_EXPR_PY_EXPR_h
+#include <vector>
 #include "py_utils.h"
 #include "column.h"
+#include "rowindex.h"
 
 
 DECLARE_FUNCTION(
@@ -25,15 +27,57 @@ DECLARE_FUNCTION(
 
 DECLARE_FUNCTION(
   expr_column,
-  "expr_column(dt, i, rowindex)\n\n"
+  "expr_column(dt, i, rowindex, reify=True)\n\n"
   "Retrieve column `i` from the DataTable `dt`, replacing its rowindex with\n"
-  "the provided one and then materializing.\n",
+  "the provided one and then materializing. If `reify` is False, then a\n"
+  "numeric column is returned without materializing, i.e. it still refers\n"
+  "to the data of the original column through the rowindex.\n",
+  dt_EXPR_PY_EXPR_CC)
+
+DECLARE_FUNCTION(
+  expr_fused,
+  "expr_fused(kinds, args, cols)\n\n"
+  "Evaluate a tree of unary and binary operators, given as a program in\n"
+  "postfix order. Instruction `i` pushes the column `cols[args[i]]` onto\n"
+  "the stack if `kinds[i]` is 0; applies the unary operator `args[i]` to\n"
+  "the top of the stack if `kinds[i]` is 1; and applies the binary\n"
+  "operator `args[i]` to the two topmost values if `kinds[i]` is 2. The\n"
+  "rows are processed in small chunks, so that none of the intermediate\n"
+  "results is materialized as a column. Returns the resulting column.\n",
+  dt_EXPR_PY_EXPR_CC)
+
+DECLARE_FUNCTION(
+  expr_fused_filter,
+  "expr_fused_filter(kinds, args, cols, nrows, inverse, rowindex)\n\n"
+  "Evaluate a boolean expression given as a program (same as in\n"
+  "`expr_fused()`) over `nrows` rows, and return the RowIndex of the rows\n"
+  "where the expression is true (or, if `inverse` is set, where it is\n"
+  "false or NA). If `rowindex` is not None, then it is applied to the\n"
+  "resulting RowIndex. The result of the expression is never materialized.\n",
+  dt_EXPR_PY_EXPR_CC)
+
+DECLARE_FUNCTION(
+  expr_isin,
+  "expr_isin(col, values)\n\n"
+  "Return the boolean column indicating whether each element of `col` is\n"
+  "present among the elements of the column `values`. An NA element is\n"
+  "considered present iff `values` contains an NA.\n",
   dt_EXPR_PY_EXPR_CC)
 
 DECLARE_FUNCTION(
   expr_reduceop,
-  "expr_reduceop(op, col)\n\n"
-  "Compute a reduction over the provided column.\n",
+  "expr_reduceop(op, col, param=0)\n\n"
+  "Compute a reduction over the provided column. The `param` is used by\n"
+  "the reductions that take an argument, such as the quantile.\n",
+  dt_EXPR_PY_EXPR_CC)
+
+DECLARE_FUNCTION(
+  expr_reduceops,
+  "expr_reduceops(ops, cols, params=None)\n\n"
+  "Compute several reductions at once: reduction `ops[i]` is applied to the\n"
+  "column `cols[i]` (with parameter `params[i]`, if given). All columns must\n"
+  "have the same grouping, and each group is traversed only once. Returns\n"
+  "the list of resulting columns.\n",
   dt_EXPR_PY_EXPR_CC)
 
 DECLARE_FUNCTION(
@@ -46,12 +90,37 @@ DECLARE_FUNCTION(
 
 namespace expr {
 
+// The mapper functions of the unary and binary operators receive in `params`
+// the data pointers of the operand(s), followed by the data pointer of the
+// result (see `mapper_data()`), and process rows in the range `[row0; row1)`.
 typedef void (*mapperfn)(int64_t row0, int64_t row1, void** params);
-typedef void (*gmapperfn)(const int32_t* groups, int32_t grp, void** params);
+typedef void (*gmapperfn)(int64_t row0, int64_t row1, int64_t grp, void** params);
+
+enum OpMode {
+  N_to_N = 1,
+  N_to_One = 2,
+  One_to_N = 3
+};
+
+void map_chunked(mapperfn fn, int64_t nrows, void** params);
+void* mapper_data(Column* col);
+mapperfn unaryop_mapper(int opcode, SType arg_type, SType* res_type);
+mapperfn binaryop_mapper(int opcode, SType lhs_type, SType rhs_type,
+                         OpMode mode, SType* res_type);
 
 Column* unaryop(int opcode, Column* arg);
 Column* binaryop(int opcode, Column* lhs, Column* rhs);
-Column* reduceop(int opcode, Column* arg);
+Column* fused(const std::vector<int>& kinds, const std::vector<int>& args,
+              const std::vector<Column*>& cols);
+RowIndex fused_filter(const std::vector<int>& kinds,
+                      const std::vector<int>& args,
+                      const std::vector<Column*>& cols, int64_t nrows,
+                      bool inverse, const RowIndex& ri);
+Column* isin(Column* col, Column* values);
+Column* reduceop(int opcode, Column* arg, double param = 0.0);
+std::vector<Column*> reduceops(const std::vector<int>& opcodes,
+                               const std::vector<Column*>& args,
+                               const std::vector<double>& params);
 
 };
 
@@ -6,19 +6,29 @@
 // © H2O.ai 2018
 //------------------------------------------------------------------------------
 #include "expr/py_expr.h"
+#include <algorithm>  // std::max, std::min
 #include <cmath>      // std::sqrt
 #include <limits>     // std::numeric_limits<?>::max, ::infinity
+#include <type_traits>  // std::conditional, std::is_integral
+#include <utility>    // std::pair
+#include <vector>     // std::vector
 #include "types.h"
+#include "utils/omp.h"
 
 namespace expr
 {
 
 // Synchronize with expr/consts.py
 enum OpCode {
-  Mean  = 1,
-  Min   = 2,
-  Max   = 3,
-  Stdev = 4,
+  Mean     = 1,
+  Min      = 2,
+  Max      = 3,
+  Stdev    = 4,
+  Sum      = 5,
+  Count    = 6,
+  First    = 7,
+  Last     = 8,
+  Quantile = 9,
 };
 
 template<typename T>
@@ -31,100 +41,470 @@ constexpr T infinity() {
 
 
 //------------------------------------------------------------------------------
-// Mean calculation
+// Reducers
+//
+// Each reducer describes a reduction as an accumulator `State`, together with
+// the functions to add a value into the state, to merge 2 partial states
+// computed over adjacent ranges of rows, and to produce the final result.
+// Merging allows a single large group to be split into chunks that are
+// reduced in parallel.
 //------------------------------------------------------------------------------
 
+// Mean, using the Kahan summation algorithm
 template<typename IT, typename OT>
-static void mean_skipna(const int32_t* groups, int32_t grp, void** params) {
-  IT* inputs = static_cast<IT*>(static_cast<Column*>(params[0])->data());
-  OT* outputs = static_cast<OT*>(static_cast<Column*>(params[1])->data());
-  OT sum = 0;
-  int64_t cnt = 0;
-  OT delta = 0;
-  int32_t row0 = groups[grp];
-  int32_t row1 = groups[grp + 1];
-  for (int32_t i = row0; i < row1; ++i) {
-    IT x = inputs[i];
-    if (ISNA<IT>(x)) continue;
-    OT y = static_cast<OT>(x) - delta;
-    OT t = sum + y;
-    delta = (t - sum) - y;
-    sum = t;
-    cnt++;
-  }
-  outputs[grp] = cnt == 0? GETNA<OT>() : sum / cnt;
-}
+struct MeanSkipNA {
+  using itype = IT;
+  using otype = OT;
+  struct State {
+    OT sum = 0;
+    OT delta = 0;
+    int64_t cnt = 0;
+  };
+
+  static void add(State& s, IT x) {
+    if (ISNA<IT>(x)) return;
+    OT y = static_cast<OT>(x) - s.delta;
+    OT t = s.sum + y;
+    s.delta = (t - s.sum) - y;
+    s.sum = t;
+    s.cnt++;
+  }
 
+  static void merge(State& s, const State& o) {
+    OT y = (o.sum - o.delta) - s.delta;
+    OT t = s.sum + y;
+    s.delta = (t - s.sum) - y;
+    s.sum = t;
+    s.cnt += o.cnt;
+  }
 
+  static OT result(const State& s) {
+    return s.cnt == 0? GETNA<OT>() : s.sum / static_cast<OT>(s.cnt);
+  }
+};
 
-//------------------------------------------------------------------------------
-// Standard deviation
-//------------------------------------------------------------------------------
 
-// Welford algorithm
+// Standard deviation, using Welford's algorithm; partial states are merged
+// with the formula of Chan et al.
 template<typename IT, typename OT>
-static void stdev_skipna(const int32_t* groups, int32_t grp, void** params) {
-  IT* inputs = static_cast<IT*>(static_cast<Column*>(params[0])->data());
-  OT* outputs = static_cast<OT*>(static_cast<Column*>(params[1])->data());
-  OT mean = 0;
-  OT m2 = 0;
-  int64_t cnt = 0;
-  int32_t row0 = groups[grp];
-  int32_t row1 = groups[grp + 1];
-  for (int32_t i = row0; i < row1; ++i) {
-    IT x = inputs[i];
-    if (ISNA<IT>(x)) continue;
-    cnt++;
-    OT t1 = x - mean;
-    mean += t1 / cnt;
-    OT t2 = x - mean;
-    m2 += t1 * t2;
-  }
-  outputs[grp] = cnt <= 1? GETNA<OT>() : std::sqrt(m2 / (cnt - 1));
-}
+struct StdevSkipNA {
+  using itype = IT;
+  using otype = OT;
+  struct State {
+    OT mean = 0;
+    OT m2 = 0;
+    int64_t cnt = 0;
+  };
+
+  static void add(State& s, IT x) {
+    if (ISNA<IT>(x)) return;
+    s.cnt++;
+    OT t1 = static_cast<OT>(x) - s.mean;
+    s.mean += t1 / static_cast<OT>(s.cnt);
+    OT t2 = static_cast<OT>(x) - s.mean;
+    s.m2 += t1 * t2;
+  }
 
+  static void merge(State& s, const State& o) {
+    if (o.cnt == 0) return;
+    if (s.cnt == 0) { s = o; return; }
+    OT n = static_cast<OT>(s.cnt + o.cnt);
+    OT ocnt = static_cast<OT>(o.cnt);
+    OT scnt = static_cast<OT>(s.cnt);
+    OT delta = o.mean - s.mean;
+    s.mean += delta * ocnt / n;
+    s.m2 += o.m2 + delta * delta * scnt * ocnt / n;
+    s.cnt += o.cnt;
+  }
 
+  static OT result(const State& s) {
+    return s.cnt <= 1? GETNA<OT>()
+                     : std::sqrt(s.m2 / static_cast<OT>(s.cnt - 1));
+  }
+};
 
-//------------------------------------------------------------------------------
-// Minimum
-//------------------------------------------------------------------------------
 
+// Minimum of all non-NA values (NA if there are none)
 template<typename T>
-static void min_skipna(const int32_t* groups, int32_t grp, void** params) {
-  T* inputs = static_cast<T*>(static_cast<Column*>(params[0])->data());
-  T* outputs = static_cast<T*>(static_cast<Column*>(params[1])->data());
-  T res = infinity<T>();
-  int32_t row0 = groups[grp];
-  int32_t row1 = groups[grp + 1];
-  for (int32_t i = row0; i < row1; ++i) {
-    T x = inputs[i];
-    if (!ISNA<T>(x) && x < res) {
-      res = x;
-    }
-  }
-  outputs[grp] = res;
-}
+struct MinSkipNA {
+  using itype = T;
+  using otype = T;
+  struct State {
+    T res = infinity<T>();
+    bool isset = false;
+  };
+
+  static void add(State& s, T x) {
+    if (ISNA<T>(x)) return;
+    if (x < s.res) s.res = x;
+    s.isset = true;
+  }
+
+  static void merge(State& s, const State& o) {
+    if (o.res < s.res) s.res = o.res;
+    s.isset |= o.isset;
+  }
+
+  static T result(const State& s) { return s.isset? s.res : GETNA<T>(); }
+};
+
+
+// Maximum of all non-NA values (NA if there are none)
+template<typename T>
+struct MaxSkipNA {
+  using itype = T;
+  using otype = T;
+  struct State {
+    T res = -infinity<T>();
+    bool isset = false;
+  };
+
+  static void add(State& s, T x) {
+    if (ISNA<T>(x)) return;
+    if (x > s.res) s.res = x;
+    s.isset = true;
+  }
+
+  static void merge(State& s, const State& o) {
+    if (o.res > s.res) s.res = o.res;
+    s.isset |= o.isset;
+  }
+
+  static T result(const State& s) { return s.isset? s.res : GETNA<T>(); }
+};
+
+
+
+// Sum of all non-NA values (0 if there are none). Integer values are summed
+// as uint64 (so that an overflow wraps around instead of being undefined),
+// and the result is converted into int64. Floating-point values are summed
+// as doubles.
+template<typename IT, typename OT>
+struct SumSkipNA {
+  using itype = IT;
+  using otype = OT;
+  using AT = typename std::conditional<std::is_integral<OT>::value,
+                                       uint64_t, double>::type;
+  struct State {
+    AT sum = 0;
+  };
+
+  static void add(State& s, IT x) {
+    if (!ISNA<IT>(x)) s.sum += static_cast<AT>(x);
+  }
+
+  static void merge(State& s, const State& o) { s.sum += o.sum; }
+
+  static OT result(const State& s) { return static_cast<OT>(s.sum); }
+};
+
+
+// Number of non-NA values
+template<typename T>
+struct CountNotNA {
+  using itype = T;
+  using otype = int64_t;
+  struct State {
+    int64_t cnt = 0;
+  };
+
+  static void add(State& s, T x) { s.cnt += !ISNA<T>(x); }
+
+  static void merge(State& s, const State& o) { s.cnt += o.cnt; }
+
+  static int64_t result(const State& s) { return s.cnt; }
+};
+
+
+// The first value in a group (even if it is NA)
+template<typename T>
+struct FirstValue {
+  using itype = T;
+  using otype = T;
+  struct State {
+    T val = GETNA<T>();
+    bool isset = false;
+  };
+
+  static void add(State& s, T x) {
+    if (!s.isset) {
+      s.val = x;
+      s.isset = true;
+    }
+  }
+
+  static void merge(State& s, const State& o) {
+    if (!s.isset) s = o;
+  }
+
+  static T result(const State& s) { return s.val; }
+};
+
+
+// The last value in a group (even if it is NA)
+template<typename T>
+struct LastValue {
+  using itype = T;
+  using otype = T;
+  struct State {
+    T val = GETNA<T>();
+    bool isset = false;
+  };
+
+  static void add(State& s, T x) {
+    s.val = x;
+    s.isset = true;
+  }
+
+  static void merge(State& s, const State& o) {
+    if (o.isset) s = o;
+  }
+
+  static T result(const State& s) { return s.val; }
+};
 
 
 
 //------------------------------------------------------------------------------
-// Maximum
+// Parallel driver
 //------------------------------------------------------------------------------
 
-template<typename T>
-static void max_skipna(const int32_t* groups, int32_t grp, void** params) {
-  T* inputs = static_cast<T*>(static_cast<Column*>(params[0])->data());
-  T* outputs = static_cast<T*>(static_cast<Column*>(params[1])->data());
-  T res = -infinity<T>();
-  int32_t row0 = groups[grp];
-  int32_t row1 = groups[grp + 1];
-  for (int32_t i = row0; i < row1; ++i) {
-    T x = inputs[i];
-    if (!ISNA<T>(x) && x > res) {
-      res = x;
-    }
-  }
-  outputs[grp] = res;
+// Groups are reduced in batches of consecutive groups with roughly this many
+// rows in total, and groups larger than `2 * REDUCE_CHUNK` rows are split into
+// chunks of this size, each reduced in parallel. The chunks depend only on the
+// group sizes, so the results do not depend on the number of threads.
+static constexpr int64_t REDUCE_CHUNK = 1 << 16;
+
+
+/**
+ * Reduction of a single column into the output column `res`, one value per
+ * group. Several reductions (possibly over the same column) are processed
+ * together by `reduce_groups()`, within a single traversal of the groups.
+ */
+class GroupReducer {
+  public:
+    virtual ~GroupReducer() {}
+
+    // Reduce rows `[row0, row1)` into the output for group `g`
+    virtual void reduce_group(int64_t row0, int64_t row1, size_t g) = 0;
+
+    // Reduce a large group in `nchunks` chunks, which may be processed in
+    // parallel; then merge the partial results into the output for group `g`
+    virtual void begin_chunks(size_t nchunks) = 0;
+    virtual void reduce_chunk(int64_t row0, int64_t row1, size_t c) = 0;
+    virtual void finish_chunks(size_t g) = 0;
+};
+
+
+// The input column may carry a RowIndex (if it wasn't materialized), in which
+// case its rows are read through that RowIndex. A column with an array
+// RowIndex that is reduced several times is materialized once by
+// `reduceops()`, and all of its reducers read the materialized copy.
+template<typename R>
+class ColumnReducer : public GroupReducer {
+  using IT = typename R::itype;
+  using OT = typename R::otype;
+  using State = typename R::State;
+  const IT* inputs;
+  OT* outputs;
+  RowIndex ri;
+  std::vector<State> partial;
+
+  public:
+    ColumnReducer(const Column* arg, Column* res)
+      : inputs(static_cast<const IT*>(arg->data())),
+        outputs(static_cast<OT*>(res->data())),
+        ri(arg->rowindex()) {}
+
+    void reduce_group(int64_t row0, int64_t row1, size_t g) override {
+      State st;
+      ri.strided_loop(row0, row1, 1,
+        [&](int64_t j) {
+          R::add(st, inputs[j]);
+        });
+      outputs[g] = R::result(st);
+    }
+
+    void begin_chunks(size_t nchunks) override {
+      partial.assign(nchunks, State());
+    }
+
+    void reduce_chunk(int64_t row0, int64_t row1, size_t c) override {
+      State& st = partial[c];
+      ri.strided_loop(row0, row1, 1,
+        [&](int64_t j) {
+          R::add(st, inputs[j]);
+        });
+    }
+
+    void finish_chunks(size_t g) override {
+      State st = partial[0];
+      for (size_t c = 1; c < partial.size(); ++c) {
+        R::merge(st, partial[c]);
+      }
+      outputs[g] = R::result(st);
+    }
+};
+
+
+/**
+ * Quantile `q` of the non-NA values in each group, interpolated linearly
+ * between the closest ranks (i.e. `q = 0.5` gives the median). The values of
+ * each group are copied into a per-thread buffer, where the required ranks
+ * are found with `std::nth_element()`. The ranks are selected among the values
+ * of the input type, so that large int64 values are compared exactly; only
+ * the interpolation is done in floating point.
+ */
+template<typename IT, typename OT>
+class QuantileReducer : public GroupReducer {
+  const IT* inputs;
+  OT* outputs;
+  RowIndex ri;
+  double q;
+  std::vector<std::vector<IT>> buffers;  // one per thread, or per chunk
+
+  public:
+    QuantileReducer(const Column* arg, Column* res, double q_)
+      : inputs(static_cast<const IT*>(arg->data())),
+        outputs(static_cast<OT*>(res->data())),
+        ri(arg->rowindex()),
+        q(q_),
+        buffers(static_cast<size_t>(omp_get_max_threads())) {}
+
+    void reduce_group(int64_t row0, int64_t row1, size_t g) override {
+      std::vector<IT>& buf =
+          buffers[static_cast<size_t>(omp_get_thread_num())];
+      buf.clear();
+      append_values(row0, row1, buf);
+      outputs[g] = quantile(buf);
+    }
+
+    void begin_chunks(size_t nchunks) override {
+      buffers.clear();
+      buffers.resize(nchunks);
+    }
+
+    void reduce_chunk(int64_t row0, int64_t row1, size_t c) override {
+      append_values(row0, row1, buffers[c]);
+    }
+
+    void finish_chunks(size_t g) override {
+      std::vector<IT>& buf = buffers[0];
+      for (size_t c = 1; c < buffers.size(); ++c) {
+        buf.insert(buf.end(), buffers[c].begin(), buffers[c].end());
+        std::vector<IT>().swap(buffers[c]);
+      }
+      outputs[g] = quantile(buf);
+      buffers.clear();
+      buffers.resize(static_cast<size_t>(omp_get_max_threads()));
+    }
+
+  private:
+    void append_values(int64_t row0, int64_t row1,
+                       std::vector<IT>& buf) const {
+      ri.strided_loop(row0, row1, 1,
+        [&](int64_t j) {
+          IT x = inputs[j];
+          if (!ISNA<IT>(x)) buf.push_back(x);
+        });
+    }
+
+    // Difference `b - a` (where `a <= b`), which for integers is computed
+    // exactly before being converted into a double.
+    static double span(IT a, IT b) {
+      return std::is_integral<IT>::value
+             ? static_cast<double>(static_cast<uint64_t>(b) -
+                                   static_cast<uint64_t>(a))
+             : static_cast<double>(b) - static_cast<double>(a);
+    }
+
+    OT quantile(std::vector<IT>& buf) const {
+      size_t n = buf.size();
+      if (n == 0) return GETNA<OT>();
+      double h = q * static_cast<double>(n - 1);
+      size_t lo = static_cast<size_t>(h);
+      if (lo >= n - 1) lo = n - 1;
+      double frac = h - static_cast<double>(lo);
+      std::nth_element(buf.begin(), buf.begin() + static_cast<long>(lo),
+                       buf.end());
+      IT xlo = buf[lo];
+      double res = static_cast<double>(xlo);
+      if (frac > 0 && lo + 1 < n) {
+        IT next = *std::min_element(
+            buf.begin() + static_cast<long>(lo + 1), buf.end());
+        res += frac * span(xlo, next);
+      }
+      return static_cast<OT>(res);
+    }
+};
+
+
+static void reduce_large_group(const std::vector<GroupReducer*>& reducers,
+                               int64_t row0, int64_t row1, size_t g)
+{
+  size_t nchunks = static_cast<size_t>(
+      std::max(int64_t(1), (row1 - row0 + REDUCE_CHUNK - 1) / REDUCE_CHUNK));
+  for (GroupReducer* r : reducers) r->begin_chunks(nchunks);
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < nchunks; ++c) {
+    int64_t i0 = row0 + static_cast<int64_t>(c) * REDUCE_CHUNK;
+    int64_t i1 = std::min(i0 + REDUCE_CHUNK, row1);
+    for (GroupReducer* r : reducers) r->reduce_chunk(i0, i1, c);
+  }
+  for (GroupReducer* r : reducers) r->finish_chunks(g);
+}
+
+
+/**
+ * Apply all `reducers` to each group described by the RowIndex `ri` (or to
+ * the whole range of `nrows` rows, if `ri` has no groups). The rows of each
+ * group are visited by all reducers one after another, while they are still
+ * in cache.
+ */
+static void reduce_groups(const std::vector<GroupReducer*>& reducers,
+                          const RowIndex& ri, int64_t nrows)
+{
+  size_t ngrps = ri.get_ngroups();
+  if (ngrps <= 1) {
+    reduce_large_group(reducers, 0, nrows, 0);
+    return;
+  }
+
+  // Split the groups into batches of consecutive small groups with similar
+  // total number of rows, and the list of large groups.
+  std::vector<std::pair<size_t, size_t>> batches;
+  std::vector<size_t> large;
+  size_t g0 = 0;
+  int64_t batch_start = 0;
+  for (size_t g = 0; g < ngrps; ++g) {
+    int64_t row1 = ri.group_offset(g + 1);
+    if (row1 - ri.group_offset(g) > 2 * REDUCE_CHUNK) {
+      if (g > g0) batches.push_back({g0, g});
+      large.push_back(g);
+      g0 = g + 1;
+      batch_start = row1;
+    } else if (row1 - batch_start >= REDUCE_CHUNK) {
+      batches.push_back({g0, g + 1});
+      g0 = g + 1;
+      batch_start = row1;
+    }
+  }
+  if (ngrps > g0) batches.push_back({g0, ngrps});
+
+  size_t nbatches = batches.size();
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t b = 0; b < nbatches; ++b) {
+    for (size_t g = batches[b].first; g < batches[b].second; ++g) {
+      int64_t row0 = ri.group_offset(g);
+      int64_t row1 = ri.group_offset(g + 1);
+      for (GroupReducer* r : reducers) r->reduce_group(row0, row1, g);
+    }
+  }
+
+  for (size_t g : large) {
+    reduce_large_group(reducers, ri.group_offset(g), ri.group_offset(g + 1),
+                       g);
+  }
 }
 
 
@@ -134,27 +514,60 @@ static void max_skipna(const int32_t* groups, int32_t grp, void** params) {
 //------------------------------------------------------------------------------
 
 template<typename T1, typename T2>
-static gmapperfn resolve1(int opcode) {
+static GroupReducer* resolve1(int opcode, const Column* arg, Column* res,
+                              double param) {
   switch (opcode) {
-    case OpCode::Mean:  return mean_skipna<T1, T2>;
-    case OpCode::Min:   return min_skipna<T1>;
-    case OpCode::Max:   return max_skipna<T1>;
-    case OpCode::Stdev: return stdev_skipna<T1, T2>;
+    case OpCode::Mean:  return new ColumnReducer<MeanSkipNA<T1, T2>>(arg, res);
+    case OpCode::Min:   return new ColumnReducer<MinSkipNA<T1>>(arg, res);
+    case OpCode::Max:   return new ColumnReducer<MaxSkipNA<T1>>(arg, res);
+    case OpCode::Stdev: return new ColumnReducer<StdevSkipNA<T1, T2>>(arg, res);
+    case OpCode::Count: return new ColumnReducer<CountNotNA<T1>>(arg, res);
+    case OpCode::First: return new ColumnReducer<FirstValue<T1>>(arg, res);
+    case OpCode::Last:  return new ColumnReducer<LastValue<T1>>(arg, res);
+    case OpCode::Quantile: {
+      if (!(param >= 0 && param <= 1)) {
+        throw ValueError() << "Quantile must be in the range [0; 1]";
+      }
+      return new QuantileReducer<T1, T2>(arg, res, param);
+    }
+    case OpCode::Sum: {
+      if (std::is_integral<T1>::value) {
+        return new ColumnReducer<SumSkipNA<T1, int64_t>>(arg, res);
+      }
+      return new ColumnReducer<SumSkipNA<T1, T2>>(arg, res);
+    }
     default:            return nullptr;
   }
 }
 
 
-static gmapperfn resolve0(int opcode, SType stype) {
-  switch (stype) {
+static GroupReducer* resolve0(int opcode, const Column* arg, Column* res,
+                              double p) {
+  switch (arg->stype()) {
     case ST_BOOLEAN_I1:
-    case ST_INTEGER_I1:  return resolve1<int8_t, double>(opcode);
-    case ST_INTEGER_I2:  return resolve1<int16_t, double>(opcode);
-    case ST_INTEGER_I4:  return resolve1<int32_t, double>(opcode);
-    case ST_INTEGER_I8:  return resolve1<int64_t, double>(opcode);
-    case ST_REAL_F4:     return resolve1<float, float>(opcode);
-    case ST_REAL_F8:     return resolve1<double, double>(opcode);
-    default:             return nullptr;
+    case ST_INTEGER_I1: return resolve1<int8_t, double>(opcode, arg, res, p);
+    case ST_INTEGER_I2: return resolve1<int16_t, double>(opcode, arg, res, p);
+    case ST_INTEGER_I4: return resolve1<int32_t, double>(opcode, arg, res, p);
+    case ST_INTEGER_I8: return resolve1<int64_t, double>(opcode, arg, res, p);
+    case ST_REAL_F4:    return resolve1<float, float>(opcode, arg, res, p);
+    case ST_REAL_F8:    return resolve1<double, double>(opcode, arg, res, p);
+    default:            return nullptr;
+  }
+}
+
+
+static SType reduceop_stype(int opcode, SType arg_type) {
+  switch (opcode) {
+    case OpCode::Min:
+    case OpCode::Max:
+    case OpCode::First:
+    case OpCode::Last:  return arg_type;
+    case OpCode::Count: return ST_INTEGER_I8;
+    case OpCode::Sum:
+      return arg_type == ST_REAL_F4 || arg_type == ST_REAL_F8
+             ? arg_type : ST_INTEGER_I8;
+    default:
+      return arg_type == ST_REAL_F4 ? arg_type : ST_REAL_F8;
   }
 }
 
@@ -164,32 +577,90 @@ static gmapperfn resolve0(int opcode, SType stype) {
 // External API
 //------------------------------------------------------------------------------
 
-Column* reduceop(int opcode, Column* arg)
-{
-  SType arg_type = arg->stype();
-  SType res_type = opcode == OpCode::Min || opcode == OpCode::Max ||
-                   arg_type == ST_REAL_F4 ? arg_type : ST_REAL_F8;
-  int32_t ngrps = static_cast<int32_t>(arg->rowindex().get_ngroups());
-  if (ngrps == 0) ngrps = 1;
+static void free_gathered(std::vector<Column*>& gathered) {
+  for (size_t i = 0; i < gathered.size(); ++i) {
+    if (!gathered[i]) continue;
+    Column* col = gathered[i];
+    for (size_t k = i; k < gathered.size(); ++k) {
+      if (gathered[k] == col) gathered[k] = nullptr;
+    }
+    delete col;
+  }
+}
 
-  void* params[2];
-  params[0] = arg;
-  params[1] = Column::new_data_column(res_type, ngrps);
 
-  gmapperfn fn = resolve0(opcode, arg_type);
-  if (!fn) {
-    throw RuntimeError()
-      << "Unable to apply reduce function " << opcode
-      << " to column(stype=" << arg_type << ")";
+std::vector<Column*> reduceops(const std::vector<int>& opcodes,
+                               const std::vector<Column*>& args,
+                               const std::vector<double>& params)
+{
+  size_t n = opcodes.size();
+  if (n == 0) return {};
+  // The groups are taken from any argument that carries them: columns
+  // computed from the grouped columns (such as `f.A + 1`) do not have the
+  // groups information, but their rows are in the same order.
+  const Column* grouped = args[0];
+  for (const Column* arg : args) {
+    if (arg->rowindex().get_ngroups()) { grouped = arg; break; }
   }
+  const RowIndex& ri = grouped->rowindex();
+  int64_t nrows = grouped->nrows;
+  int64_t ngrps = static_cast<int64_t>(ri.get_ngroups());
+  if (ngrps == 0) ngrps = 1;
 
-  int32_t _grps[2] = {0, static_cast<int32_t>(arg->nrows)};
-  const int32_t* grps = ngrps == 1? _grps : arg->rowindex().get_groups().data();
-  for (int32_t g = 0; g < ngrps; ++g) {
-    (*fn)(grps, g, params);
+  // Columns with an array RowIndex that are passed to more than one reducer
+  // are gathered only once: `gathered[i]` is the materialized copy of
+  // `args[i]`, shared with all other occurrences of the same column.
+  std::vector<Column*> gathered(n, nullptr);
+  std::vector<Column*> res(n, nullptr);
+  std::vector<GroupReducer*> reducers(n, nullptr);
+  try {
+    for (size_t i = 0; i < n; ++i) {
+      if (gathered[i] || !args[i]->rowindex().isarray()) continue;
+      for (size_t k = i + 1; k < n; ++k) {
+        if (args[k] != args[i]) continue;
+        if (!gathered[i]) {
+          gathered[i] = args[i]->shallowcopy();
+          gathered[i]->reify();
+        }
+        gathered[k] = gathered[i];
+      }
+    }
+    for (size_t i = 0; i < n; ++i) {
+      Column* arg = args[i];
+      SType arg_type = arg->stype();
+      size_t ng = arg->rowindex().get_ngroups();
+      if (arg->nrows != nrows || (ng && ng != ri.get_ngroups())) {
+        throw ValueError() << "Cannot reduce columns with different groupings";
+      }
+      res[i] = Column::new_data_column(reduceop_stype(opcodes[i], arg_type),
+                                       ngrps);
+      double param = i < params.size()? params[i] : 0.0;
+      const Column* src = gathered[i]? gathered[i] : arg;
+      reducers[i] = resolve0(opcodes[i], src, res[i], param);
+      if (!reducers[i]) {
+        throw RuntimeError()
+          << "Unable to apply reduce function " << opcodes[i]
+          << " to column(stype=" << arg_type << ")";
+      }
+    }
+    reduce_groups(reducers, ri, nrows);
+  } catch (...) {
+    for (size_t i = 0; i < n; ++i) {
+      delete reducers[i];
+      delete res[i];
+    }
+    free_gathered(gathered);
+    throw;
   }
+  for (GroupReducer* r : reducers) delete r;
+  free_gathered(gathered);
+  return res;
+}
+
 
-  return static_cast<Column*>(params[1]);
+Column* reduceop(int opcode, Column* arg, double param)
+{
+  return reduceops({opcode}, {arg}, {param})[0];
 }
 
 };  // namespace expr
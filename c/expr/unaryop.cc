@@ -25,18 +25,8 @@ enum OpCode {
 
 template<typename IT, typename OT, OT (*OP)(IT)>
 static void map_n(int64_t row0, int64_t row1, void** params) {
-  IT* arg_data = static_cast<IT*>(static_cast<Column*>(params[0])->data());
-  OT* res_data = static_cast<OT*>(static_cast<Column*>(params[1])->data());
-  for (int64_t i = row0; i < row1; ++i) {
-    res_data[i] = OP(arg_data[i]);
-  }
-}
-
-template<typename IT, typename OT, OT (*OP)(IT)>
-static void strmap_n(int64_t row0, int64_t row1, void** params) {
-  auto scol = static_cast<StringColumn<IT>*>(params[0]);
-  IT* arg_data = scol->offsets();
-  OT* res_data = static_cast<OT*>(static_cast<Column*>(params[1])->data());
+  IT* arg_data = static_cast<IT*>(params[0]);
+  OT* res_data = static_cast<OT*>(params[1]);
   for (int64_t i = row0; i < row1; ++i) {
     res_data[i] = OP(arg_data[i]);
   }
@@ -104,7 +94,7 @@ static mapperfn resolve1(int opcode) {
 template<typename T>
 static mapperfn resolve_str(int opcode) {
   if (opcode == OpCode::IsNa) {
-    return strmap_n<T, int8_t, strop_isna<T>>;
+    return map_n<T, int8_t, strop_isna<T>>;
   }
   return nullptr;
 }
@@ -129,31 +119,53 @@ static mapperfn resolve0(SType stype, int opcode) {
 }
 
 
-Column* unaryop(int opcode, Column* arg)
+mapperfn unaryop_mapper(int opcode, SType arg_type, SType* res_type)
 {
-  if (opcode == OpCode::Plus) return arg->shallowcopy();
-
-  SType arg_type = arg->stype();
-  SType res_type = arg_type;
+  *res_type = arg_type;
   if (opcode == OpCode::IsNa) {
-    res_type = ST_BOOLEAN_I1;
+    *res_type = ST_BOOLEAN_I1;
   } else if (arg_type == ST_BOOLEAN_I1 && opcode == OpCode::Minus) {
-    res_type = ST_INTEGER_I1;
+    *res_type = ST_INTEGER_I1;
   }
-  void* params[2];
-  params[0] = arg;
-  params[1] = Column::new_data_column(res_type, arg->nrows);
+  return resolve0(arg_type, opcode);
+}
 
-  mapperfn fn = resolve0(arg_type, opcode);
+
+// Pointer to the data of the column, as expected by the mapper functions. For
+// string columns these are the offsets of the strings.
+void* mapper_data(Column* col)
+{
+  switch (col->stype()) {
+    case ST_STRING_I4_VCHAR:
+      return static_cast<StringColumn<int32_t>*>(col)->offsets();
+    case ST_STRING_I8_VCHAR:
+      return static_cast<StringColumn<int64_t>*>(col)->offsets();
+    default:
+      return col->data();
+  }
+}
+
+
+Column* unaryop(int opcode, Column* arg)
+{
+  if (opcode == OpCode::Plus) return arg->shallowcopy();
+
+  SType arg_type = arg->stype();
+  SType res_type;
+  mapperfn fn = unaryop_mapper(opcode, arg_type, &res_type);
   if (!fn) {
     throw RuntimeError()
       << "Unable to apply unary op " << opcode << " to column(stype="
       << arg_type << ")";
   }
 
-  (*fn)(0, arg->nrows, params);
+  Column* res = Column::new_data_column(res_type, arg->nrows);
+  void* params[2];
+  params[0] = mapper_data(arg);
+  params[1] = res->data();
+  map_chunked(fn, arg->nrows, params);
 
-  return static_cast<Column*>(params[1]);
+  return res;
 }
 
 
@@ -0,0 +1,447 @@
+//------------------------------------------------------------------------------
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// © H2O.ai 2018
+//------------------------------------------------------------------------------
+//
+// Hash-based grouping
+// ===================
+//
+// This is an alternative to the sort-based grouping (`DataTable::sortby()`
+// with `make_groups = true`), for the cases when only the groups themselves
+// are needed, and not the ordering between them. The algorithm proceeds in
+// 3 steps:
+//
+//   1. Compute a 64-bit hash of the key tuple for every row.
+//
+//   2. Partition the rows by the top bits of their hashes. The partitioning is
+//      done in parallel, over contiguous chunks of rows, and is stable: within
+//      each partition the rows retain their original order. Rows with equal
+//      keys always fall into the same partition.
+//
+//   3. Process each partition independently (and in parallel): insert its
+//      rows into an open-addressing hash table, which maps each distinct key
+//      to a group id, in the order of their first appearance. Then arrange the
+//      rows of the partition by their group ids (counting sort).
+//
+// The result is a RowIndex where the rows of each group are stored
+// contiguously, together with the groups information -- exactly as in the
+// sort-based grouping, except that the groups are not sorted by their keys:
+// instead they are ordered by partition, and within each partition by the
+// first appearance of each key. The order is deterministic, and does not
+// depend on the number of threads.
+//
+//------------------------------------------------------------------------------
+#include "datatable.h"
+#include <algorithm>   // std::max, std::min
+#include <cstdlib>     // std::abs
+#include <cstring>     // std::memcmp
+#include <memory>      // std::unique_ptr
+#include <vector>      // std::vector
+#include "column.h"
+#include "options.h"
+#include "sort.h"
+#include "utils/array.h"
+#include "utils/exceptions.h"
+#include "utils/hash.h"
+#include "utils/omp.h"
+
+
+//==============================================================================
+// Key hashers
+//==============================================================================
+
+/**
+ * Helper class that computes hashes of the values in a single column, and
+ * tests these values for equality. All rows are given as indices within the
+ * Frame, and are translated via the column's RowIndex (if any).
+ *
+ * The concrete hashers are `final`, so that the calls made through a
+ * reference to the concrete class (see `SingleKey`) are not virtual.
+ */
+class KeyHasher {
+  protected:
+    const RowIndex& ri;
+
+  public:
+    explicit KeyHasher(const Column* col) : ri(col->rowindex()) {}
+    virtual ~KeyHasher() {}
+    virtual uint64_t hash(int64_t row) const = 0;
+    virtual bool equal(int64_t row1, int64_t row2) const = 0;
+
+  protected:
+    int64_t physical_row(int64_t row) const {
+      return ri? ri.nth(row) : row;
+    }
+};
+
+
+template <typename T>
+class FwKeyHasher final : public KeyHasher {
+  private:
+    const T* data;
+
+  public:
+    explicit FwKeyHasher(const Column* col)
+      : KeyHasher(col), data(static_cast<const T*>(col->data())) {}
+
+    uint64_t hash(int64_t row) const override {
+      return key_bits<T>(data[physical_row(row)]);
+    }
+
+    bool equal(int64_t row1, int64_t row2) const override {
+      return key_bits<T>(data[physical_row(row1)]) ==
+             key_bits<T>(data[physical_row(row2)]);
+    }
+};
+
+
+template <typename T>
+class StrKeyHasher final : public KeyHasher {
+  private:
+    const uint8_t* strdata;
+    const T* offs;
+
+  public:
+    explicit StrKeyHasher(const Column* col) : KeyHasher(col) {
+      auto scol = static_cast<const StringColumn<T>*>(col);
+      strdata = reinterpret_cast<const uint8_t*>(scol->strdata());
+      offs = scol->offsets();
+    }
+
+    uint64_t hash(int64_t row) const override {
+      int64_t i = physical_row(row);
+      T end = offs[i];
+      if (end < 0) return 0xFFFFFFFFFFFFFFFFULL;  // NA
+      T start = std::abs(offs[i - 1]);
+      return hash_bytes(strdata + start, static_cast<size_t>(end - start));
+    }
+
+    bool equal(int64_t row1, int64_t row2) const override {
+      int64_t i = physical_row(row1);
+      int64_t j = physical_row(row2);
+      T iend = offs[i];
+      T jend = offs[j];
+      if (iend < 0 || jend < 0) return iend < 0 && jend < 0;
+      T istart = std::abs(offs[i - 1]);
+      T jstart = std::abs(offs[j - 1]);
+      if (iend - istart != jend - jstart) return false;
+      return std::memcmp(strdata + istart, strdata + jstart,
+                         static_cast<size_t>(iend - istart)) == 0;
+    }
+};
+
+
+static KeyHasher* make_key_hasher(const Column* col) {
+  switch (col->stype()) {
+    case ST_BOOLEAN_I1:
+    case ST_INTEGER_I1: return new FwKeyHasher<int8_t>(col);
+    case ST_INTEGER_I2: return new FwKeyHasher<int16_t>(col);
+    case ST_INTEGER_I4: return new FwKeyHasher<int32_t>(col);
+    case ST_INTEGER_I8: return new FwKeyHasher<int64_t>(col);
+    case ST_REAL_F4:    return new FwKeyHasher<float>(col);
+    case ST_REAL_F8:    return new FwKeyHasher<double>(col);
+    case ST_STRING_I4_VCHAR: return new StrKeyHasher<int32_t>(col);
+    case ST_STRING_I8_VCHAR: return new StrKeyHasher<int64_t>(col);
+    default:
+      throw TypeError() << "Unable to group by a column of type "
+                        << col->stype();
+  }
+}
+
+
+/**
+ * Hashing and comparison of the key tuples, as used by `hash_groupby_impl`.
+ * `MultiKey` combines any number of key columns via the virtual methods of
+ * `KeyHasher`, whereas `SingleKey<H>` is the fast path for a single key
+ * column, where `H` is the concrete class of its hasher.
+ */
+class MultiKey {
+  private:
+    const std::vector<std::unique_ptr<KeyHasher>>& keys;
+
+  public:
+    explicit MultiKey(const std::vector<std::unique_ptr<KeyHasher>>& k)
+      : keys(k) {}
+
+    uint64_t hash(int64_t row) const {
+      uint64_t h = 0;
+      for (const auto& key : keys) {
+        h = hash_mix(h, key->hash(row));
+      }
+      return h;
+    }
+
+    bool equal(int64_t row1, int64_t row2) const {
+      for (const auto& key : keys) {
+        if (!key->equal(row1, row2)) return false;
+      }
+      return true;
+    }
+};
+
+
+template <typename H>
+class SingleKey {
+  private:
+    const H& key;
+
+  public:
+    explicit SingleKey(const KeyHasher* k) : key(*static_cast<const H*>(k)) {}
+
+    uint64_t hash(int64_t row) const {
+      return hash_mix(0, key.hash(row));
+    }
+
+    bool equal(int64_t row1, int64_t row2) const {
+      return key.equal(row1, row2);
+    }
+};
+
+
+
+
+//==============================================================================
+// Hash grouping
+//==============================================================================
+
+static RowIndex make_rowindex(arr32_t&& arr) {
+  return RowIndex::from_array32(std::move(arr));
+}
+static RowIndex make_rowindex(arr64_t&& arr) {
+  return RowIndex::from_array64(std::move(arr));
+}
+
+
+template <typename TI, typename K>
+static RowIndex hash_groupby_impl(const K& keys, const RowIndex& ri, size_t n)
+{
+  size_t nth = static_cast<size_t>(config::nthreads);
+
+  // Step 1: compute the hashes of all rows
+  dt::array<uint64_t> hashes(n);
+  #pragma omp parallel for schedule(static) num_threads(nth)
+  for (size_t j = 0; j < n; ++j) {
+    hashes[j] = hash_finalize(keys.hash(static_cast<int64_t>(j)));
+  }
+
+  // Step 2: partition the rows by the top `pbits` bits of their hashes.
+  // Each partition should be small enough for its hash table to stay in the
+  // cache, and there should be enough partitions to balance the threads.
+  int pbits = 0;
+  while (pbits < 10 && ((n >> pbits) > (1 << 16) ||
+                        (size_t(1) << pbits) < 4 * nth)) {
+    pbits++;
+  }
+  if (n < 4096) pbits = 0;
+  size_t nparts = size_t(1) << pbits;
+  auto part_of = [&](uint64_t h) -> size_t {
+    return pbits? static_cast<size_t>(h >> (64 - pbits)) : 0;
+  };
+
+  size_t nchunks = std::max(std::min(n / 4096, 4 * nth), size_t(1));
+  size_t chunklen = (n + nchunks - 1) / nchunks;
+  std::vector<size_t> counts(nchunks * nparts, 0);
+  #pragma omp parallel for schedule(static) num_threads(nth)
+  for (size_t c = 0; c < nchunks; ++c) {
+    size_t* cnt = counts.data() + c * nparts;
+    size_t j1 = std::min(n, (c + 1) * chunklen);
+    for (size_t j = c * chunklen; j < j1; ++j) {
+      cnt[part_of(hashes[j])]++;
+    }
+  }
+  std::vector<size_t> partstart(nparts + 1);
+  size_t total = 0;
+  for (size_t p = 0; p < nparts; ++p) {
+    partstart[p] = total;
+    for (size_t c = 0; c < nchunks; ++c) {
+      size_t t = counts[c * nparts + p];
+      counts[c * nparts + p] = total;
+      total += t;
+    }
+  }
+  partstart[nparts] = total;
+
+  dt::array<TI> rows(n);
+  #pragma omp parallel for schedule(static) num_threads(nth)
+  for (size_t c = 0; c < nchunks; ++c) {
+    size_t* cnt = counts.data() + c * nparts;
+    size_t j1 = std::min(n, (c + 1) * chunklen);
+    for (size_t j = c * chunklen; j < j1; ++j) {
+      rows[cnt[part_of(hashes[j])]++] = static_cast<TI>(j);
+    }
+  }
+
+  // Step 3: find the groups within each partition, and arrange the rows of
+  // each partition by group.
+  dt::array<TI> order(n);
+  std::vector<std::vector<TI>> grpsizes(nparts);
+  #pragma omp parallel num_threads(nth)
+  {
+    std::vector<TI> table;   // slot => group id (or -1 if the slot is empty)
+    std::vector<TI> firsts;  // group id => first row of the group
+    std::vector<TI> gids;    // i => group id of row `rows[i0 + i]`
+    std::vector<TI> pos;
+
+    #pragma omp for schedule(dynamic)
+    for (size_t p = 0; p < nparts; ++p) {
+      size_t i0 = partstart[p];
+      size_t m = partstart[p + 1] - i0;
+      if (m == 0) continue;
+      size_t tsize = 16;
+      while (tsize < 2 * m) tsize <<= 1;
+      size_t mask = tsize - 1;
+      table.assign(tsize, -1);
+      firsts.clear();
+      gids.resize(m);
+      std::vector<TI>& sizes = grpsizes[p];
+
+      for (size_t i = 0; i < m; ++i) {
+        TI row = rows[i0 + i];
+        uint64_t h = hashes[static_cast<size_t>(row)];
+        size_t slot = static_cast<size_t>(h) & mask;
+        TI g;
+        while (true) {
+          g = table[slot];
+          if (g < 0) {
+            g = static_cast<TI>(firsts.size());
+            table[slot] = g;
+            firsts.push_back(row);
+            sizes.push_back(1);
+            break;
+          }
+          TI first = firsts[static_cast<size_t>(g)];
+          if (hashes[static_cast<size_t>(first)] == h &&
+              keys.equal(first, row)) {
+            sizes[static_cast<size_t>(g)]++;
+            break;
+          }
+          slot = (slot + 1) & mask;
+        }
+        gids[i] = g;
+      }
+
+      size_t ng = sizes.size();
+      pos.resize(ng);
+      TI cumsize = static_cast<TI>(i0);
+      for (size_t g = 0; g < ng; ++g) {
+        pos[g] = cumsize;
+        cumsize += sizes[g];
+      }
+      for (size_t i = 0; i < m; ++i) {
+        size_t g = static_cast<size_t>(gids[i]);
+        order[static_cast<size_t>(pos[g]++)] = rows[i0 + i];
+      }
+    }
+  }
+
+  // Combine the groups information from all partitions
+  std::vector<size_t> grpstart(nparts + 1);
+  size_t ngroups = 0;
+  for (size_t p = 0; p < nparts; ++p) {
+    grpstart[p] = ngroups;
+    ngroups += grpsizes[p].size();
+  }
+  dt::array<TI> groups(ngroups + 1);
+  groups[0] = 0;
+  #pragma omp parallel for schedule(dynamic) num_threads(nth)
+  for (size_t p = 0; p < nparts; ++p) {
+    TI cumsize = static_cast<TI>(partstart[p]);
+    TI* out = groups.data() + grpstart[p] + 1;
+    for (TI s : grpsizes[p]) {
+      cumsize += s;
+      *out++ = cumsize;
+    }
+  }
+
+  // Translate the rows of the Frame into the rows of the underlying data
+  if (ri) {
+    #pragma omp parallel for schedule(static) num_threads(nth)
+    for (size_t i = 0; i < n; ++i) {
+      order[i] = static_cast<TI>(ri.nth(static_cast<int64_t>(order[i])));
+    }
+  }
+  RowIndex res = make_rowindex(std::move(order));
+  res.set_groups(std::move(groups));
+  return res;
+}
+
+
+template <typename TI, typename H>
+static RowIndex hash_groupby_single(const KeyHasher* key, const RowIndex& ri,
+                                    size_t n)
+{
+  return hash_groupby_impl<TI>(SingleKey<H>(key), ri, n);
+}
+
+
+/**
+ * Choose the hashing of the key tuples for `hash_groupby_impl`: a single key
+ * column is hashed via its concrete hasher class, so that the per-row calls
+ * can be inlined.
+ */
+template <typename TI>
+static RowIndex hash_groupby_keys(
+    const std::vector<std::unique_ptr<KeyHasher>>& keys, const Column* col0,
+    size_t n)
+{
+  const RowIndex& ri = col0->rowindex();
+  if (keys.size() == 1) {
+    const KeyHasher* key = keys[0].get();
+    switch (col0->stype()) {
+      case ST_BOOLEAN_I1:
+      case ST_INTEGER_I1:
+        return hash_groupby_single<TI, FwKeyHasher<int8_t>>(key, ri, n);
+      case ST_INTEGER_I2:
+        return hash_groupby_single<TI, FwKeyHasher<int16_t>>(key, ri, n);
+      case ST_INTEGER_I4:
+        return hash_groupby_single<TI, FwKeyHasher<int32_t>>(key, ri, n);
+      case ST_INTEGER_I8:
+        return hash_groupby_single<TI, FwKeyHasher<int64_t>>(key, ri, n);
+      case ST_REAL_F4:
+        return hash_groupby_single<TI, FwKeyHasher<float>>(key, ri, n);
+      case ST_REAL_F8:
+        return hash_groupby_single<TI, FwKeyHasher<double>>(key, ri, n);
+      case ST_STRING_I4_VCHAR:
+        return hash_groupby_single<TI, StrKeyHasher<int32_t>>(key, ri, n);
+      case ST_STRING_I8_VCHAR:
+        return hash_groupby_single<TI, StrKeyHasher<int64_t>>(key, ri, n);
+      default: break;
+    }
+  }
+  return hash_groupby_impl<TI>(MultiKey(keys), ri, n);
+}
+
+
+/**
+ * Group the rows of the DataTable by the values in the columns `colindices`,
+ * using hashing. Similar to `sortby(colindices, true)`, the returned RowIndex
+ * stores the rows of each group contiguously, and carries the groups
+ * information; however the groups are not sorted by their keys.
+ */
+RowIndex DataTable::hash_groupby(const arr32_t& colindices) const
+{
+  size_t nkeys = colindices.size();
+  if (nkeys == 0) {
+    throw ValueError() << "At least one column is required for grouping";
+  }
+  if (nrows <= 1) {
+    return sortby(colindices, true);
+  }
+  std::vector<std::unique_ptr<KeyHasher>> keys;
+  for (size_t k = 0; k < nkeys; ++k) {
+    int32_t i = colindices[k];
+    if (i < 0 || i >= ncols) {
+      throw ValueError() << "Invalid column index " << i
+                         << " for a datatable with " << ncols << " columns";
+    }
+    keys.emplace_back(make_key_hasher(columns[i]));
+  }
+  const Column* col0 = columns[colindices[0]];
+  size_t n = static_cast<size_t>(nrows);
+  return sort_needs_int64(col0)
+         ? hash_groupby_keys<int64_t>(keys, col0, n)
+         : hash_groupby_keys<int32_t>(keys, col0, n);
+}
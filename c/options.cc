@@ -7,6 +7,7 @@
 //------------------------------------------------------------------------------
 #define dt_OPTIONS_cc
 #include "options.h"
+#include <algorithm>   // std::min
 #include "utils/exceptions.h"
 #include "utils/omp.h"
 #include "utils/pyobj.h"
@@ -23,6 +24,10 @@ size_t sort_max_chunk_length = 1 << 20;
 int8_t sort_max_radix_bits = 16;
 int8_t sort_over_radix_bits = 16;
 int32_t sort_nthreads = 1;
+size_t sort_max_merge_runs = 8;
+size_t sort_max_memory = 0;
+bool sort_force_int64 = false;
+int8_t simd_level = SIMD_NONE;
 
 
 static int32_t normalize_nthreads(int32_t nth) {
@@ -88,6 +93,45 @@ void set_sort_nthreads(int32_t n) {
   sort_nthreads = normalize_nthreads(n);
 }
 
+void set_sort_max_merge_runs(int64_t n) {
+  if (n < 0) n = 0;
+  sort_max_merge_runs = static_cast<size_t>(n);
+}
+
+void set_sort_max_memory(int64_t n) {
+  if (n < 0) n = 0;
+  sort_max_memory = static_cast<size_t>(n);
+}
+
+void set_sort_force_int64(int8_t v) {
+  sort_force_int64 = (v == 1);
+}
+
+
+
+// The widest SIMD instruction set supported by the current CPU (and the OS)
+static int8_t detect_simd_level() {
+  #if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+      return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return SIMD_SSE42;
+  #endif
+  return SIMD_NONE;
+}
+
+void set_simd(const std::string& s) {
+  static const int8_t max_level = detect_simd_level();
+  int8_t level;
+  if (s == "auto" || s == "avx512") level = SIMD_AVX512;
+  else if (s == "avx2") level = SIMD_AVX2;
+  else if (s == "sse4.2") level = SIMD_SSE42;
+  else if (s == "none") level = SIMD_NONE;
+  else throw ValueError() << "Invalid simd parameter: " << s;
+  simd_level = std::min(level, max_level);
+}
+
 
 
 PyObject* set_option(PyObject*, PyObject* args) {
@@ -119,6 +163,18 @@ PyObject* set_option(PyObject*, PyObject* args) {
   } else if (name == "sort.nthreads") {
     set_sort_nthreads(value.as_int32());
 
+  } else if (name == "sort.max_merge_runs") {
+    set_sort_max_merge_runs(value.as_int64());
+
+  } else if (name == "sort.max_memory") {
+    set_sort_max_memory(value.as_int64());
+
+  } else if (name == "sort.force_int64") {
+    set_sort_force_int64(value.as_bool());
+
+  } else if (name == "simd") {
+    set_simd(value.as_string());
+
   } else if (name == "core_logger") {
     set_core_logger(value.as_pyobject());
 
@@ -8,6 +8,7 @@
 #ifndef dt_OPTIONS_h
 #define dt_OPTIONS_h
 #include <Python.h>
+#include <string>
 #include "py_utils.h"
 
 namespace config {
@@ -20,6 +21,10 @@ extern size_t sort_max_chunk_length;
 extern int8_t sort_max_radix_bits;
 extern int8_t sort_over_radix_bits;
 extern int32_t sort_nthreads;
+extern size_t sort_max_merge_runs;
+extern size_t sort_max_memory;
+extern bool sort_force_int64;
+extern int8_t simd_level;
 
 void set_nthreads(int32_t n);
 void set_core_logger(PyObject*);
@@ -29,6 +34,19 @@ void set_sort_max_chunk_length(int64_t n);
 void set_sort_max_radix_bits(int64_t n);
 void set_sort_over_radix_bits(int64_t n);
 void set_sort_nthreads(int32_t n);
+void set_sort_max_merge_runs(int64_t n);
+void set_sort_max_memory(int64_t n);
+void set_sort_force_int64(int8_t v);
+void set_simd(const std::string& s);
+
+// Instruction sets for which the vectorized kernels are compiled, in the order
+// of increasing vector width. `simd_level` is the widest one that may be used.
+enum SimdLevel : int8_t {
+  SIMD_NONE   = 0,
+  SIMD_SSE42  = 1,
+  SIMD_AVX2   = 2,
+  SIMD_AVX512 = 3,
+};
 
 
 DECLARE_FUNCTION(
@@ -18,6 +18,8 @@
 #include "py_rowindex.h"
 #include "py_types.h"
 #include "py_utils.h"
+#include "python/list.h"
+#include "utils/pyobj.h"
 
 namespace pydatatable
 {
@@ -340,14 +342,70 @@ PyObject* cbind(obj* self, PyObject* args) {
 
 PyObject* sort(obj* self, PyObject* args) {
   DataTable* dt = self->ref;
-  int idx = 0;
+  PyObject* arg1 = nullptr;
   int make_groups = 0;
-  if (!PyArg_ParseTuple(args, "i|i:sort", &idx, &make_groups))
+  int na_last = 0;
+  if (!PyArg_ParseTuple(args, "O|ii:sort", &arg1, &make_groups, &na_last))
     return nullptr;
 
-  arr32_t cols(1);
-  cols[0] = idx;
-  RowIndex ri = dt->sortby(cols, make_groups);
+  PyObj pycols(arg1);
+  arr32_t cols;
+  if (pycols.is_list()) {
+    PyyList collist = pycols;
+    cols.resize(collist.size());
+    for (size_t i = 0; i < cols.size(); ++i) {
+      cols[i] = PyObj(collist[i]).as_int32();
+    }
+  } else {
+    cols.resize(1);
+    cols[0] = pycols.as_int32();
+  }
+  RowIndex ri = dt->sortby(cols, make_groups, na_last);
+  return pyrowindex::wrap(ri);
+}
+
+
+PyObject* hash_groupby(obj* self, PyObject* args) {
+  DataTable* dt = self->ref;
+  PyObject* arg1 = nullptr;
+  if (!PyArg_ParseTuple(args, "O:hash_groupby", &arg1)) return nullptr;
+
+  PyObj pycols(arg1);
+  arr32_t cols;
+  if (pycols.is_list()) {
+    PyyList collist = pycols;
+    cols.resize(collist.size());
+    for (size_t i = 0; i < cols.size(); ++i) {
+      cols[i] = PyObj(collist[i]).as_int32();
+    }
+  } else {
+    cols.resize(1);
+    cols[0] = pycols.as_int32();
+  }
+  RowIndex ri = dt->hash_groupby(cols);
+  return pyrowindex::wrap(ri);
+}
+
+
+PyObject* topk(obj* self, PyObject* args) {
+  DataTable* dt = self->ref;
+  int colidx = 0;
+  int64_t k = 0;
+  int make_groups = 0;
+  if (!PyArg_ParseTuple(args, "iL|i:topk", &colidx, &k, &make_groups))
+    return nullptr;
+
+  bool descending = (colidx < 0);
+  if (descending) colidx = ~colidx;
+  if (colidx >= dt->ncols) {
+    throw ValueError() << "Invalid column index " << colidx
+                       << " for a datatable with " << dt->ncols << " columns";
+  }
+  if (k < 0) {
+    throw ValueError() << "Parameter `k` cannot be negative: " << k;
+  }
+  Column* col = dt->columns[colidx];
+  RowIndex ri = col->topk(static_cast<size_t>(k), descending, make_groups);
   return pyrowindex::wrap(ri);
 }
 
@@ -362,6 +420,18 @@ PyObject* get_sum    (obj* self, PyObject*) { return wrap(self->ref->sum_datatab
 PyObject* get_countna(obj* self, PyObject*) { return wrap(self->ref->countna_datatable()); }
 PyObject* get_nunique(obj* self, PyObject*) { return wrap(self->ref->nunique_datatable()); }
 PyObject* get_nmodal (obj* self, PyObject*) { return wrap(self->ref->nmodal_datatable()); }
+PyObject* get_nunique_approx(obj* self, PyObject*) {
+  return wrap(self->ref->nunique_approx_datatable());
+}
+PyObject* get_quantile(obj* self, PyObject* args) {
+  double q;
+  int approx = 0;
+  if (!PyArg_ParseTuple(args, "d|p:get_quantile", &q, &approx)) return nullptr;
+  if (!(q >= 0 && q <= 1)) {
+    throw ValueError() << "Quantile must be in the range [0; 1]";
+  }
+  return wrap(self->ref->quantile_datatable(q, approx));
+}
 
 typedef PyObject* (Column::*scalarstatfn)() const;
 static PyObject* _scalar_stat(DataTable* dt, scalarstatfn f) {
@@ -371,6 +441,20 @@ static PyObject* _scalar_stat(DataTable* dt, scalarstatfn f) {
 
 PyObject* countna1(obj* self, PyObject*) { return _scalar_stat(self->ref, &Column::countna_pyscalar); }
 PyObject* nunique1(obj* self, PyObject*) { return _scalar_stat(self->ref, &Column::nunique_pyscalar); }
+PyObject* nunique_approx1(obj* self, PyObject*) {
+  return _scalar_stat(self->ref, &Column::nunique_approx_pyscalar);
+}
+PyObject* quantile1(obj* self, PyObject* args) {
+  double q;
+  int approx = 0;
+  if (!PyArg_ParseTuple(args, "d|p:quantile1", &q, &approx)) return nullptr;
+  if (!(q >= 0 && q <= 1)) {
+    throw ValueError() << "Quantile must be in the range [0; 1]";
+  }
+  DataTable* dt = self->ref;
+  if (dt->ncols != 1) throw ValueError() << "This method can only be applied to a 1-column Frame";
+  return dt->columns[0]->quantile_pyscalar(q, approx);
+}
 PyObject* nmodal1 (obj* self, PyObject*) { return _scalar_stat(self->ref, &Column::nmodal_pyscalar); }
 PyObject* min1    (obj* self, PyObject*) { return _scalar_stat(self->ref, &Column::min_pyscalar); }
 PyObject* max1    (obj* self, PyObject*) { return _scalar_stat(self->ref, &Column::max_pyscalar); }
@@ -393,7 +477,7 @@ PyObject* materialize(obj* self, PyObject*) {
   for (int64_t i = 0; i < dt->ncols; ++i) {
     cols[i] = dt->columns[i]->shallowcopy();
     if (cols[i] == nullptr) return nullptr;
-    cols[i]->reify();
+    cols[i] = cols[i]->reified();
   }
   cols[dt->ncols] = nullptr;
 
@@ -442,6 +526,8 @@ static PyMethodDef datatable_methods[] = {
   METHODv(rbind),
   METHODv(cbind),
   METHODv(sort),
+  METHODv(hash_groupby),
+  METHODv(topk),
   METHOD0(get_min),
   METHOD0(get_max),
   METHOD0(get_mode),
@@ -451,9 +537,13 @@ static PyMethodDef datatable_methods[] = {
   METHOD0(get_countna),
   METHOD0(get_nunique),
   METHOD0(get_nmodal),
+  METHOD0(get_nunique_approx),
+  METHODv(get_quantile),
   METHOD0(countna1),
   METHOD0(nunique1),
   METHOD0(nmodal1),
+  METHOD0(nunique_approx1),
+  METHODv(quantile1),
   METHOD0(min1),
   METHOD0(max1),
   METHOD0(mode1),
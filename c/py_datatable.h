@@ -147,10 +147,31 @@ DECLARE_METHOD(
 
 DECLARE_METHOD(
   sort,
-  "sort(col, makegroups=False)\n\n"
-  "Sort datatable by the specified column and return the RowIndex object\n"
-  "corresponding to the col's ordering. If `makegroups` is True, then\n"
-  "grouping information will also be computed and stored in the RowIndex.")
+  "sort(cols, makegroups=False, nalast=False)\n\n"
+  "Sort datatable by the specified column (or list of columns) and return\n"
+  "the RowIndex object corresponding to the ordering. When several columns\n"
+  "are given, the rows are sorted by the first column, then ties are broken\n"
+  "by the second, and so on. A negative index `i` means that column `~i`\n"
+  "should be sorted in descending order. If `makegroups` is True, then\n"
+  "grouping information will also be computed and stored in the RowIndex.\n"
+  "If `nalast` is True, then NA values are placed at the end.")
+
+DECLARE_METHOD(
+  hash_groupby,
+  "hash_groupby(cols)\n\n"
+  "Group datatable by the specified column (or list of columns) using a\n"
+  "hash table, and return the RowIndex with the grouping information. The\n"
+  "rows of each group are contiguous within the RowIndex, however unlike\n"
+  "`sort(cols, True)` the groups are not ordered by their keys.")
+
+DECLARE_METHOD(
+  topk,
+  "topk(col, k, makegroups=False)\n\n"
+  "Return the RowIndex of the `k` rows with the smallest values in column\n"
+  "`col`, sorted in ascending order (or the largest values in descending\n"
+  "order, if `col` is negative, in which case column `~col` is used). NA\n"
+  "values are selected last. This is equivalent to the first `k` elements\n"
+  "of the full sort, but is faster since the full ordering is not computed.")
 
 DECLARE_METHOD(
   materialize,
@@ -194,6 +215,17 @@ DECLARE_METHOD(
   get_nunique,
   "Get the number of unique values for each column in the DataTable")
 
+DECLARE_METHOD(
+  get_nunique_approx,
+  "Get the approximate number of unique values for each column in the\n"
+  "DataTable, estimated with a HyperLogLog sketch")
+
+DECLARE_METHOD(
+  get_quantile,
+  "get_quantile(q, approx)\n\n"
+  "Get the quantile `q` for each column in the DataTable. If `approx` is\n"
+  "true, the quantile is estimated from the KLL sketch of the column.")
+
 DECLARE_METHOD(
   get_mode,
   "Get the most frequent value in each column in the DataTable")
@@ -234,6 +266,15 @@ DECLARE_METHOD(
    nunique1,
    "Get the number of unique values in a single-column DataTable")
 
+DECLARE_METHOD(
+   nunique_approx1,
+   "Get the approximate number of unique values in a single-column DataTable")
+
+DECLARE_METHOD(
+   quantile1,
+   "quantile1(q, approx)\n\n"
+   "Get the scalar quantile `q` of a single-column DataTable")
+
 DECLARE_METHOD(
    nmodal1,
    "Get the number of modal values in a single-column DataTable")
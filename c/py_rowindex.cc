@@ -173,10 +173,10 @@ PyObject* get_ngroups(obj* self) {
 PyObject* get_group_sizes(obj* self) {
   size_t ng = self->ref->get_ngroups();
   if (!ng) return none();
-  const arr32_t& groups = self->ref->get_groups();
+  const RowIndex& ri = *self->ref;
   PyyList res(ng);
   for (size_t i = 0; i < ng; ++i) {
-    res[i] = PyLong_FromLongLong(groups[i + 1] - groups[i]);
+    res[i] = PyLong_FromLongLong(ri.group_offset(i + 1) - ri.group_offset(i));
   }
   return res.release();
 }
@@ -184,10 +184,10 @@ PyObject* get_group_sizes(obj* self) {
 PyObject* get_group_offsets(obj* self) {
   size_t ng = self->ref->get_ngroups();
   if (!ng) return none();
-  const arr32_t& groups = self->ref->get_groups();
+  const RowIndex& ri = *self->ref;
   PyyList res(ng + 1);
   for (size_t i = 0; i < ng + 1; ++i) {
-    res[i] = PyLong_FromLongLong(groups[i]);
+    res[i] = PyLong_FromLongLong(ri.group_offset(i));
   }
   return res.release();
 }
@@ -265,6 +265,15 @@ PyObject* uplift(obj* self, PyObject* args) {
 }
 
 
+PyObject* group_firsts(obj* self, PyObject*) {
+  RowIndex& ri = *(self->ref);
+  if (!ri.get_ngroups()) {
+    throw ValueError() << "RowIndex has no groups information";
+  }
+  return wrap(ri.group_firsts());
+}
+
+
 PyObject* inverse(obj* self, PyObject* args) {
   RowIndex& ri = *(self->ref);
   int64_t nrows;
@@ -293,6 +302,7 @@ static PyGetSetDef rowindex_getsetters[] = {
 static PyMethodDef rowindex_methods[] = {
   METHOD0(tolist),
   METHODv(uplift),
+  METHOD0(group_firsts),
   METHODv(inverse),
   {NULL, NULL, 0, NULL}           /* sentinel */
 };
@@ -91,6 +91,12 @@ DECLARE_METHOD(
   "Returns a new RowIndex which is a result of applying this rowindex to the\n"
   "parent rowindex.")
 
+DECLARE_METHOD(
+  group_firsts,
+  "group_firsts()\n\n"
+  "Return a new RowIndex that selects the first row of each group in this\n"
+  "(grouped) rowindex.")
+
 DECLARE_METHOD(
   inverse,
   "inverse(nrows)\n\n"
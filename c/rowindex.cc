@@ -19,13 +19,16 @@
 // copy-constructor, performs shallow copying
 RowIndex::RowIndex(const RowIndex& other) {
   impl = other.impl;
+  nogroups = other.nogroups;
   if (impl) impl->acquire();
 }
 
 // assignment operator, performs shallow copying
 RowIndex& RowIndex::operator=(const RowIndex& other) {
+  if (this == &other) return *this;
   clear(false);
   impl = other.impl;
+  nogroups = other.nogroups;
   if (impl) impl->acquire();
   return *this;
 }
@@ -34,16 +37,31 @@ RowIndex::~RowIndex() {
   if (impl) impl->release();
 }
 
+template <typename T>
+static void copy_groups(dt::array<T>& dest, const dt::array<T>& src) {
+  dest.resize(src.size());
+  if (src) std::memcpy(dest.data(), src.data(), src.size() * sizeof(T));
+}
+
 void RowIndex::clear(bool keep_groups) {
-  if (keep_groups && impl && impl->groups) {
+  if (keep_groups && get_ngroups()) {
     RowIndexImpl* new_impl = new SliceRowIndexImpl(0, impl->length, 1);
-    swap(new_impl->groups, impl->groups);
+    if (impl->refcount == 1) {
+      swap(new_impl->groups32, impl->groups32);
+      swap(new_impl->groups64, impl->groups64);
+    } else {
+      // The groups cannot be stolen from a RowIndex that is shared with
+      // other owners (such as other columns, or the sort cache in Stats)
+      copy_groups(new_impl->groups32, impl->groups32);
+      copy_groups(new_impl->groups64, impl->groups64);
+    }
     impl->release();
     impl = new_impl;
   } else {
     if (impl) impl->release();
     impl = nullptr;
   }
+  nogroups = false;
 }
 
 
@@ -79,14 +97,55 @@ RowIndex RowIndex::from_filterfn64(filterfn64* f, int64_t n, bool sorted) {
 }
 
 
+RowIndex RowIndex::from_filterfn32(const rowfilter32& f, int64_t n,
+                                   bool sorted) {
+  return RowIndex(new ArrayRowIndexImpl(f, n, sorted));
+}
+
+
+RowIndex RowIndex::from_filterfn64(const rowfilter64& f, int64_t n,
+                                   bool sorted) {
+  return RowIndex(new ArrayRowIndexImpl(f, n, sorted));
+}
+
+
 RowIndex RowIndex::from_column(Column* col) {
   return RowIndex(new ArrayRowIndexImpl(col));
 }
 
 
 size_t RowIndex::get_ngroups() const {
-  if (!impl || !impl->groups) return 0;
-  return impl->groups.size() - 1;
+  if (!impl || nogroups) return 0;
+  if (impl->groups32) return impl->groups32.size() - 1;
+  if (impl->groups64) return impl->groups64.size() - 1;
+  return 0;
+}
+
+
+RowIndex RowIndex::without_groups() const {
+  RowIndex res(*this);
+  res.nogroups = true;
+  return res;
+}
+
+
+RowIndex RowIndex::group_firsts() const {
+  size_t ng = get_ngroups();
+  if (max() <= INT32_MAX) {
+    arr32_t res(ng);
+    #pragma omp parallel for schedule(static)
+    for (size_t g = 0; g < ng; ++g) {
+      res[g] = static_cast<int32_t>(nth(group_offset(g)));
+    }
+    return RowIndex::from_array32(std::move(res));
+  } else {
+    arr64_t res(ng);
+    #pragma omp parallel for schedule(static)
+    for (size_t g = 0; g < ng; ++g) {
+      res[g] = nth(group_offset(g));
+    }
+    return RowIndex::from_array64(std::move(res));
+  }
 }
 
 
@@ -119,6 +178,41 @@ arr32_t RowIndex::extract_as_array32() const
 }
 
 
+arr64_t RowIndex::extract_as_array64() const
+{
+  arr64_t res;
+  if (!impl) return res;
+  size_t szlen = static_cast<size_t>(length());
+  res.resize(szlen);
+  switch (impl->type) {
+    case RI_ARR32: {
+      const int32_t* ind32 = indices32();
+      #pragma omp parallel for schedule(static)
+      for (size_t i = 0; i < szlen; ++i) {
+        res[i] = static_cast<int64_t>(ind32[i]);
+      }
+      break;
+    }
+    case RI_ARR64: {
+      std::memcpy(res.data(), indices64(), szlen * sizeof(int64_t));
+      break;
+    }
+    case RI_SLICE: {
+      int64_t start = slice_start();
+      int64_t step = slice_step();
+      #pragma omp parallel for schedule(static)
+      for (size_t i = 0; i < szlen; ++i) {
+        res[i] = start + static_cast<int64_t>(i) * step;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return res;
+}
+
+
 RowIndex RowIndex::uplift(const RowIndex& ri2) const {
   if (isabsent()) return RowIndex(ri2);
   if (ri2.isabsent()) return RowIndex(*this);
@@ -7,7 +7,9 @@
 //------------------------------------------------------------------------------
 #ifndef dt_ROWINDEX_h
 #define dt_ROWINDEX_h
+#include <functional>
 #include "utils/array.h"
+#include "utils/omp.h"
 
 class Column;
 class BoolColumn;
@@ -28,6 +30,11 @@ enum RowIndexType {
 typedef int (filterfn32)(int64_t, int64_t, int32_t*, int32_t*);
 typedef int (filterfn64)(int64_t, int64_t, int64_t*, int32_t*);
 
+// Same as `filterfn32` / `filterfn64`, but may also carry its own state (such
+// as the program evaluating a filter expression, see "expr/fused.cc").
+typedef std::function<void(int64_t, int64_t, int32_t*, int32_t*)> rowfilter32;
+typedef std::function<void(int64_t, int64_t, int64_t*, int32_t*)> rowfilter64;
+
 
 
 //==============================================================================
@@ -41,7 +48,8 @@ class RowIndexImpl {
     int64_t length;
     int64_t min;
     int64_t max;
-    arr32_t groups;
+    arr32_t groups32;
+    arr64_t groups64;
 
     RowIndexImpl()
       : type(RowIndexType::RI_UNKNOWN),
@@ -78,6 +86,8 @@ class ArrayRowIndexImpl : public RowIndexImpl {
                       const arr64_t& steps);
     ArrayRowIndexImpl(filterfn32* f, int64_t n, bool sorted);
     ArrayRowIndexImpl(filterfn64* f, int64_t n, bool sorted);
+    ArrayRowIndexImpl(const rowfilter32& f, int64_t n, bool sorted);
+    ArrayRowIndexImpl(const rowfilter64& f, int64_t n, bool sorted);
     ArrayRowIndexImpl(Column*);
 
     int64_t nth(int64_t i) const override;
@@ -94,6 +104,12 @@ class ArrayRowIndexImpl : public RowIndexImpl {
     // sorted (if they are, computing min/max is much simpler).
     template <typename T> void set_min_max(const dt::array<T>&, bool sorted);
 
+    // Helper for the constructors from a filter function
+    template <typename T>
+    void init_from_filter(
+        const std::function<void(int64_t, int64_t, T*, int32_t*)>& f,
+        dt::array<T>& out, int64_t n);
+
     // Helpers for `ArrayRowIndexImpl(Column*)`
     void init_from_boolean_column(BoolColumn* col);
     void init_from_integer_column(Column* col);
@@ -138,9 +154,12 @@ class SliceRowIndexImpl : public RowIndexImpl {
 class RowIndex {
   private:
     RowIndexImpl* impl;
+    // When true, the groups of `impl` are not visible through this object
+    // (see `without_groups()`).
+    bool nogroups;
 
   public:
-    RowIndex() : impl(nullptr) {}
+    RowIndex() : impl(nullptr), nogroups(false) {}
     RowIndex(const RowIndex&);
     RowIndex& operator=(const RowIndex&);
     ~RowIndex();
@@ -201,12 +220,45 @@ class RowIndex {
      */
     static RowIndex from_filterfn32(filterfn32* f, int64_t n, bool sorted);
     static RowIndex from_filterfn64(filterfn64* f, int64_t n, bool sorted);
+    static RowIndex from_filterfn32(const rowfilter32& f, int64_t n,
+                                    bool sorted);
+    static RowIndex from_filterfn64(const rowfilter64& f, int64_t n,
+                                    bool sorted);
 
     static RowIndex from_column(Column* col);
 
+    /**
+     * Grouping information attached to the RowIndex (usually produced by
+     * sorting). The groups are stored as an array of `ngroups + 1` cumulative
+     * group sizes, either 32-bit or 64-bit depending on the number of rows
+     * being grouped. Use `group_offset(i)` to access the groups when the
+     * width does not matter.
+     */
     size_t get_ngroups() const;
-    const arr32_t& get_groups() const { return impl->groups; }
-    void set_groups(arr32_t&& g) { impl->groups = std::move(g); }
+    bool has_groups64() const { return impl && !nogroups && impl->groups64; }
+    const arr32_t& get_groups32() const { return impl->groups32; }
+    const arr64_t& get_groups64() const { return impl->groups64; }
+    void set_groups(arr32_t&& g) { impl->groups32 = std::move(g); }
+    void set_groups(arr64_t&& g) { impl->groups64 = std::move(g); }
+    int64_t group_offset(size_t i) const {
+      return impl->groups64? impl->groups64[i] : impl->groups32[i];
+    }
+
+    /**
+     * Return a RowIndex selecting the first row of each group, i.e. the row
+     * `nth(group_offset(g))` for every `g < get_ngroups()`. Since all rows
+     * within a group share the same values of the grouping columns, this
+     * RowIndex can be used to extract the group keys.
+     */
+    RowIndex group_firsts() const;
+
+    /**
+     * Return a RowIndex with the same indices as this one, but without the
+     * groups information. The indices are shared, not copied: this is used
+     * for returning the sort ordering cached in a column's Stats to callers
+     * that did not ask for the groups.
+     */
+    RowIndex without_groups() const;
 
     bool operator==(const RowIndex& other) { return impl == other.impl; }
     operator bool() const { return impl != nullptr; }
@@ -228,6 +280,7 @@ class RowIndex {
     int64_t slice_step() const { return impl_asslice()->step; }
 
     arr32_t extract_as_array32() const;
+    arr64_t extract_as_array64() const;
     RowIndex inverse(int64_t nrows) const;
 
     /**
@@ -250,10 +303,19 @@ class RowIndex {
     template<typename F> void strided_loop(
         int64_t istart, int64_t iend, int64_t istep, F f) const;
 
+    /**
+     * Copy the elements selected by this RowIndex from array `src` into array
+     * `dest`, i.e. `dest[i] = src[nth(i)]` for all `i < length()`. The rows
+     * are split into contiguous chunks processed in parallel; for array
+     * RowIndexes the source elements are prefetched a few rows ahead, since
+     * the accesses into `src` are random.
+     */
+    template<typename T> void gather(const T* src, T* dest) const;
+
     bool verify_integrity(IntegrityCheckContext&) const;
 
   private:
-    RowIndex(RowIndexImpl* rii) : impl(rii) {}
+    RowIndex(RowIndexImpl* rii) : impl(rii), nogroups(false) {}
     ArrayRowIndexImpl* impl_asarray() const {
       return static_cast<ArrayRowIndexImpl*>(impl);
     }
@@ -305,4 +367,41 @@ void RowIndex::strided_loop(
 }
 
 
+template<typename T>
+void RowIndex::gather(const T* src, T* dest) const {
+  constexpr int64_t PREFETCH = 16;
+  int64_t n = length();
+  switch (impl? impl->type : RowIndexType::RI_UNKNOWN) {
+    case RI_UNKNOWN: break;
+    case RI_ARR32: {
+      const int32_t* ridata = indices32();
+      #pragma omp parallel for schedule(static)
+      for (int64_t i = 0; i < n; ++i) {
+        if (i + PREFETCH < n) __builtin_prefetch(src + ridata[i + PREFETCH]);
+        dest[i] = src[ridata[i]];
+      }
+      break;
+    }
+    case RI_ARR64: {
+      const int64_t* ridata = indices64();
+      #pragma omp parallel for schedule(static)
+      for (int64_t i = 0; i < n; ++i) {
+        if (i + PREFETCH < n) __builtin_prefetch(src + ridata[i + PREFETCH]);
+        dest[i] = src[ridata[i]];
+      }
+      break;
+    }
+    case RI_SLICE: {
+      int64_t start = slice_start();
+      int64_t step = slice_step();
+      #pragma omp parallel for schedule(static)
+      for (int64_t i = 0; i < n; ++i) {
+        dest[i] = src[start + i * step];
+      }
+      break;
+    }
+  }
+}
+
+
 #endif
@@ -119,9 +119,42 @@ ArrayRowIndexImpl::ArrayRowIndexImpl(Column* col) {
 }
 
 
-ArrayRowIndexImpl::ArrayRowIndexImpl(filterfn32* ff, int64_t n, bool sorted) {
+ArrayRowIndexImpl::ArrayRowIndexImpl(filterfn32* ff, int64_t n, bool sorted)
+  : ArrayRowIndexImpl(
+      rowfilter32([=](int64_t row0, int64_t row1, int32_t* out, int32_t* nouts) {
+        (*ff)(row0, row1, out, nouts);
+      }), n, sorted) {}
+
+
+ArrayRowIndexImpl::ArrayRowIndexImpl(filterfn64* ff, int64_t n, bool sorted)
+  : ArrayRowIndexImpl(
+      rowfilter64([=](int64_t row0, int64_t row1, int64_t* out, int32_t* nouts) {
+        (*ff)(row0, row1, out, nouts);
+      }), n, sorted) {}
+
+
+ArrayRowIndexImpl::ArrayRowIndexImpl(const rowfilter32& ff, int64_t n,
+                                     bool sorted) {
   xassert(n <= std::numeric_limits<int32_t>::max());
+  init_from_filter(ff, ind32, n);
+  type = RowIndexType::RI_ARR32;
+  set_min_max(ind32, sorted);
+}
+
+
+ArrayRowIndexImpl::ArrayRowIndexImpl(const rowfilter64& ff, int64_t n,
+                                     bool sorted) {
+  init_from_filter(ff, ind64, n);
+  type = RowIndexType::RI_ARR64;
+  set_min_max(ind64, sorted);
+}
+
 
+template <typename T>
+void ArrayRowIndexImpl::init_from_filter(
+    const std::function<void(int64_t, int64_t, T*, int32_t*)>& ff,
+    dt::array<T>& out, int64_t n)
+{
   // Output buffer, where we will write the indices of selected rows. This
   // buffer is preallocated to the length of the original dataset, and it will
   // be re-alloced to the proper length in the end. The reason we don't want
@@ -129,7 +162,7 @@ ArrayRowIndexImpl::ArrayRowIndexImpl(filterfn32* ff, int64_t n, bool sorted) {
   // least some of the reallocs will have to memmove the data, and moreover
   // the realloc has to occur within a critical section, slowing down the
   // team of threads).
-  ind32.resize(static_cast<size_t>(n));
+  out.resize(static_cast<size_t>(n));
 
   // Number of elements that were written (or tentatively written) so far
   // into the array `out`.
@@ -147,7 +180,7 @@ ArrayRowIndexImpl::ArrayRowIndexImpl(filterfn32* ff, int64_t n, bool sorted) {
   {
     // Intermediate buffer where each thread stores the row numbers it found
     // before they are consolidated into the final output buffer.
-    arr32_t buf(zrows_per_chunk);
+    dt::array<T> buf(zrows_per_chunk);
 
     // Number of elements that are currently being held in `buf`.
     int32_t buf_length = 0;
@@ -171,78 +204,34 @@ ArrayRowIndexImpl::ArrayRowIndexImpl(filterfn32* ff, int64_t n, bool sorted) {
         // section -- however due to a bug in libgOMP the "ordered"
         // section must come last in the loop. So in order to circumvent
         // the bug, this block had to be moved to the front of the loop.
-        size_t bufsize = static_cast<size_t>(buf_length) * sizeof(int32_t);
-        std::memcpy(ind32.data() + out_offset, buf.data(), bufsize);
+        size_t bufsize = static_cast<size_t>(buf_length) * sizeof(T);
+        std::memcpy(out.data() + out_offset, buf.data(), bufsize);
         buf_length = 0;
       }
 
       int64_t row0 = i * rows_per_chunk;
       int64_t row1 = std::min(row0 + rows_per_chunk, n);
-      (*ff)(row0, row1, buf.data(), &buf_length);
+      ff(row0, row1, buf.data(), &buf_length);
 
       #pragma omp ordered
       {
         out_offset = out_length;
-        out_length += (size_t) buf_length;
+        out_length += static_cast<size_t>(buf_length);
       }
     }
     // Note: if the underlying array is small, then some threads may have
     // done nothing at all, and their buffers would be empty.
     if (buf_length) {
-      size_t bufsize = static_cast<size_t>(buf_length) * sizeof(int32_t);
-      std::memcpy(ind32.data() + out_offset, buf.data(), bufsize);
+      size_t bufsize = static_cast<size_t>(buf_length) * sizeof(T);
+      std::memcpy(out.data() + out_offset, buf.data(), bufsize);
       buf_length = 0;
     }
   }
 
   // In the end we shrink the output buffer to the size corresponding to the
   // actual number of elements written.
-  ind32.resize(out_length);
+  out.resize(out_length);
   length = static_cast<int64_t>(out_length);
-  type = RowIndexType::RI_ARR32;
-  set_min_max(ind32, sorted);
-}
-
-
-ArrayRowIndexImpl::ArrayRowIndexImpl(filterfn64* ff, int64_t n, bool sorted) {
-  size_t out_length = 0;
-  int64_t rows_per_chunk = 65536;
-  int64_t num_chunks = (n + rows_per_chunk - 1) / rows_per_chunk;
-  size_t zrows_per_chunk = static_cast<size_t>(rows_per_chunk);
-
-  ind64.resize(static_cast<size_t>(n));
-  #pragma omp parallel
-  {
-    arr64_t buf(zrows_per_chunk);
-    int32_t buf_length = 0;
-    size_t out_offset = 0;
-
-    #pragma omp for ordered schedule(dynamic, 1)
-    for (int64_t i = 0; i < num_chunks; ++i) {
-      if (buf_length) {
-        size_t bufsize = static_cast<size_t>(buf_length) * sizeof(int64_t);
-        std::memcpy(ind64.data() + out_offset, buf.data(), bufsize);
-        buf_length = 0;
-      }
-      int64_t row0 = i * rows_per_chunk;
-      int64_t row1 = std::min(row0 + rows_per_chunk, n);
-      (*ff)(row0, row1, buf.data(), &buf_length);
-      #pragma omp ordered
-      {
-        out_offset = out_length;
-        out_length += static_cast<size_t>(buf_length);
-      }
-    }
-    if (buf_length) {
-      size_t bufsize = static_cast<size_t>(buf_length) * sizeof(int64_t);
-      memcpy(ind64.data() + out_offset, buf.data(), bufsize);
-      buf_length = 0;
-    }
-  }
-  ind64.resize(out_length);
-  length = static_cast<int64_t>(out_length);
-  type = RowIndexType::RI_ARR64;
-  set_min_max(ind64, sorted);
 }
 
 
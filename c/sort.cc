@@ -16,7 +16,9 @@
 // array
 //     [x[o[i]] for i in range(n)]
 // is sorted in ascending order. The sorting is stable, and will gather all NA
-// values in `x` (if any) at the beginning of the sorted list.
+// values in `x` (if any) at the beginning of the sorted list. Descending order
+// and placing NAs at the end are also supported: both are implemented as part
+// of the data preparation step, so they incur no additional cost.
 //
 // See also:
 //      https://en.wikipedia.org/wiki/Radix_sort
@@ -107,21 +109,38 @@
 // buffer, which are then merged into the main group stack.
 //
 //
+// External sort
+// =============
+//
+// When the memory needed for sorting exceeds `config::sort_max_memory`, the
+// rows are split into runs small enough to fit into that budget. Each run is
+// sorted with the radix sort above, and its ordering is spilled into a
+// temporary memory-mapped file. The runs are then merged (k-way, in parallel
+// over the ranges of the output delimited by splitters) into the final
+// ordering. See `sortby_external()`.
+//
+//
 //------------------------------------------------------------------------------
 #include "sort.h"
 #include <algorithm>  // std::min
-#include <cstdlib>    // std::abs
+#include <cstdlib>    // std::abs, std::getenv, mkstemp
 #include <cstring>    // std::memset, std::memcpy
+#include <memory>     // std::unique_ptr
+#include <string>     // std::string
 #include <vector>     // std::vector
+#include <unistd.h>   // access, close
 #include "column.h"
 #include "datatable.h"
+#include "memorybuf.h"
 #include "options.h"
 #include "rowindex.h"
 #include "types.h"
 #include "utils.h"
 #include "utils/array.h"
 #include "utils/assert.h"
+#include "utils/file.h"
 #include "utils/omp.h"
+#include "writebuf.h"
 
 
 /**
@@ -144,6 +163,9 @@
  *   Current ordering (row indices) of elements in `x`. This is an array of size
  *   `n` (same as `x`). If present, then this array will be sorted according
  *   to the values `x`. If nullptr, then it will be treated as if `o[j] == j`.
+ *   The type of the elements of `o` (as well as of `next_o` and the groups
+ *   array) is `TI`, the template parameter of the class: `int32_t` for frames
+ *   with less than 2**31 rows, or `int64_t` otherwise.
  *
  * n
  *   Number of elements in arrays `x` and `o`.
@@ -153,20 +175,33 @@
  *
  * strdata, stroffs
  *   For string columns only, these are pointers `col->strdata()` and
- *   `col->offsets()` respectively.
+ *   `col->offsets()` respectively. The offsets are either `int32_t` or
+ *   `int64_t`, as indicated by the flag `stroffs64`.
  *
  * strstart
  *   For string columns only, this is the position within the string that is
  *   currently being tested. More specifically, at the beginning of a
  *   radix_sort() call, `strstart` will indicate the offset within each string
  *   starting from each we need to sort. The assertion being that all prefixes
- *   before position `strstart` are already properly sorted.
+ *   before position `strstart` are already properly sorted. The keys in `x`
+ *   hold up to 8 bytes of each string starting from this position (see
+ *   `_fill_strkeys()`).
+ *
+ * strlong
+ *   For string columns only, this flag indicates that some of the strings
+ *   extend past the 8-byte window `[strstart; strstart + 8)` whose keys are
+ *   currently stored in `x`. When the keys are exhausted, the ranges of
+ *   strings with equal keys will then be sorted further starting from
+ *   position `strstart + 8`.
  *
  * nsigbits
  *   Number of significant bits in the elements of `x`. This cannot exceed
  *   `8 * elemsize`, but could be less. This value is an assertion that all
  *   elements in `x` are in the range `[0; 2**nsigbits)`. The number of
- *   significant bits cannot be 0.
+ *   significant bits cannot be 0. The only exception are string keys, whose
+ *   bits above `nsigbits` may be non-zero but are the same for all elements
+ *   (see `_trim_common_bits()`); these bits are ignored when computing the
+ *   radixes.
  *
  * shift
  *   The parameter of linear transform to be applied to each item in `x` to
@@ -218,20 +253,29 @@
  * next_elemsize
  *   Size in bytes of each element in `next_x`. This cannot be greater than
  *   `elemsize`, however `next_elemsize` can be 0.
+ *
+ * descending
+ *   If true, the column currently being sorted is ordered in descending
+ *   order. This flag is applied when preparing the sorting keys `x`.
+ *
+ * nalast
+ *   If true, NA values are placed at the end of the sorted sequence instead
+ *   of the beginning. This setting applies to all columns being sorted.
  */
+template <typename TI>
 class SortContext {
   private:
-    arr32_t order;
-    arr32_t groups;
+    dt::array<TI> order;
+    dt::array<TI> groups;
 
     void* x;
     void* next_x;
-    int32_t* o;
-    int32_t* next_o;
+    TI* o;
+    TI* next_o;
     size_t*  histogram;
-    GroupGatherer gg;
+    GroupGatherer<TI> gg;
     const uint8_t* strdata;
-    const int32_t* stroffs;
+    const void* stroffs;
     size_t strstart;
     size_t n;
     size_t nth;
@@ -244,42 +288,59 @@ class SortContext {
     int8_t nsigbits;
     int8_t shift;
     bool use_order;
-    int : 24;
+    bool stroffs64;
+    bool strlong;
+    bool descending;
+    bool nalast;
 
   public:
-  SortContext(const Column* col, bool make_groups) {
+  /**
+   * Construct SortContext for sorting column `col`. Flag `strkeys` may be
+   * set to false when the column will be sorted with `do_merge_runs()` or
+   * `do_reverse()` only: these compare the strings directly, and so for a
+   * string column the radix keys need not be computed.
+   */
+  SortContext(const Column* col, bool desc, bool na_last, bool make_groups,
+              bool strkeys = true) {
+    n = static_cast<size_t>(col->nrows);
+    _extract_order(col->rowindex(), order);
+    _init(col, desc, na_last, make_groups, strkeys);
+  }
+
+  /**
+   * Construct SortContext for sorting only a subset of rows of column `col`.
+   * Array `rows` contains indices of these rows within the column's data
+   * buffer (i.e. indices already mapped through the column's RowIndex). Ties
+   * are resolved according to the order of elements in `rows`.
+   */
+  SortContext(const Column* col, dt::array<TI>&& rows, bool desc,
+              bool na_last, bool make_groups) {
+    n = rows.size();
+    order = std::move(rows);
+    _init(col, desc, na_last, make_groups);
+  }
+
+  void _init(const Column* col, bool desc, bool na_last, bool make_groups,
+             bool strkeys = true) {
+    x = nullptr;
     next_x = nullptr;
     next_o = nullptr;
     histogram = nullptr;
     strdata = nullptr;
+    stroffs64 = false;
+    strlong = false;
     histogram_size = 0;
 
     nth = static_cast<size_t>(config::sort_nthreads);
-    n = static_cast<size_t>(col->nrows);
-    order = (col->rowindex()).extract_as_array32();
     use_order = (bool) order;
-    if (!use_order) order.resize(n);
     o = order.data();
     if (make_groups) {
       groups.resize(n + 1);
       groups[0] = 0;
       gg.init(groups.data() + 1, 0);
     }
-    // These will initialize `x`, `elemsize` and `nsigbits`, and also
-    // `strdata`, `stroffs`, `strstart` for string columns
-    SType stype = col->stype();
-    switch (stype) {
-      case ST_BOOLEAN_I1: _initB(col); break;
-      case ST_INTEGER_I1: _initI<int8_t,  uint8_t>(col); break;
-      case ST_INTEGER_I2: _initI<int16_t, uint16_t>(col); break;
-      case ST_INTEGER_I4: _initI<int32_t, uint32_t>(col); break;
-      case ST_INTEGER_I8: _initI<int64_t, uint64_t>(col); break;
-      case ST_REAL_F4:    _initF<uint32_t>(col); break;
-      case ST_REAL_F8:    _initF<uint64_t>(col); break;
-      case ST_STRING_I4_VCHAR: _initS<int32_t>(col); break;
-      default:
-        throw NotImplError() << "Unable to sort Column of stype " << stype;
-    }
+    nalast = na_last;
+    _prepare_data_for_column(col, desc, strkeys);
   }
 
   SortContext(const SortContext&) = delete;
@@ -295,6 +356,11 @@ class SortContext {
 
 
   void do_sort() {
+    if (!use_order) {
+      // The ordering array will receive the result of the sort
+      order.resize(n);
+      o = order.data();
+    }
     if (n <= config::sort_insert_method_threshold) {
       if (use_order) {
         kinsert_sort();
@@ -307,8 +373,426 @@ class SortContext {
   }
 
 
+  /**
+   * Sort the data that consists of only a few ascending runs (see the
+   * `NRuns` stat), by finding these runs and then merging them pairwise. The
+   * merging is stable, and thus produces the same result as `do_sort()`. If
+   * the data is already sorted, then the ordering is the identity, and the
+   * only remaining work is to find the groups.
+   *
+   * `runstarts`, if given, are the positions where the second and subsequent
+   * runs begin, as recorded by the `NRuns` stat; otherwise the data is
+   * scanned to find them.
+   */
+  void do_merge_runs(const std::vector<int64_t>* runstarts = nullptr) {
+    if (strdata) {
+      if (stroffs64) _merge_runs(_str_less<int64_t>(), runstarts);
+      else           _merge_runs(_str_less<int32_t>(), runstarts);
+    } else {
+      switch (elemsize) {
+        case 1: _merge_runs(_key_less<uint8_t>(), runstarts); break;
+        case 2: _merge_runs(_key_less<uint16_t>(), runstarts); break;
+        case 4: _merge_runs(_key_less<uint32_t>(), runstarts); break;
+        case 8: _merge_runs(_key_less<uint64_t>(), runstarts); break;
+      }
+    }
+  }
+
+  /**
+   * Sort the data whose values are strictly decreasing: the ordering is
+   * simply the reverse of the current order, and each group is of size 1.
+   */
+  void do_reverse() {
+    dt::array<TI> res(n);
+    TI* r = res.data();
+    #pragma omp parallel for schedule(static) num_threads(nth)
+    for (size_t j = 0; j < n; ++j) {
+      size_t k = n - 1 - j;
+      r[j] = use_order? o[k] : static_cast<TI>(k);
+    }
+    order = std::move(res);
+    o = order.data();
+    if (groups) gg.push_distinct(n);
+  }
+
+  // Comparators of the elements at positions `a` and `b` in `x`
+  template <typename T>
+  struct KeyLess {
+    const T* xi;
+    bool operator()(TI a, TI b) const { return xi[a] < xi[b]; }
+  };
+
+  template <typename T>
+  struct StrLess {
+    const uint8_t* strdata;
+    const T* offs;
+    const TI* o;  // nullptr if `use_order` is false
+    bool descending;
+    bool nalast;
+    bool operator()(TI a, TI b) const {
+      TI ra = o? o[a] : a;
+      TI rb = o? o[b] : b;
+      T aend = offs[ra];
+      T bend = offs[rb];
+      int cmp = compare_offstrings<T>(strdata, std::abs(offs[ra - 1]), aend,
+                                      std::abs(offs[rb - 1]), bend);
+      if (aend < 0 || bend < 0) return (nalast? -cmp : cmp) > 0;
+      return (descending? -cmp : cmp) > 0;
+    }
+  };
+
+  template <typename T>
+  KeyLess<T> _key_less() const {
+    return KeyLess<T> {static_cast<const T*>(x)};
+  }
+
+  template <typename T>
+  StrLess<T> _str_less() const {
+    return StrLess<T> {strdata, static_cast<const T*>(stroffs),
+                       use_order? o : nullptr, descending, nalast};
+  }
+
+  /**
+   * Find all positions `j` in `[1; n)` for which `isbreak(j)` is true (i.e.
+   * where a new run or a new group starts). The range is split into one
+   * contiguous chunk per thread, and the positions are returned by chunk.
+   * Since `isbreak(j)` compares elements `j - 1` and `j`, the boundaries
+   * between chunks need no special treatment: concatenating the chunks gives
+   * all positions in increasing order.
+   */
+  template <typename F>
+  std::vector<std::vector<TI>> _find_breaks(F isbreak) const {
+    size_t nchunks_ = std::min(nth, std::max(n / 1024, size_t(1)));
+    std::vector<std::vector<TI>> breaks(nchunks_);
+    #pragma omp parallel for schedule(static, 1) num_threads(nth)
+    for (size_t i = 0; i < nchunks_; ++i) {
+      size_t j0 = std::max(i * n / nchunks_, size_t(1));
+      size_t j1 = (i + 1) * n / nchunks_;
+      for (size_t j = j0; j < j1; ++j) {
+        if (isbreak(j)) breaks[i].push_back(static_cast<TI>(j));
+      }
+    }
+    return breaks;
+  }
+
+  template <typename F>
+  void _merge_runs(F less, const std::vector<int64_t>* runstarts) {
+    std::vector<size_t> runs {0};
+    if (runstarts) {
+      runs.reserve(runstarts->size() + 2);
+      for (int64_t j : *runstarts) runs.push_back(static_cast<size_t>(j));
+    } else {
+      auto runbreaks = _find_breaks([&](size_t j) {
+        return less(static_cast<TI>(j), static_cast<TI>(j - 1));
+      });
+      for (const std::vector<TI>& chunk : runbreaks) {
+        for (TI j : chunk) runs.push_back(static_cast<size_t>(j));
+      }
+    }
+    runs.push_back(n);
+
+    dt::array<TI> pos1(n);
+    dt::array<TI> pos2(runs.size() > 2? n : 0);
+    TI* pa = pos1.data();
+    TI* pb = pos2.data();
+    #pragma omp parallel for schedule(static) num_threads(nth)
+    for (size_t j = 0; j < n; ++j) pa[j] = static_cast<TI>(j);
+    while (runs.size() > 2) {
+      size_t nr = runs.size() - 1;
+      #pragma omp parallel for schedule(dynamic) num_threads(nth)
+      for (size_t r = 0; r < nr; r += 2) {
+        size_t i0 = runs[r];
+        size_t i1 = runs[r + 1];
+        size_t i2 = r + 2 <= nr? runs[r + 2] : i1;
+        std::merge(pa + i0, pa + i1, pa + i1, pa + i2, pb + i0, less);
+      }
+      std::vector<size_t> newruns;
+      for (size_t r = 0; r < nr; r += 2) newruns.push_back(runs[r]);
+      newruns.push_back(n);
+      runs.swap(newruns);
+      std::swap(pa, pb);
+    }
+
+    if (groups) {
+      gg.from_breaks(_find_breaks([&](size_t j) {
+        return less(pa[j - 1], pa[j]);
+      }), n);
+    }
+    if (use_order) {
+      // Map positions into the row indices; `pb` is no longer needed and can
+      // be reused for the output.
+      dt::array<TI>& res = (pa == pos1.data())? pos2 : pos1;
+      res.resize(n);
+      TI* r = res.data();
+      #pragma omp parallel for schedule(static) num_threads(nth)
+      for (size_t j = 0; j < n; ++j) r[j] = o[pa[j]];
+      order = std::move(res);
+    } else {
+      order = std::move(pa == pos1.data()? pos1 : pos2);
+    }
+    o = order.data();
+  }
+
+
+  /**
+   * Refine the ordering produced by the previous call to `do_sort()` (or
+   * `continue_sort()`) using the values from column `col`. The groups
+   * computed during the previous pass are treated as the radix ranges that
+   * still have to be sorted: elements within each group are reordered
+   * according to the values in `col`, while the groups themselves stay in
+   * place. Thus calling `do_sort()` with column A, and then
+   * `continue_sort()` with column B yields the ordering by (A, B).
+   *
+   * The previous pass must have been done with `make_groups = true`. The
+   * flag `make_groups` here determines whether groups should be computed for
+   * the combined key (which is needed if another column is to follow). Flag
+   * `desc` selects the sorting direction for column `col`.
+   */
+  void continue_sort(const Column* col, bool desc, bool make_groups) {
+    xassert(groups);
+    size_t ngrps = static_cast<size_t>(gg.size());
+    if (ngrps == n) {
+      // All values of the current key are already distinct, so additional
+      // columns cannot change the ordering.
+      if (!make_groups) groups.resize(0);
+      return;
+    }
+    // At this point `o` holds row indices in the order of the previous key
+    use_order = true;
+    _prepare_data_for_column(col, desc);
+    if (!next_o) next_o = new TI[n];
+    std::free(next_x);
+    size_t zelemsize = static_cast<size_t>(elemsize);
+    next_x = std::malloc(n * zelemsize);
+    if (!next_x) {
+      throw MemoryError() << "Unable to allocate " << n * zelemsize << " bytes";
+    }
+
+    const TI* grps = groups.data();
+    radix_range* rrmap = new radix_range[ngrps];
+    for (size_t i = 0; i < ngrps; ++i) {
+      size_t start = static_cast<size_t>(grps[i]);
+      size_t end = static_cast<size_t>(grps[i + 1]);
+      rrmap[i].size = end - start;
+      rrmap[i].offset = start;
+    }
+    if (make_groups) {
+      gg.init(groups.data() + 1, 0);
+      _radix_recurse<true>(rrmap, ngrps);
+    } else {
+      groups.resize(0);
+      _radix_recurse<false>(rrmap, ngrps);
+    }
+    delete[] rrmap;
+  }
+
+
+  /**
+   * Find the `k` smallest keys in `x` (where `k <= n`) using the radix select
+   * algorithm, and return the indices of the rows that hold them. The rows
+   * are returned in the same order as they appear in `o`, and the ties at the
+   * boundary are resolved in favor of the rows that come first. Thus sorting
+   * the returned rows gives the same result as taking the first `k` elements
+   * of the full (stable) sort.
+   *
+   * At each step we build the histogram of the radixes, and find the radix
+   * `b` that contains the k-th smallest key. All elements with radixes less
+   * than `b` are selected into the result. Elements with radix `b` are
+   * collected (together with the remaining bits of their keys), and the
+   * selection proceeds among them only. Thus each step is a single pass over
+   * an ever smaller subset of the data, and no full ordering is ever built.
+   *
+   * This method consumes the data in `x`, after that the SortContext
+   * can no longer be used for sorting.
+   */
+  dt::array<TI> select_topk(size_t k) {
+    xassert(k <= n);
+    dt::array<TI> res(k);
+    dt::array<TI> pos;  // positions of the remaining candidates in `o`
+    size_t nres = 0;
+    while (nres < k) {
+      size_t kk = k - nres;
+      if (n <= kk) {
+        for (size_t j = 0; j < n; ++j) {
+          res[nres + j] = pos? pos[j] : static_cast<TI>(j);
+        }
+        nres += n;
+        break;
+      }
+      determine_sorting_parameters();
+      build_histogram();
+
+      // Before the "reorder" step, `histogram[r]` is the number of
+      // elements with radixes less than `r`.
+      size_t b = 0;
+      while (b + 1 < nradixes && histogram[b + 1] < kk) b++;
+      size_t nlt = histogram[b];
+      size_t nb = (b + 1 < nradixes? histogram[b + 1] : n) - nlt;
+      bool refine = nlt + nb > kk && (shift > 0 || strlong);
+
+      // Offsets where each chunk writes its selected elements and candidates
+      std::vector<size_t> seloffs(nchunks);
+      std::vector<size_t> candoffs(nchunks);
+      for (size_t i = 0; i < nchunks; ++i) {
+        size_t* cnts = histogram + i * nradixes;
+        size_t t = nres;
+        for (size_t r = 0; r < b; ++r) t += cnts[r] - histogram[r];
+        seloffs[i] = t;
+        candoffs[i] = cnts[b] - histogram[b];
+      }
+      size_t ntake = refine? 0 : kk - nlt;
+      dt::array<TI> newpos(refine? nb : 0);
+      void* newx = nullptr;
+      if (refine) {
+        // When the keys are exhausted (which may happen only for strings),
+        // the keys for the candidates are computed anew from the next
+        // 8-byte window of each string.
+        size_t sz = static_cast<size_t>(shift > 0? next_elemsize : 8);
+        newx = std::malloc(nb * sz);
+        if (!newx) {
+          throw MemoryError() << "Unable to allocate " << nb * sz << " bytes";
+        }
+      }
+      radix_range cands {ntake, nres + nlt};
+      void* nextx = shift > 0? newx : nullptr;
+      switch (elemsize) {
+        case 1: _topk_compact_dispatch<uint8_t>(b, cands, pos, res, newpos,
+                                                nextx, seloffs, candoffs);
+                break;
+        case 2: _topk_compact_dispatch<uint16_t>(b, cands, pos, res, newpos,
+                                                 nextx, seloffs, candoffs);
+                break;
+        case 4: _topk_compact_dispatch<uint32_t>(b, cands, pos, res, newpos,
+                                                 nextx, seloffs, candoffs);
+                break;
+        case 8: _topk_compact_dispatch<uint64_t>(b, cands, pos, res, newpos,
+                                                 nextx, seloffs, candoffs);
+                break;
+      }
+      nres += nlt + ntake;
+      if (!refine) break;
+
+      pos = std::move(newpos);
+      std::free(x);
+      x = newx;
+      n = nb;
+      if (shift > 0) {
+        elemsize = next_elemsize;
+        nsigbits = shift;
+      } else {
+        strstart += 8;
+        const TI* p = pos.data();
+        auto row = [&](size_t j) -> TI { return use_order? o[p[j]] : p[j]; };
+        bool distinct = stroffs64? _fill_strkeys<int64_t>(row)
+                                 : _fill_strkeys<int32_t>(row);
+        if (!distinct) {
+          // All candidates are equal: take the first of them
+          for (size_t j = 0; j < k - nres; ++j) {
+            res[nres + j] = p[j];
+          }
+          nres = k;
+        }
+      }
+    }
+    xassert(nres == k);
+
+    // Restore the original order of the selected elements, and convert their
+    // positions into row indices.
+    std::sort(res.data(), res.data() + k);
+    if (use_order) {
+      for (size_t i = 0; i < k; ++i) {
+        res[i] = o[res[i]];
+      }
+    }
+    return res;
+  }
+
+  template <typename TX>
+  void _topk_compact_dispatch(size_t b, radix_range cands,
+                              const dt::array<TI>& pos, dt::array<TI>& res,
+                              dt::array<TI>& newpos, void* newx,
+                              std::vector<size_t>& seloffs,
+                              std::vector<size_t>& candoffs) {
+    TX* xi = static_cast<TX*>(x);
+    TX mask = static_cast<TX>((1ULL << shift) - 1);
+    switch (newx? next_elemsize : 0) {
+      case 8:
+        _topk_compact<TX, uint64_t>(b, cands, pos, res, newpos, newx, seloffs,
+          candoffs,
+          [&](size_t j) { return static_cast<uint64_t>(xi[j] & mask); });
+        break;
+      case 4:
+        _topk_compact<TX, uint32_t>(b, cands, pos, res, newpos, newx, seloffs,
+          candoffs,
+          [&](size_t j) { return static_cast<uint32_t>(xi[j] & mask); });
+        break;
+      case 2:
+        _topk_compact<TX, uint16_t>(b, cands, pos, res, newpos, newx, seloffs,
+          candoffs,
+          [&](size_t j) { return static_cast<uint16_t>(xi[j] & mask); });
+        break;
+      default:
+        _topk_compact<TX, uint8_t>(b, cands, pos, res, newpos, newx, seloffs,
+          candoffs,
+          [&](size_t j) { return static_cast<uint8_t>(xi[j] & mask); });
+        break;
+    }
+  }
+
+  /**
+   * Single pass of the radix select algorithm: elements of `x` whose radix is
+   * less than `b` are written into `res` (at the offsets `seloffs`, computed
+   * for each chunk). Elements with radix `b` are either stored as candidates
+   * for the next pass into `newpos` / `newx` (the latter, if present,
+   * receiving the keys computed by the function `nextkey`), or, if there is
+   * no next pass, the first `cands.size` of them are written into `res` at
+   * `cands.offset`.
+   */
+  template <typename TX, typename TO, typename F>
+  void _topk_compact(size_t b, radix_range cands,
+                     const dt::array<TI>& pos, dt::array<TI>& res,
+                     dt::array<TI>& newpos, void* newx,
+                     std::vector<size_t>& seloffs,
+                     std::vector<size_t>& candoffs, F nextkey) {
+    TX* xi = static_cast<TX*>(x);
+    TO* xo = static_cast<TO*>(newx);
+    TI* rdata = res.data();
+    TI* pdata = newpos.data();
+    size_t rmask = nradixes - 1;
+    #pragma omp parallel for schedule(dynamic) num_threads(nth)
+    for (size_t i = 0; i < nchunks; ++i) {
+      size_t j0 = i * chunklen;
+      size_t j1 = std::min(j0 + chunklen, n);
+      size_t isel = seloffs[i];
+      size_t icand = candoffs[i];
+      for (size_t j = j0; j < j1; ++j) {
+        size_t r = static_cast<size_t>(xi[j] >> shift) & rmask;
+        if (r > b) continue;
+        TI p = pos? pos[j] : static_cast<TI>(j);
+        if (r < b) {
+          rdata[isel++] = p;
+        } else if (pdata) {
+          pdata[icand] = p;
+          if (xo) xo[icand] = nextkey(j);
+          icand++;
+        } else if (icand < cands.size) {
+          rdata[cands.offset + icand++] = p;
+        }
+      }
+    }
+  }
+
+
+  /**
+   * Return the ordering computed by the sort, without the groups. This
+   * SortContext should not be used afterwards.
+   */
+  dt::array<TI> release_order() {
+    return std::move(order);
+  }
+
   RowIndex get_result() {
-    RowIndex res = RowIndex::from_array32(std::move(order));
+    RowIndex res = _make_rowindex(std::move(order));
     if (groups) {
       groups.resize(static_cast<size_t>(gg.size() + 1));
       res.set_groups(std::move(groups));
@@ -316,6 +800,19 @@ class SortContext {
     return res;
   }
 
+  static void _extract_order(const RowIndex& ri, arr32_t& out) {
+    out = ri.extract_as_array32();
+  }
+  static void _extract_order(const RowIndex& ri, arr64_t& out) {
+    out = ri.extract_as_array64();
+  }
+  static RowIndex _make_rowindex(arr32_t&& arr) {
+    return RowIndex::from_array32(std::move(arr));
+  }
+  static RowIndex _make_rowindex(arr64_t&& arr) {
+    return RowIndex::from_array64(std::move(arr));
+  }
+
 
 
   //============================================================================
@@ -323,9 +820,43 @@ class SortContext {
   //============================================================================
 
   /**
-   * Boolean columns have only 3 distinct values: -128, 0 and 1. The transform
-   * `(x + 0xBF) >> 6` converts these to 0, 2 and 3 respectively, provided that
-   * the addition is done as addition of unsigned bytes (i.e. modulo 256).
+   * Fill the array `x` with the "sorting keys" derived from column `col`,
+   * taking into account the current ordering `o` (if `use_order` is set).
+   * This will initialize `x`, `elemsize` and `nsigbits`, and also `strdata`,
+   * `stroffs`, `strstart` for string columns.
+   *
+   * The keys are constructed so that sorting them in ascending order yields
+   * the requested ordering of the column: with direction given by `desc`,
+   * and NAs placed first or last depending on `nalast`.
+   */
+  void _prepare_data_for_column(const Column* col, bool desc,
+                                bool strkeys = true) {
+    descending = desc;
+    std::free(x);
+    x = nullptr;
+    strdata = nullptr;
+    strlong = false;
+    SType stype = col->stype();
+    switch (stype) {
+      case ST_BOOLEAN_I1: _initB(col); break;
+      case ST_INTEGER_I1: _initI<int8_t,  uint8_t>(col); break;
+      case ST_INTEGER_I2: _initI<int16_t, uint16_t>(col); break;
+      case ST_INTEGER_I4: _initI<int32_t, uint32_t>(col); break;
+      case ST_INTEGER_I8: _initI<int64_t, uint64_t>(col); break;
+      case ST_REAL_F4:    _initF<uint32_t>(col); break;
+      case ST_REAL_F8:    _initF<uint64_t>(col); break;
+      case ST_STRING_I4_VCHAR: _initS<int32_t>(col, strkeys); break;
+      case ST_STRING_I8_VCHAR: _initS<int64_t>(col, strkeys); break;
+      default:
+        throw NotImplError() << "Unable to sort Column of stype " << stype;
+    }
+  }
+
+
+  /**
+   * Boolean columns have only 3 distinct values: -128 (NA), 0 and 1. The
+   * values 0 and 1 are mapped into keys 1 and 2 (or 2 and 1 when sorting in
+   * descending order), while NAs become either 0 or 3.
    */
   void _initB(const Column* col) {
     uint8_t* xi = static_cast<uint8_t*>(col->data());
@@ -333,20 +864,21 @@ class SortContext {
     x = static_cast<void*>(xo);
     elemsize = 1;
     nsigbits = 2;
+    const uint8_t una = static_cast<uint8_t>(GETNA<int8_t>());
+    const uint8_t nakey = nalast? 3 : 0;
+    const uint8_t flip = descending;
 
     if (use_order) {
       #pragma omp parallel for schedule(static) num_threads(nth)
       for (size_t j = 0; j < n; j++) {
-        uint8_t t = xi[o[j]] + 0xBF;
-        xo[j] = t >> 6;
+        uint8_t t = xi[o[j]];
+        xo[j] = t == una? nakey : static_cast<uint8_t>((t ^ flip) + 1);
       }
     } else {
       #pragma omp parallel for schedule(static) num_threads(nth)
       for (size_t j = 0; j < n; j++) {
-        // xi[j]+0xBF should be computed as uint8_t; by default C++ upcasts it
-        // to int, which leads to wrong results after shift by 6.
-        uint8_t t = xi[j] + 0xBF;
-        xo[j] = t >> 6;
+        uint8_t t = xi[j];
+        xo[j] = t == una? nakey : static_cast<uint8_t>((t ^ flip) + 1);
       }
     }
   }
@@ -356,6 +888,10 @@ class SortContext {
    * For integer columns we subtract the min value, thus making the column
    * unsigned. Depending on the range of the values (max - min + 1), we cast
    * the data into an appropriate smaller type.
+   *
+   * In descending order the values are instead subtracted from the max. The
+   * NAs are mapped either to 0 (and then all other values are shifted by 1),
+   * or to `max - min + 1`, which is greater than any other key.
    */
   template <typename T, typename TU>
   void _initI(const Column* col) {
@@ -363,34 +899,44 @@ class SortContext {
     xassert(sizeof(T) == sizeof(TU));
     T min = icol->min();
     T max = icol->max();
-    nsigbits = sizeof(T) * 8;
-    nsigbits -= dt::nlz(static_cast<TU>(max - min + 1));
-    if (nsigbits > 32)      _initI_impl<T, TU, uint64_t>(icol, min);
-    else if (nsigbits > 16) _initI_impl<T, TU, uint32_t>(icol, min);
-    else if (nsigbits > 8)  _initI_impl<T, TU, uint16_t>(icol, min);
-    else                    _initI_impl<T, TU, uint8_t >(icol, min);
-  }
-
-  template <typename T, typename TI, typename TO>
-  void _initI_impl(const Column* col, T min) {
-    TI una = static_cast<TI>(GETNA<T>());
-    TI umin = static_cast<TI>(min);
-    TI* xi = static_cast<TI*>(col->data());
+    int nlz = dt::nlz(static_cast<TU>(max - min + 1));
+    nsigbits = static_cast<int8_t>(static_cast<int>(sizeof(T) * 8) - nlz);
+    if (descending) {
+      if (nsigbits > 32)      _initI_impl<T, TU, uint64_t, true>(icol, min, max);
+      else if (nsigbits > 16) _initI_impl<T, TU, uint32_t, true>(icol, min, max);
+      else if (nsigbits > 8)  _initI_impl<T, TU, uint16_t, true>(icol, min, max);
+      else                    _initI_impl<T, TU, uint8_t,  true>(icol, min, max);
+    } else {
+      if (nsigbits > 32)      _initI_impl<T, TU, uint64_t, false>(icol, min, max);
+      else if (nsigbits > 16) _initI_impl<T, TU, uint32_t, false>(icol, min, max);
+      else if (nsigbits > 8)  _initI_impl<T, TU, uint16_t, false>(icol, min, max);
+      else                    _initI_impl<T, TU, uint8_t,  false>(icol, min, max);
+    }
+  }
+
+  template <typename T, typename TU, typename TO, bool DESC>
+  void _initI_impl(const Column* col, T min, T max) {
+    TU una = static_cast<TU>(GETNA<T>());
+    TU umin = static_cast<TU>(min);
+    TU umax = static_cast<TU>(max);
+    TU* xi = static_cast<TU*>(col->data());
     TO* xo = new TO[n];
     x = static_cast<void*>(xo);
     elemsize = sizeof(TO);
+    TO nakey = nalast? static_cast<TO>(umax - umin + 1) : 0;
+    TU base = DESC? umax + !nalast : umin - !nalast;
 
     if (use_order) {
       #pragma omp parallel for schedule(static) num_threads(nth)
       for (size_t j = 0; j < n; ++j) {
-        TI t = xi[o[j]];
-        xo[j] = t == una? 0 : static_cast<TO>(t - umin + 1);
+        TU t = xi[o[j]];
+        xo[j] = t == una? nakey : static_cast<TO>(DESC? base - t : t - base);
       }
     } else {
       #pragma omp parallel for schedule(static) num_threads(nth)
       for (size_t j = 0; j < n; j++) {
-        TI t = xi[j];
-        xo[j] = t == una? 0 : static_cast<TO>(t - umin + 1);
+        TU t = xi[j];
+        xo[j] = t == una? nakey : static_cast<TO>(DESC? base - t : t - base);
       }
     }
   }
@@ -417,6 +963,9 @@ class SortContext {
    *      (1) numbers with sign bit = 0 will turn the sign bit on.
    *      (2) numbers with sign bit = 1 will be XORed with 0xFFFFFFFF
    *      (3) all NAs/NaNs will be converted to 0
+   * After this transform no non-NA value is mapped to either 0 or 0xFFFFFFFF.
+   * Thus, in descending order we can simply invert all the bits of each key,
+   * and when NAs should go last they are converted to 0xFFFFFFFF instead of 0.
    *
    * Float64 is similar: 1 bit for the sign, 11 bits of exponent, and finally
    * 52 bits of the significand.
@@ -440,63 +989,149 @@ class SortContext {
     constexpr TO SBT
       = static_cast<TO>(sizeof(TO) == 8? 0x8000000000000000ULL : 0x80000000);
     constexpr int SHIFT = sizeof(TO) * 8 - 1;
+    const TO nakey = nalast? static_cast<TO>(-1) : 0;
+    const TO flip = descending? static_cast<TO>(-1) : 0;
 
     if (use_order) {
       #pragma omp parallel for schedule(static) num_threads(nth)
       for (size_t j = 0; j < n; j++) {
         TO t = xi[o[j]];
         xo[j] = ((t & EXP) == EXP && (t & SIG) != 0)
-                ? 0 : t ^ (SBT | -(t>>SHIFT));
+                ? nakey : t ^ (SBT | -(t>>SHIFT)) ^ flip;
       }
     } else {
       #pragma omp parallel for schedule(static) num_threads(nth)
       for (size_t j = 0; j < n; j++) {
         TO t = xi[j];
         xo[j] = ((t & EXP) == EXP && (t & SIG) != 0)
-                ? 0 : t ^ (SBT | -(t>>SHIFT));
+                ? nakey : t ^ (SBT | -(t>>SHIFT)) ^ flip;
       }
     }
   }
 
 
   /**
-   * For strings, we fill array `x` with the values of the first 2 characters in
-   * each string. We also set up auxiliary variables `strdata`, `stroffs`,
-   * `strstart`.
+   * For strings, we fill array `x` with the keys made of the first 8 bytes of
+   * each string (see `_fill_strkeys()`). We also set up auxiliary variables
+   * `strdata`, `stroffs`, `strstart`, `strlong`.
+   *
+   * More specifically, each character `ch[i]` of a string is mapped to the
+   * byte `ch[i] + 2`, and the end of the string to 1; NA strings are mapped
+   * to 0. This doesn't overflow because in UTF-8 the largest legal byte is
+   * 0xF7.
    *
-   * More specifically, for each string item, if it is NA then we map it to 0;
-   * if it is an empty string we map it to 1, otherwise we map it to `ch[i] + 2`
-   * where `ch[i]` is the i-th character of the string. This doesn't overflow
-   * because in UTF-8 the largest legal byte is 0xF7.
+   * In descending order characters are mapped to `0xFD - ch[i]`, and the end
+   * of the string to 0xFE. When NAs should go last, they are mapped to 0xFF.
+   * See `_strkeys()`.
    */
   template <typename T>
-  void _initS(const Column* col) {
+  void _initS(const Column* col, bool strkeys) {
     auto scol = static_cast<const StringColumn<T>*>(col);
     strdata = reinterpret_cast<uint8_t*>(scol->strdata());
-    T* offs = scol->offsets();
-    stroffs = static_cast<int32_t*>(offs);  // ???
+    stroffs = static_cast<const void*>(scol->offsets());
+    stroffs64 = (sizeof(T) == 8);
     strstart = 0;
-    uint8_t* xo = new uint8_t[n];
-    x = static_cast<void*>(xo);
-    elemsize = 1;
-    nsigbits = 8;
+    if (!strkeys) return;
+    x = static_cast<void*>(new uint64_t[n]);
+    _fill_strkeys<T>(
+      [&](size_t j) -> TI { return use_order? o[j] : static_cast<TI>(j); });
+  }
 
-    int maxlen = 0;
-    #pragma omp parallel for schedule(static) num_threads(nth) \
-            reduction(max:maxlen)
-    for (size_t j = 0; j < n; ++j) {
-      int32_t k = use_order? o[j] : static_cast<int32_t>(j);
-      T offend = offs[k];
-      if (offend < 0) {  // NA
-        xo[j] = 0;
-      } else {
-        T offstart = std::abs(offs[k - 1]);
-        T len = offend - offstart;
-        xo[j] = len > 0? strdata[offstart] + 2 : 1;
+  /**
+   * Fill the array `x` (which must have room for `n` 8-byte elements) with
+   * the keys of strings in rows `row(0)`, ..., `row(n - 1)`. Each key packs
+   * the mapped bytes of the string at positions `[strstart; strstart + 8)`
+   * in big-endian order, so that comparing the keys as integers is the same
+   * as comparing these parts of the strings. The end-of-string byte is
+   * followed by zeros, and an NA string has all bytes of its key equal to the
+   * NA byte.
+   *
+   * The prefix shared by all non-NA strings is skipped: if the keys have
+   * common leading bytes, then `strstart` is advanced past them and the keys
+   * are recomputed. Similarly, the trailing bytes that come after the end of
+   * all strings are removed from the keys, so that `nsigbits` covers only
+   * the bytes that actually need to be sorted.
+   *
+   * This sets `elemsize`, `nsigbits` and `strlong`. The return value is false
+   * if all strings are equal (and thus don't need to be sorted any further).
+   */
+  template <typename T, typename F>
+  bool _fill_strkeys(F row) {
+    const T* offs = static_cast<const T*>(stroffs);
+    uint64_t* xo = static_cast<uint64_t*>(x);
+    const uint64_t nakey = nalast? ~uint64_t(0) : 0;
+    uint8_t eoskey, chxor, chadd;
+    _strkeys(&eoskey, &chxor, &chadd);
+
+    while (true) {
+      const T ss = static_cast<T>(strstart);
+      uint64_t kmin = ~uint64_t(0);
+      uint64_t kmax = 0;
+      T maxlen = -1;
+      size_t nnas = 0;
+      #pragma omp parallel for schedule(static) num_threads(nth) \
+              reduction(min:kmin) reduction(max:kmax,maxlen) reduction(+:nnas)
+      for (size_t j = 0; j < n; ++j) {
+        TI w = row(j);
+        T offend = offs[w];
+        if (offend < 0) {  // NA
+          xo[j] = nakey;
+          nnas++;
+          continue;
+        }
+        T offstart = std::abs(offs[w - 1]) + ss;
+        T len = std::max(offend - offstart, T(0));
+        uint64_t key = 0;
+        for (T i = 0; i < 8; ++i) {
+          key <<= 8;
+          if (i < len) {
+            key |= static_cast<uint8_t>((strdata[offstart + i] ^ chxor) + chadd);
+          } else if (i == len) {
+            key |= eoskey;
+          }
+        }
+        xo[j] = key;
+        if (key < kmin) kmin = key;
+        if (key > kmax) kmax = key;
         if (len > maxlen) maxlen = len;
       }
+      if (nnas < n) {
+        // Skip the common prefix. Note that the common bytes of `kmin` and
+        // `kmax` cannot contain the end of the string, unless the keys are
+        // equal.
+        if (kmin == kmax && maxlen >= 8) {
+          strstart += 8;
+          continue;
+        }
+        if (kmin != kmax && dt::nlz(kmin ^ kmax) >= 8) {
+          strstart += static_cast<size_t>(dt::nlz(kmin ^ kmax) / 8);
+          continue;
+        }
+      }
+      elemsize = 8;
+      strlong = (maxlen >= 8);
+      int nbytes = strlong? 8 : std::max(static_cast<int>(maxlen) + 1, 1);
+      nsigbits = static_cast<int8_t>(nbytes * 8);
+      if (nbytes < 8) {
+        int sh = 64 - nsigbits;
+        #pragma omp parallel for schedule(static) num_threads(nth)
+        for (size_t j = 0; j < n; ++j) {
+          xo[j] >>= sh;
+        }
+      }
+      return !(nnas == n || (nnas == 0 && kmin == kmax));
     }
-    next_elemsize = (maxlen > 1);
+  }
+
+  /**
+   * Parameters of the mapping of string characters into radix keys: the end
+   * of a string (or an empty string) is mapped into `eoskey`, and each
+   * character `ch` into `(ch ^ chxor) + chadd` (computed modulo 256).
+   */
+  void _strkeys(uint8_t* eoskey, uint8_t* chxor, uint8_t* chadd) const {
+    *eoskey = descending? 0xFE : 1;
+    *chxor = descending? 0xFF : 0;
+    *chadd = descending? 0xFE : 2;
   }
 
 
@@ -529,16 +1164,21 @@ class SortContext {
 
     int8_t nradixbits = nsigbits < config::sort_max_radix_bits
                         ? nsigbits : config::sort_over_radix_bits;
+    // String keys are wide, and the ranges being sorted quickly become
+    // small. Wide radixes are used only if the range is large enough to
+    // make use of them, otherwise the strings are sorted one byte at a time.
+    if (strdata && n < (size_t(1) << nradixbits)) {
+      nradixbits = std::min(nradixbits, int8_t(8));
+    }
     shift = nsigbits - nradixbits;
     nradixes = 1 << nradixbits;
 
-    if (!strdata) {
-      // The remaining number of sig.bits is `shift`. Thus, this value will
-      // determine the `next_elemsize`.
-      next_elemsize = shift > 32? 8 :
-                      shift > 16? 4 :
-                      shift > 0? 2 : 0;
-    }
+    // The remaining number of sig.bits is `shift`. Thus, this value will
+    // determine the `next_elemsize`.
+    next_elemsize = shift > 32? 8 :
+                    shift > 16? 4 :
+                    shift > 8? 2 :
+                    shift > 0? 1 : 0;
   }
 
 
@@ -574,13 +1214,14 @@ class SortContext {
 
   template<typename T> void _histogram_gather() {
     T* tx = static_cast<T*>(x);
+    size_t rmask = nradixes - 1;
     #pragma omp parallel for schedule(dynamic) num_threads(nth)
     for (size_t i = 0; i < nchunks; ++i) {
       size_t* cnts = histogram + (nradixes * i);
       size_t j0 = i * chunklen;
       size_t j1 = std::min(j0 + chunklen, n);
       for (size_t j = j0; j < j1; ++j) {
-        cnts[tx[j] >> shift]++;
+        cnts[(tx[j] >> shift) & rmask]++;
       }
     }
   }
@@ -624,33 +1265,13 @@ class SortContext {
       next_x = new int64_t[(n * sz + 7) / 8];
     }
     if (!next_o) {
-      next_o = new int32_t[n];
+      next_o = new TI[n];
     }
-    if (strdata) {
-      if (next_x) _reorder_str();
-      else _reorder_impl<uint8_t, char, false>();
-    } else {
-      switch (elemsize) {
-        case 8:
-          xassert(next_elemsize == 8 || next_elemsize == 4);
-          if (next_elemsize == 8) _reorder_impl<uint64_t, uint64_t, true>();
-          if (next_elemsize == 4) _reorder_impl<uint64_t, uint32_t, true>();
-          break;
-        case 4:
-          xassert(next_elemsize == 4 || next_elemsize == 2);
-          if (next_elemsize == 4) _reorder_impl<uint32_t, uint32_t, true>();
-          if (next_elemsize == 2) _reorder_impl<uint32_t, uint16_t, true>();
-          break;
-        case 2:
-          xassert(next_elemsize == 2 || next_elemsize == 0);
-          if (next_elemsize == 2) _reorder_impl<uint16_t, uint16_t, true>();
-          if (next_elemsize == 0) _reorder_impl<uint16_t, uint8_t, false>();
-          break;
-        case 1:
-          xassert(next_elemsize == 0);
-          _reorder_impl<uint8_t, uint8_t, false>();
-          break;
-      }
+    switch (elemsize) {
+      case 8: _reorder_dispatch<uint64_t>(); break;
+      case 4: _reorder_dispatch<uint32_t>(); break;
+      case 2: _reorder_dispatch<uint16_t>(); break;
+      case 1: _reorder_dispatch<uint8_t>(); break;
     }
     std::swap(x, next_x);
     std::swap(o, next_o);
@@ -658,13 +1279,25 @@ class SortContext {
     use_order = true;
   }
 
-  template<typename TI, typename TO, bool OUT> void _reorder_impl() {
-    TI* xi = static_cast<TI*>(x);
+  template<typename TX> void _reorder_dispatch() {
+    xassert(next_elemsize <= elemsize);
+    switch (next_elemsize) {
+      case 8: _reorder_impl<TX, uint64_t, true>(); break;
+      case 4: _reorder_impl<TX, uint32_t, true>(); break;
+      case 2: _reorder_impl<TX, uint16_t, true>(); break;
+      case 1: _reorder_impl<TX, uint8_t, true>(); break;
+      case 0: _reorder_impl<TX, uint8_t, false>(); break;
+    }
+  }
+
+  template<typename TX, typename TO, bool OUT> void _reorder_impl() {
+    TX* xi = static_cast<TX*>(x);
     TO* xo;
-    TI mask;
+    TX mask;
+    size_t rmask = nradixes - 1;
     if (OUT) {
       xo = static_cast<TO*>(next_x);
-      mask = static_cast<TI>((1ULL << shift) - 1);
+      mask = static_cast<TX>((1ULL << shift) - 1);
     }
     #pragma omp parallel for schedule(dynamic) num_threads(nth)
     for (size_t i = 0; i < nchunks; ++i) {
@@ -672,9 +1305,9 @@ class SortContext {
       size_t j1 = std::min(j0 + chunklen, n);
       size_t* tcounts = histogram + (nradixes * i);
       for (size_t j = j0; j < j1; ++j) {
-        size_t k = tcounts[xi[j] >> shift]++;
+        size_t k = tcounts[(xi[j] >> shift) & rmask]++;
         xassert(k < n);
-        next_o[k] = use_order? o[j] : static_cast<int32_t>(j);
+        next_o[k] = use_order? o[j] : static_cast<TI>(j);
         if (OUT) {
           xo[k] = static_cast<TO>(xi[j] & mask);
         }
@@ -683,34 +1316,6 @@ class SortContext {
     xassert(histogram[nchunks * nradixes - 1] == n);
   }
 
-  void _reorder_str() {
-    uint8_t* xi = static_cast<uint8_t*>(x);
-    uint8_t* xo = static_cast<uint8_t*>(next_x);
-    const int32_t ss = static_cast<int32_t>(strstart) + 1;
-
-    int32_t maxlen = 0;
-    #pragma omp parallel for schedule(dynamic) num_threads(nth) \
-            reduction(max:maxlen)
-    for (size_t i = 0; i < nchunks; ++i) {
-      size_t j0 = i * chunklen;
-      size_t j1 = std::min(j0 + chunklen, n);
-      size_t* tcounts = histogram + (nradixes * i);
-      for (size_t j = j0; j < j1; ++j) {
-        size_t k = tcounts[xi[j]]++;
-        xassert(k < n);
-        int32_t w = use_order? o[j] : static_cast<int32_t>(j);
-        int32_t offend = stroffs[w];
-        int32_t offstart = std::abs(stroffs[w - 1]) + ss;
-        int32_t len = offend - offstart;
-        xo[k] = len > 0? strdata[offstart] + 2 : 1;
-        next_o[k] = w;
-        if (len > maxlen) maxlen = len;
-      }
-    }
-    next_elemsize = maxlen > 0;
-    xassert(histogram[nchunks * nradixes - 1] == n);
-  }
-
 
 
   //============================================================================
@@ -725,8 +1330,8 @@ class SortContext {
    * SortContext inputs:
    *   x:      buffer of size `elemsize * n`
    *   next_x: nullptr, or buffer of size `next_elemsize * n`
-   *   o:      nullptr, or array of `int32_t`s of length `n`
-   *   next_o: nullptr, or array of `int32_t`s of length `n`
+   *   o:      nullptr, or array of `TI`s of length `n`
+   *   next_o: nullptr, or array of `TI`s of length `n`
    *   elemsize
    *   next_elemsize: (may be zero)
    *   nsigbits
@@ -736,21 +1341,82 @@ class SortContext {
    *      will be modified in-place.
    *   x, next_x, next_o, histogram: These arrays may be allocated, or their
    *      contents may be altered arbitrarily.
+   *
+   * For strings, `elemsize` may also be 0, which indicates that the keys
+   * for the window of bytes starting at `strstart` have to be computed
+   * first (in this case `x` and `next_x` are not used).
    */
   void radix_psort() {
-    int32_t* ores = o;
+    TI* ores = o;
+    void* _x = x;
+    void* _next_x = next_x;
+    uint64_t* strkeys = nullptr;
+    if (strdata) {
+      bool distinct = false;
+      switch (elemsize) {
+        case 1: distinct = _trim_common_bits<uint8_t>(); break;
+        case 2: distinct = _trim_common_bits<uint16_t>(); break;
+        case 4: distinct = _trim_common_bits<uint32_t>(); break;
+        case 8: distinct = _trim_common_bits<uint64_t>(); break;
+      }
+      if (!distinct && (strlong || !elemsize)) {
+        // The keys for the current window are either equal or exhausted:
+        // compute the keys for the next window of bytes in each string.
+        if (elemsize) strstart += 8;
+        strkeys = new uint64_t[2 * n];
+        x = static_cast<void*>(strkeys);
+        next_x = static_cast<void*>(strkeys + n);
+        auto row = [&](size_t j) -> TI {
+          return use_order? o[j] : static_cast<TI>(j);
+        };
+        distinct = stroffs64? _fill_strkeys<int64_t>(row)
+                            : _fill_strkeys<int32_t>(row);
+      }
+      if (!distinct) {
+        // All strings are equal, and keep their current order
+        if (!use_order) {
+          for (size_t j = 0; j < n; ++j) o[j] = static_cast<TI>(j);
+        }
+        if (groups) gg.push(n);
+        x = _x;
+        next_x = _next_x;
+        delete[] strkeys;
+        return;
+      }
+    }
     determine_sorting_parameters();
     build_histogram();
     reorder_data();
 
-    if (elemsize) {
+    if (elemsize || strlong) {
       // If after reordering there are still unsorted elements in `x`, then
-      // sort them recursively.
+      // sort them recursively. The ranges to be sorted are derived from the
+      // histogram: they are the regions corresponding to each radix.
+      size_t* rrendoffsets = histogram + (nchunks - 1) * nradixes;
+      size_t _nradixes = nradixes;
+      radix_range* rrmap = new radix_range[_nradixes];
+      for (size_t i = 0; i < _nradixes; i++) {
+        size_t start = i? rrendoffsets[i-1] : 0;
+        size_t end = rrendoffsets[i];
+        xassert(start <= end);
+        rrmap[i].size   = end - start;
+        rrmap[i].offset = start;
+      }
+      // Within each range, the elements are sorted by their remaining
+      // `shift` bits. If these are exhausted, then strings are sorted
+      // further starting from the next window of 8 bytes.
+      size_t  _strstart = strstart;
+      int8_t  _nsigbits = nsigbits;
+      if (!elemsize) strstart = _strstart + 8;
+      nsigbits = shift;
       if (groups) {
-        _radix_recurse<true>();
+        _radix_recurse<true>(rrmap, _nradixes);
       } else {
-        _radix_recurse<false>();
+        _radix_recurse<false>(rrmap, _nradixes);
       }
+      strstart = _strstart;
+      nsigbits = _nsigbits;
+      delete[] rrmap;
     } else if (groups) {
       // Otherwise groups can be computed directly from the histogram
       gg.from_histogram(histogram, nchunks, nradixes);
@@ -758,12 +1424,42 @@ class SortContext {
 
     // Done. Save to array `o` the computed ordering of the input vector `x`.
     if (ores && o != ores) {
-      std::memcpy(ores, o, n * sizeof(int32_t));
+      std::memcpy(ores, o, n * sizeof(TI));
       next_o = o;
       o = ores;
     }
+    if (strkeys) {
+      x = _x;
+      next_x = _next_x;
+      delete[] strkeys;
+    }
+  }
+
+  /**
+   * Reduce `nsigbits` by the number of leading significant bits that are the
+   * same in all elements of `x`. For strings these bits correspond to the
+   * prefix shared by all strings in the range being sorted, and skipping
+   * them avoids the radix passes where all elements fall into a single
+   * radix. Returns false if all elements of `x` are equal.
+   */
+  template <typename T>
+  bool _trim_common_bits() {
+    const T* xi = static_cast<const T*>(x);
+    const T x0 = xi[0];
+    T diff = 0;
+    #pragma omp parallel for schedule(static) num_threads(nth) \
+            reduction(|:diff)
+    for (size_t j = 1; j < n; ++j) {
+      diff |= xi[j] ^ x0;
+    }
+    if (!diff) return false;
+    int8_t nbits = static_cast<int8_t>(static_cast<int>(sizeof(T) * 8) -
+                                       dt::nlz(diff));
+    if (nbits < nsigbits) nsigbits = nbits;
+    return true;
   }
 
+
   /**
    * Helper for radix sorting function.
    *
@@ -772,45 +1468,39 @@ class SortContext {
    * chunks. For example if `shift` is 2, then `x` may be:
    *     na na | 0 2 1 3 1 | 2 | 1 1 3 0 | 3 0 0 | 2 2 2 2 2 2
    *
-   * For each distinct radix there is a "range" within `x` that
-   * contains values corresponding to that radix. The values in `x`
-   * have their most significant bits already removed, since they are
-   * constant within each radix range. The array `x` is accompanied
-   * by array `o` which carries the original row numbers of each
-   * value. Once we sort `o` by the values of `x` within each
+   * Each such chunk is described by an element of the `rrmap` array (which
+   * has `nrr` entries). The values in `x` have their most significant bits
+   * already removed, since they are constant within each radix range. The
+   * array `x` is accompanied by array `o` which carries the original row
+   * numbers of each value. Once we sort `o` by the values of `x` within each
    * radix range, our job will be complete.
+   *
+   * The ranges may also come from the groups of a previously sorted column
+   * (see `continue_sort()`), in which case `x` contains the full keys of the
+   * next column.
+   *
+   * SortContext inputs:
+   *   strstart: for string columns, the position within each string from
+   *             which the sorting within each range should start.
+   *   nsigbits: number of significant bits in each element of `x`.
    */
   template <bool make_groups>
-  void _radix_recurse() {
+  void _radix_recurse(radix_range* rrmap, size_t nrr) {
     // Save some of the variables in SortContext that we will be modifying
     // in order to perform the recursion.
     size_t   _n        = n;
     void*    _x        = x;
     void*    _next_x   = next_x;
-    int32_t* _o        = o;
-    int32_t* _next_o   = next_o;
+    TI*      _o        = o;
+    TI*      _next_o   = next_o;
     int8_t   _elemsize = elemsize;
     int8_t   _nsigbits = nsigbits;
-    size_t   _nradixes = nradixes;
     size_t   _strstart = strstart;
-    int32_t  ggoff0    = make_groups? gg.cumulative_size() : 0;
-    int32_t* ggdata0   = make_groups? gg.data() : 0;
+    bool     _strlong  = strlong;
+    TI       ggoff0    = make_groups? gg.cumulative_size() : 0;
+    TI*      ggdata0   = make_groups? gg.data() : nullptr;
     size_t   zelemsize = static_cast<size_t>(elemsize);
 
-    // First, determine the sizes of ranges corresponding to each radix that
-    // remain to be sorted. The previous step left us with the `histogram`
-    // array containing cumulative sizes of these ranges, so all we need is
-    // to diff that array.
-    size_t* rrendoffsets = histogram + (nchunks - 1) * nradixes;
-    radix_range* rrmap = new radix_range[nradixes];
-    for (size_t i = 0; i < nradixes; i++) {
-      size_t start = i? rrendoffsets[i-1] : 0;
-      size_t end = rrendoffsets[i];
-      xassert(start <= end);
-      rrmap[i].size   = end - start;
-      rrmap[i].offset = start;
-    }
-
     // At this point the distribution of radix range sizes may or may not
     // be uniform. If the distribution is uniform (i.e. roughly same number
     // of elements in each range), then the best way to proceed is to let
@@ -835,10 +1525,7 @@ class SortContext {
     size_t rrlarge = config::sort_insert_method_threshold;  // for now
     xassert(GROUPED > rrlarge);
 
-    strstart = _strstart + 1;
-    nsigbits = strdata? 8 : shift;
-
-    for (size_t rri = 0; rri < _nradixes; ++rri) {
+    for (size_t rri = 0; rri < nrr; ++rri) {
       size_t sz = rrmap[rri].size;
       if (sz > rrlarge) {
         size_t off = rrmap[rri].offset;
@@ -848,8 +1535,11 @@ class SortContext {
         next_x = add_ptr(_next_x, off * zelemsize);
         next_o = _next_o + off;
         elemsize = _elemsize;
+        nsigbits = _nsigbits;
+        strstart = _strstart;
+        strlong = _strlong;
         if (make_groups) {
-          gg.init(ggdata0 + off, ggoff0 + static_cast<int32_t>(off));
+          gg.init(ggdata0 + off, ggoff0 + static_cast<TI>(off));
         }
         radix_psort();
         if (make_groups) {
@@ -866,16 +1556,19 @@ class SortContext {
     o = _o;
     next_x = _next_x;
     next_o = _next_o;
+    elemsize = _elemsize;
+    nsigbits = _nsigbits;
     strstart = _strstart;
+    strlong = _strlong;
     gg.init(ggdata0, ggoff0);
-    nsigbits = _nsigbits;
 
     // Finally iterate over all remaining radix ranges, in-parallel, and
     // sort each of them independently using a simpler insertion sort
     // method.
-    size_t nthreads = std::min(nth, nsmallgroups);
-    int32_t ss = static_cast<int32_t>(_strstart + 1);
-    int32_t* tmp = nullptr;
+    size_t nthreads = std::max(std::min(nth, nsmallgroups), size_t(1));
+    // Sorting strings by their keys requires twice as much scratch space
+    size_t tmpsize = strdata? 2 * size0 : size0;
+    TI* tmp = nullptr;
     bool own_tmp = false;
     if (size0) {
       // size_t size_all = size0 * nthreads * sizeof(int32_t);
@@ -883,17 +1576,17 @@ class SortContext {
       //   tmp = (int32_t*)_x;
       // } else {
       own_tmp = true;
-      tmp = new int32_t[size0 * nthreads];
+      tmp = new TI[tmpsize * nthreads];
       // }
     }
     #pragma omp parallel num_threads(nthreads)
     {
       int tnum = omp_get_thread_num();
-      int32_t* oo = tmp + tnum * static_cast<int32_t>(size0);
-      GroupGatherer tgg;
+      TI* oo = tmp + static_cast<size_t>(tnum) * tmpsize;
+      GroupGatherer<TI> tgg;
 
       #pragma omp for schedule(dynamic)
-      for (size_t i = 0; i < _nradixes; ++i) {
+      for (size_t i = 0; i < nrr; ++i) {
         size_t zn  = rrmap[i].size;
         size_t off = rrmap[i].offset;
         if (zn > rrlarge) {
@@ -901,12 +1594,14 @@ class SortContext {
         } else if (zn > 1) {
           int32_t  tn = static_cast<int32_t>(zn);
           void*    tx = static_cast<char*>(_x) + off * zelemsize;
-          int32_t* to = _o + off;
+          TI*      to = _o + off;
           if (make_groups) {
-            tgg.init(ggdata0 + off, static_cast<int32_t>(off) + ggoff0);
+            tgg.init(ggdata0 + off, static_cast<TI>(off) + ggoff0);
           }
-          if (strdata) {
-            insert_sort_keys_str(strdata, stroffs, ss, to, oo, tn, tgg);
+          if (strdata && !_elemsize) {
+            _insert_sort_keys_str(_strstart, to, oo, tn, tgg);
+          } else if (strdata && _strlong) {
+            _insert_sort_strkeys(tx, to, oo, tn, tgg, _strstart + 8);
           } else {
             switch (_elemsize) {
               case 1: insert_sort_keys<>(static_cast<uint8_t*>(tx), to, oo, tn, tgg); break;
@@ -919,7 +1614,7 @@ class SortContext {
             rrmap[i].size = static_cast<size_t>(tgg.size());
           }
         } else if (zn == 1 && make_groups) {
-          ggdata0[off] = static_cast<int32_t>(off) + ggoff0 + 1;
+          ggdata0[off] = static_cast<TI>(off) + ggoff0 + 1;
           rrmap[i].size = 1;
         }
       }
@@ -927,10 +1622,9 @@ class SortContext {
 
     // Consolidate groups into a single contiguous chunk
     if (make_groups) {
-      gg.from_chunks(rrmap, nradixes);
+      gg.from_chunks(rrmap, nrr);
     }
 
-    delete[] rrmap;
     if (own_tmp) delete[] tmp;
   }
 
@@ -941,11 +1635,11 @@ class SortContext {
   //============================================================================
 
   void kinsert_sort() {
-    arr32_t tmparr(n);
-    int32_t* tmp = tmparr.data();
+    dt::array<TI> tmparr(n);
+    TI* tmp = tmparr.data();
     if (strdata) {
-      int32_t nn = static_cast<int32_t>(n);
-      insert_sort_keys_str(strdata, stroffs, 0, o, tmp, nn, gg);
+      int nn = static_cast<int>(n);
+      _insert_sort_keys_str(0, o, tmp, nn, gg);
     } else {
       switch (elemsize) {
         case 1: _insert_sort_keys<uint8_t >(tmp); break;
@@ -959,8 +1653,16 @@ class SortContext {
 
   void vinsert_sort() {
     if (strdata) {
-      int32_t nn = static_cast<int32_t>(n);
-      insert_sort_values_str(strdata, stroffs, 0, o, nn, gg);
+      int nn = static_cast<int>(n);
+      if (stroffs64) {
+        const int64_t* offs = static_cast<const int64_t*>(stroffs);
+        insert_sort_values_str(strdata, offs, int64_t(0), o, nn, gg,
+                               descending, nalast);
+      } else {
+        const int32_t* offs = static_cast<const int32_t*>(stroffs);
+        insert_sort_values_str(strdata, offs, int32_t(0), o, nn, gg,
+                               descending, nalast);
+      }
     } else {
       switch (elemsize) {
         case 1: _insert_sort_values<uint8_t >(); break;
@@ -971,18 +1673,64 @@ class SortContext {
     }
   }
 
-  template <typename T> void _insert_sort_keys(int32_t* tmp) {
+  template <typename T> void _insert_sort_keys(TI* tmp) {
     T* xt = static_cast<T*>(x);
-    int32_t nn = static_cast<int32_t>(n);
+    int nn = static_cast<int>(n);
     insert_sort_keys(xt, o, tmp, nn, gg);
   }
 
   template <typename T> void _insert_sort_values() {
     T* xt = static_cast<T*>(x);
-    int32_t nn = static_cast<int32_t>(n);
+    int nn = static_cast<int>(n);
     insert_sort_values(xt, o, nn, gg);
   }
 
+  /**
+   * Sort a small range of strings, some of which extend past the current
+   * window of bytes: first the range is sorted by the keys `tx` (which have
+   * the size `elemsize`), and then the strings with equal keys are sorted
+   * further starting from position `ss`. The scratch array `tmp` must have
+   * room for `2 * nn` elements.
+   */
+  void _insert_sort_strkeys(void* tx, TI* to, TI* tmp, int nn,
+                            GroupGatherer<TI>& tgg, size_t ss) {
+    TI* kgrps = tmp + nn;
+    GroupGatherer<TI> kgg;
+    kgg.init(kgrps, 0);
+    switch (elemsize) {
+      case 1: insert_sort_keys<>(static_cast<uint8_t*>(tx), to, tmp, nn, kgg); break;
+      case 2: insert_sort_keys<>(static_cast<uint16_t*>(tx), to, tmp, nn, kgg); break;
+      case 4: insert_sort_keys<>(static_cast<uint32_t*>(tx), to, tmp, nn, kgg); break;
+      case 8: insert_sort_keys<>(static_cast<uint64_t*>(tx), to, tmp, nn, kgg); break;
+    }
+    TI start = 0;
+    for (TI g = 0; g < kgg.size(); ++g) {
+      TI end = kgrps[g];
+      if (end - start > 1) {
+        _insert_sort_keys_str(ss, to + start, tmp, static_cast<int>(end - start),
+                              tgg);
+      } else if (tgg) {
+        tgg.push(1);
+      }
+      start = end;
+    }
+  }
+
+  void _insert_sort_keys_str(size_t ss, TI* to, TI* tmp, int nn,
+                             GroupGatherer<TI>& tgg) {
+    if (stroffs64) {
+      const int64_t* offs = static_cast<const int64_t*>(stroffs);
+      int64_t start = static_cast<int64_t>(ss);
+      insert_sort_keys_str(strdata, offs, start, to, tmp, nn, tgg,
+                           descending, nalast);
+    } else {
+      const int32_t* offs = static_cast<const int32_t*>(stroffs);
+      int32_t start = static_cast<int32_t>(ss);
+      insert_sort_keys_str(strdata, offs, start, to, tmp, nn, tgg,
+                           descending, nalast);
+    }
+  }
+
 };
 
 
@@ -991,50 +1739,596 @@ class SortContext {
 // Main sorting routines
 //==============================================================================
 
+static RowIndex sort_tiny(const Column* col, bool make_groups) {
+  int64_t i = col->rowindex().nth(0);
+  RowIndex res = RowIndex::from_slice(i, col->nrows, 1);
+  if (make_groups) {
+    arr32_t grps(static_cast<size_t>(col->nrows) + 1);
+    grps[0] = 0;
+    if (col->nrows) grps[1] = 1;
+    res.set_groups(std::move(grps));
+  }
+  return res;
+}
+
+
 /**
- * Sort the column, and return its ordering as a RowIndex object. This function
- * will choose the most appropriate algorithm for sorting. The data in column
- * `col` will not be modified.
+ * Return true if sorting column `col` requires 64-bit orderings: i.e. either
+ * the column has more than 2**31 rows, or it is a view into a frame that has
+ * more than 2**31 rows. Otherwise the faster 32-bit path is used, unless
+ * the 64-bit one was requested via `config::sort_force_int64` (for testing).
+ */
+bool sort_needs_int64(const Column* col) {
+  const RowIndex& ri = col->rowindex();
+  return col->nrows > INT32_MAX || ri.isarr64() || ri.max() > INT32_MAX ||
+         config::sort_force_int64;
+}
+
+
+//==============================================================================
+// External sort
+//==============================================================================
+
+/**
+ * Comparator of two rows of a column, consistent with the ordering produced by
+ * `SortContext`: `cmp(a, b)` is negative if row `a` goes before row `b`,
+ * positive if after, and 0 if the rows are equal. The arguments are indices
+ * within the column's data buffer.
+ */
+class RowComparator {
+  public:
+    virtual ~RowComparator() {}
+    virtual int cmp(size_t a, size_t b) const = 0;
+};
+
+
+template <typename T>
+class IntRowComparator : public RowComparator {
+  const T* data;
+  bool descending;
+  bool nalast;
+
+  public:
+    IntRowComparator(const Column* col, bool desc, bool na_last)
+      : data(static_cast<const T*>(col->data())),
+        descending(desc), nalast(na_last) {}
+
+    int cmp(size_t a, size_t b) const override {
+      T va = data[a];
+      T vb = data[b];
+      bool naa = ISNA<T>(va);
+      bool nab = ISNA<T>(vb);
+      if (naa || nab) {
+        return naa == nab? 0 : (naa == nalast)? 1 : -1;
+      }
+      int c = (va < vb)? -1 : (va > vb);
+      return descending? -c : c;
+    }
+};
+
+
+/**
+ * Floats are compared via the same unsigned keys as in `_initF()`, so that
+ * the ordering of NaNs and signed zeros matches the radix sort exactly.
+ */
+template <typename TO>
+class RealRowComparator : public RowComparator {
+  const TO* data;
+  TO nakey;
+  TO flip;
+
+  public:
+    RealRowComparator(const Column* col, bool desc, bool na_last)
+      : data(static_cast<const TO*>(col->data())),
+        nakey(na_last? static_cast<TO>(-1) : 0),
+        flip(desc? static_cast<TO>(-1) : 0) {}
+
+    int cmp(size_t a, size_t b) const override {
+      TO ka = key(data[a]);
+      TO kb = key(data[b]);
+      return (ka < kb)? -1 : (ka > kb);
+    }
+
+  private:
+    TO key(TO t) const {
+      constexpr TO EXP
+        = static_cast<TO>(sizeof(TO) == 8? 0x7FF0000000000000ULL : 0x7F800000);
+      constexpr TO SIG
+        = static_cast<TO>(sizeof(TO) == 8? 0x000FFFFFFFFFFFFFULL : 0x007FFFFF);
+      constexpr TO SBT
+        = static_cast<TO>(sizeof(TO) == 8? 0x8000000000000000ULL : 0x80000000);
+      constexpr int SHIFT = sizeof(TO) * 8 - 1;
+      return ((t & EXP) == EXP && (t & SIG) != 0)
+             ? nakey : t ^ (SBT | -(t>>SHIFT)) ^ flip;
+    }
+};
+
+
+template <typename T>
+class StrRowComparator : public RowComparator {
+  const uint8_t* strdata;
+  const T* offs;
+  bool descending;
+  bool nalast;
+
+  public:
+    StrRowComparator(const Column* col, bool desc, bool na_last)
+      : descending(desc), nalast(na_last)
+    {
+      auto scol = static_cast<const StringColumn<T>*>(col);
+      strdata = reinterpret_cast<const uint8_t*>(scol->strdata());
+      offs = scol->offsets();
+    }
+
+    int cmp(size_t a, size_t b) const override {
+      T aend = offs[a];
+      T bend = offs[b];
+      // `compare_offstrings()` returns 1 if the first string is smaller
+      int c = compare_offstrings(strdata, std::abs(offs[a - 1]), aend,
+                                 std::abs(offs[b - 1]), bend);
+      if (aend < 0 || bend < 0) return nalast? c : -c;
+      return descending? c : -c;
+    }
+};
+
+
+static RowComparator* make_row_comparator(const Column* col, bool desc,
+                                          bool nalast)
+{
+  SType stype = col->stype();
+  switch (stype) {
+    case ST_BOOLEAN_I1:
+    case ST_INTEGER_I1: return new IntRowComparator<int8_t>(col, desc, nalast);
+    case ST_INTEGER_I2: return new IntRowComparator<int16_t>(col, desc, nalast);
+    case ST_INTEGER_I4: return new IntRowComparator<int32_t>(col, desc, nalast);
+    case ST_INTEGER_I8: return new IntRowComparator<int64_t>(col, desc, nalast);
+    case ST_REAL_F4:    return new RealRowComparator<uint32_t>(col, desc, nalast);
+    case ST_REAL_F8:    return new RealRowComparator<uint64_t>(col, desc, nalast);
+    case ST_STRING_I4_VCHAR: return new StrRowComparator<int32_t>(col, desc, nalast);
+    case ST_STRING_I8_VCHAR: return new StrRowComparator<int64_t>(col, desc, nalast);
+    default:
+      throw NotImplError() << "Unable to sort Column of stype " << stype;
+  }
+}
+
+
+/**
+ * Lexicographic comparator of rows by several columns.
+ */
+class MultiRowComparator {
+  std::vector<std::unique_ptr<RowComparator>> comparators;
+
+  public:
+    MultiRowComparator(const std::vector<const Column*>& cols,
+                       const std::vector<bool>& desc, bool nalast)
+    {
+      for (size_t j = 0; j < cols.size(); ++j) {
+        comparators.emplace_back(make_row_comparator(cols[j], desc[j], nalast));
+      }
+    }
+
+    int cmp(size_t a, size_t b) const {
+      for (const auto& c : comparators) {
+        int r = c->cmp(a, b);
+        if (r) return r;
+      }
+      return 0;
+    }
+};
+
+
+/**
+ * Temporary file holding the spilled runs of an external sort. The file is
+ * created with `mkstemp()` in the directory `$TMPDIR` (or "/tmp"), so that
+ * its name is unique even if several sorts spill their data at the same time.
+ * The file is memory-mapped for reading with `map()`, and removed when this
+ * object goes out of scope.
+ */
+class SortSpillFile {
+  std::string name;
+  MemoryBuffer* mbuf;
+
+  public:
+    SortSpillFile() : mbuf(nullptr) {
+      const char* tmpdir = std::getenv("TMPDIR");
+      std::string tmpl = std::string(tmpdir && *tmpdir? tmpdir : "/tmp") +
+                         "/datatable-sort-XXXXXX";
+      std::vector<char> buf(tmpl.begin(), tmpl.end());
+      buf.push_back('\0');
+      int fd = mkstemp(buf.data());
+      if (fd == -1) {
+        throw RuntimeError() << "Cannot create temporary file " << tmpl
+                             << ": " << Errno;
+      }
+      close(fd);
+      name = std::string(buf.data());
+    }
+    SortSpillFile(const SortSpillFile&) = delete;
+    SortSpillFile& operator=(const SortSpillFile&) = delete;
+
+    ~SortSpillFile() {
+      if (mbuf) mbuf->release();
+      if (access(name.c_str(), F_OK) == 0) File::remove(name);
+    }
+
+    const std::string& filename() const { return name; }
+
+    const void* map() {
+      mbuf = new MemmapMemBuf(name);
+      return mbuf->get();
+    }
+};
+
+
+/**
+ * Approximate number of bytes used by `SortContext` per row being sorted:
+ * the arrays `order`, `next_o` and `groups` of type `TI`, plus the keys `x`
+ * and `next_x` of at most 8 bytes each.
+ */
+template <typename TI>
+static size_t sort_memory_per_row() {
+  return 3 * sizeof(TI) + 16;
+}
+
+template <typename TI>
+static bool sort_needs_external(size_t nrows) {
+  size_t limit = config::sort_max_memory;
+  return limit && nrows > limit / sort_memory_per_row<TI>();
+}
+
+
+/**
+ * Sort the columns `cols` out-of-core, i.e. using no more than approximately
+ * `config::sort_max_memory` bytes for sorting at any time. The result is the
+ * same as that of `sortby_impl()`.
+ *
+ * The rows are split into consecutive runs of `runlen` rows each. Every run
+ * is sorted by all columns with `SortContext`, and its ordering is appended
+ * to a temporary memory-mapped file. Afterwards the file is mapped back, and
+ * the sorted runs are merged into the final ordering: the output is split
+ * into `nparts` ranges using splitters chosen among samples from all runs,
+ * and each range is merged independently with a k-way heap merge. The ties are
+ * resolved in favor of the run with the smaller index, which keeps the sort
+ * stable. Finally, the groups are found by comparing adjacent rows.
  *
- * The function returns nullptr if there is a runtime error (for example an
- * intermediate buffer cannot be allocated).
+ * Note that the final ordering (and the groups) must still fit in memory,
+ * since they are returned as a RowIndex.
  */
-RowIndex DataTable::sortby(const arr32_t& colindices, bool make_groups) const
+template <typename TI>
+static RowIndex sortby_external(const std::vector<const Column*>& cols,
+                                const std::vector<bool>& desc, bool nalast,
+                                bool make_groups)
 {
-  if (colindices.size() != 1) {
-    throw NotImplError() << "Sorting by multiple columns is not supported yet";
+  const RowIndex& ri = cols[0]->rowindex();
+  size_t n = static_cast<size_t>(cols[0]->nrows);
+  size_t nsortcols = cols.size();
+  size_t runlen = std::max(config::sort_max_memory /
+                           sort_memory_per_row<TI>(), size_t(1));
+  size_t nruns = (n + runlen - 1) / runlen;
+  size_t nth = static_cast<size_t>(config::sort_nthreads);
+
+  // Sort each run, and spill its ordering into the temporary file
+  SortSpillFile spill;
+  {
+    MmapWritableBuffer wb(spill.filename(), n * sizeof(TI));
+    for (size_t r = 0; r < nruns; ++r) {
+      size_t i0 = r * runlen;
+      size_t len = std::min(runlen, n - i0);
+      dt::array<TI> rows(len);
+      TI* rowsdata = rows.data();
+      #pragma omp parallel for schedule(static) num_threads(nth)
+      for (size_t i = 0; i < len; ++i) {
+        int64_t j = static_cast<int64_t>(i0 + i);
+        rowsdata[i] = static_cast<TI>(ri.isabsent()? j : ri.nth(j));
+      }
+      SortContext<TI> sc(cols[0], std::move(rows), desc[0], nalast,
+                         nsortcols > 1);
+      sc.do_sort();
+      for (size_t j = 1; j < nsortcols; ++j) {
+        sc.continue_sort(cols[j], desc[j], j < nsortcols - 1);
+      }
+      dt::array<TI> runorder = sc.release_order();
+      wb.write(len * sizeof(TI), runorder.data());
+    }
+    wb.finalize();
   }
-  if (nrows > INT32_MAX) {
-    throw NotImplError() << "Cannot sort a datatable with " << nrows << " rows";
+  const TI* runs = static_cast<const TI*>(spill.map());
+
+  // Determine the ranges of each run that go into each part of the output
+  MultiRowComparator comparator(cols, desc, nalast);
+  auto rowcmp = [&](TI a, TI b) {
+    return comparator.cmp(static_cast<size_t>(a), static_cast<size_t>(b));
+  };
+  size_t nparts = std::max(std::min(nth, n), size_t(1));
+  std::vector<size_t> bounds((nparts + 1) * nruns);
+  for (size_t r = 0; r < nruns; ++r) {
+    bounds[r] = 0;
+    bounds[nparts * nruns + r] = std::min(runlen, n - r * runlen);
   }
-  if (rowindex.isarr64() || rowindex.length() > INT32_MAX ||
-      rowindex.max() > INT32_MAX) {
-    throw NotImplError() << "Cannot sort a datatable which is based on a "
-                            "datatable with >2**31 rows";
+
+  // The merged output is ordered by (row value, run, position within the
+  // run), since the ties are resolved in favor of the smaller run. The
+  // splitters are chosen among samples taken evenly from every run, so that
+  // the parts are balanced even if the runs have different distributions.
+  struct Sample { TI row; size_t run; size_t pos; };
+  auto sample_less = [&](const Sample& a, const Sample& b) {
+    int c = rowcmp(a.row, b.row);
+    return c < 0 || (c == 0 && (a.run < b.run ||
+                                (a.run == b.run && a.pos < b.pos)));
+  };
+  std::vector<Sample> samples;
+  if (nparts > 1) {
+    size_t nsamples = 8 * nparts;
+    for (size_t r = 0; r < nruns; ++r) {
+      size_t len = bounds[nparts * nruns + r];
+      size_t k = std::min(nsamples, len);
+      for (size_t j = 0; j < k; ++j) {
+        size_t pos = j * len / k;
+        samples.push_back(Sample {runs[r * runlen + pos], r, pos});
+      }
+    }
+    std::sort(samples.begin(), samples.end(), sample_less);
+  }
+  #pragma omp parallel for schedule(dynamic) num_threads(nth)
+  for (size_t p = 1; p < nparts; ++p) {
+    Sample splitter = samples[p * samples.size() / nparts];
+    for (size_t r = 0; r < nruns; ++r) {
+      const TI* run = runs + r * runlen;
+      const TI* end = run + bounds[nparts * nruns + r];
+      size_t pos;
+      if (r == splitter.run) {
+        pos = splitter.pos;
+      } else {
+        // Elements of the runs before the splitter's run go before it if
+        // they are equal to the splitter, and those of the runs after it
+        // only if they are less.
+        int lim = r < splitter.run? 0 : -1;
+        const TI* pp = std::partition_point(run, end,
+            [&](TI v) { return rowcmp(v, splitter.row) <= lim; });
+        pos = static_cast<size_t>(pp - run);
+      }
+      bounds[p * nruns + r] = pos;
+    }
   }
-  Column* col0 = columns[colindices[0]];
-  return col0->sort(make_groups);
-}
 
+  // Offsets of the parts within the output
+  std::vector<size_t> partstart(nparts + 1, 0);
+  for (size_t p = 0; p <= nparts; ++p) {
+    for (size_t r = 0; r < nruns; ++r) partstart[p] += bounds[p * nruns + r];
+  }
 
-static RowIndex sort_tiny(const Column* col, bool make_groups) {
-  int64_t i = col->rowindex().nth(0);
-  RowIndex res = RowIndex::from_slice(i, col->nrows, 1);
+  // Merge the runs within each part
+  dt::array<TI> order(n);
+  TI* out = order.data();
+  #pragma omp parallel for schedule(dynamic) num_threads(nth)
+  for (size_t p = 0; p < nparts; ++p) {
+    const size_t* lo = bounds.data() + p * nruns;
+    const size_t* hi = lo + nruns;
+    size_t k = partstart[p];
+    std::vector<size_t> pos(lo, hi);
+    std::vector<size_t> heap;
+    for (size_t r = 0; r < nruns; ++r) {
+      if (pos[r] < hi[r]) heap.push_back(r);
+    }
+    // `after(a, b)` is true if the current element of run `a` should be
+    // merged after the current element of run `b`
+    auto after = [&](size_t a, size_t b) {
+      int c = rowcmp(runs[a * runlen + pos[a]], runs[b * runlen + pos[b]]);
+      return c > 0 || (c == 0 && a > b);
+    };
+    std::make_heap(heap.begin(), heap.end(), after);
+    while (!heap.empty()) {
+      std::pop_heap(heap.begin(), heap.end(), after);
+      size_t r = heap.back();
+      out[k++] = runs[r * runlen + pos[r]];
+      if (++pos[r] < hi[r]) {
+        std::push_heap(heap.begin(), heap.end(), after);
+      } else {
+        heap.pop_back();
+      }
+    }
+  }
+
+  // Record the starting positions of the groups within each part. This is
+  // done only after all parts were merged, since the first element of each
+  // part is compared with the last element of the previous part.
+  std::vector<std::vector<TI>> partgroups(make_groups? nparts : 0);
   if (make_groups) {
-    arr32_t grps(static_cast<size_t>(col->nrows) + 1);
-    grps[0] = 0;
-    if (col->nrows) grps[1] = 1;
-    res.set_groups(std::move(grps));
+    #pragma omp parallel for schedule(dynamic) num_threads(nth)
+    for (size_t p = 0; p < nparts; ++p) {
+      std::vector<TI>& starts = partgroups[p];
+      for (size_t i = partstart[p]; i < partstart[p + 1]; ++i) {
+        if (i == 0 || rowcmp(out[i - 1], out[i]) != 0) {
+          starts.push_back(static_cast<TI>(i));
+        }
+      }
+    }
+  }
+
+  RowIndex res = SortContext<TI>::_make_rowindex(std::move(order));
+  if (make_groups) {
+    size_t ngroups = 0;
+    for (const auto& starts : partgroups) ngroups += starts.size();
+    dt::array<TI> groups(ngroups + 1);
+    TI* g = groups.data();
+    for (const auto& starts : partgroups) {
+      std::memcpy(g, starts.data(), starts.size() * sizeof(TI));
+      g += starts.size();
+    }
+    *g = static_cast<TI>(n);
+    res.set_groups(std::move(groups));
   }
   return res;
 }
 
 
+
+template <typename TI>
+static RowIndex sortby_impl(const std::vector<const Column*>& cols,
+                            const std::vector<bool>& desc, bool nalast,
+                            bool make_groups)
+{
+  if (sort_needs_external<TI>(static_cast<size_t>(cols[0]->nrows))) {
+    return sortby_external<TI>(cols, desc, nalast, make_groups);
+  }
+  size_t nsortcols = cols.size();
+  SortContext<TI> sc(cols[0], desc[0], nalast, make_groups || nsortcols > 1);
+  sc.do_sort();
+  for (size_t j = 1; j < nsortcols; ++j) {
+    bool last = (j == nsortcols - 1);
+    sc.continue_sort(cols[j], desc[j], make_groups || !last);
+  }
+  return sc.get_result();
+}
+
+
+/**
+ * Sort the DataTable by the columns `colindices`, and return the ordering as
+ * a RowIndex object. The first column is sorted fully, and then each
+ * subsequent column is used to break the ties among the groups of equal
+ * values produced by the previous columns. A negative index `i` denotes
+ * column `~i` (i.e. `-i - 1`) sorted in descending order. If `na_last` is
+ * true, then NAs are placed after all other values. The data in the DataTable
+ * will not be modified.
+ */
+RowIndex DataTable::sortby(const arr32_t& colindices, bool make_groups,
+                           bool na_last) const
+{
+  size_t nsortcols = colindices.size();
+  if (nsortcols == 0) {
+    throw ValueError() << "At least one column is required for sorting";
+  }
+  std::vector<const Column*> cols;
+  std::vector<bool> desc;
+  for (size_t j = 0; j < nsortcols; ++j) {
+    int32_t i = colindices[j];
+    bool descending = (i < 0);
+    if (descending) i = ~i;
+    if (i >= ncols) {
+      throw ValueError() << "Invalid column index " << colindices[j]
+                         << " for a datatable with " << ncols << " columns";
+    }
+    cols.push_back(columns[i]);
+    desc.push_back(descending);
+  }
+  if (nrows <= 1) {
+    return sort_tiny(cols[0], make_groups);
+  }
+  if (nsortcols == 1 && !desc[0] && !na_last) {
+    // Use the cached ordering of the column, if available
+    return cols[0]->sort(make_groups);
+  }
+  return sort_needs_int64(cols[0])
+         ? sortby_impl<int64_t>(cols, desc, na_last, make_groups)
+         : sortby_impl<int32_t>(cols, desc, na_last, make_groups);
+}
+
+
+/**
+ * Sort a single column in ascending order (with NAs first), taking advantage
+ * of the presortedness of the data described by `stats` (which may be null):
+ * strictly decreasing data is reversed, and data consisting of only a few
+ * ascending runs is merged instead of being radix-sorted. Columns too large
+ * for `config::sort_max_memory` are sorted externally.
+ */
+template <typename TI>
+static RowIndex sort_column_impl(const Column* col, Stats* stats,
+                                 bool make_groups)
+{
+  if (sort_needs_external<TI>(static_cast<size_t>(col->nrows))) {
+    return sortby_external<TI>({col}, {false}, false, make_groups);
+  }
+  bool reverse = stats && stats->is_reverse_sorted(col);
+  bool merge = !reverse && stats &&
+               (stats->is_sorted(col) ||
+                static_cast<size_t>(stats->nruns(col)) <=
+                  config::sort_max_merge_runs);
+  SortContext<TI> sc(col, false, false, make_groups, !(reverse || merge));
+  if (reverse) {
+    sc.do_reverse();
+  } else if (merge) {
+    const std::vector<int64_t>& runstarts = stats->run_starts();
+    bool known = runstarts.size() + 1 == static_cast<size_t>(stats->nruns(col));
+    sc.do_merge_runs(known? &runstarts : nullptr);
+  } else {
+    sc.do_sort();
+  }
+  return sc.get_result();
+}
+
+
+/**
+ * Sort the column, and return its ordering as a RowIndex object. This function
+ * will choose the most appropriate algorithm for sorting. The data in column
+ * `col` will not be modified.
+ *
+ * When the groups are requested (by a groupby, or by the "sorted" stats such
+ * as nunique), the ordering together with the groups is cached in the
+ * column's Stats, so that subsequent sorts, groupbys and stats on the same
+ * column do not need to sort it again. A plain sort neither computes the
+ * groups nor stores its result, since the cache occupies memory for as long
+ * as the column lives; it does reuse the cached ordering if there is one.
+ * Such ordering is returned with its groups hidden (the indices are shared,
+ * not copied): a RowIndex with groups attached is treated as a groupby by the
+ * reduce functions.
+ */
 RowIndex Column::sort(bool make_groups) const {
   if (nrows <= 1) {
     return sort_tiny(this, make_groups);
   }
-  SortContext sc(this, make_groups);
+  Stats* colstats = get_stats();
+  RowIndex res = colstats? colstats->get_ordering() : RowIndex();
+  if (!res) {
+    if (colstats && !make_groups && ri.isabsent() &&
+        colstats->is_sorted(this)) {
+      // The column is already sorted: its ordering is the identity
+      return RowIndex::from_slice(0, nrows, 1);
+    }
+    res = sort_needs_int64(this)
+          ? sort_column_impl<int64_t>(this, colstats, make_groups)
+          : sort_column_impl<int32_t>(this, colstats, make_groups);
+    if (colstats && make_groups) colstats->set_ordering(res);
+    return res;
+  }
+  if (make_groups || !colstats) {
+    return res;
+  }
+  return res.without_groups();
+}
+
+
+template <typename TI>
+static RowIndex topk_impl(const Column* col, size_t k, bool desc,
+                          bool make_groups)
+{
+  // NAs are always placed last, so that they are selected only if there are
+  // not enough valid values in the column.
+  dt::array<TI> rows;
+  {
+    SortContext<TI> sc(col, desc, true, false);
+    rows = sc.select_topk(k);
+  }
+  SortContext<TI> sc(col, std::move(rows), desc, true, make_groups);
   sc.do_sort();
   return sc.get_result();
 }
+
+
+/**
+ * Find the `k` smallest (or largest, if `descending` is true) values in the
+ * column, and return their ordering as a RowIndex object of length `k`. The
+ * result is the same as the first `k` elements of the full sort with NAs
+ * placed last, however the full ordering of the column is never computed:
+ * the rows are found via the radix select algorithm, after which only these
+ * `k` rows are sorted.
+ */
+RowIndex Column::topk(size_t k, bool descending, bool make_groups) const {
+  size_t zrows = static_cast<size_t>(nrows);
+  if (k > zrows) k = zrows;
+  if (k == 0) {
+    return RowIndex::from_slice(0, 0, 1);
+  }
+  return sort_needs_int64(this)
+         ? topk_impl<int64_t>(this, k, descending, make_groups)
+         : topk_impl<int32_t>(this, k, descending, make_groups);
+}
@@ -7,8 +7,11 @@
 //------------------------------------------------------------------------------
 #ifndef dt_SORT_h
 #define dt_SORT_h
+#include <vector>
 #include "utils/array.h"  // arr32_t
 
+class Column;
+
 
 struct radix_range {
   size_t size;
@@ -16,6 +19,10 @@ struct radix_range {
 };
 
 
+// Whether sorting or grouping by column `col` requires 64-bit row indices
+bool sort_needs_int64(const Column* col);
+
+
 
 /**
  * Helper class to collect grouping information while sorting.
@@ -35,6 +42,9 @@ struct radix_range {
  * push(grp)
  *     Add a single group of size `grp`.
  *
+ * push_distinct(n)
+ *     Add `n` groups of size 1 each (in parallel).
+ *
  * from_data(data, indices, n)
  *     Given sorted data in the form `[data[indices[i]] for i in range(n)]`,
  *     extract and add group information from it. The groups are detected based
@@ -55,6 +65,10 @@ struct radix_range {
  *     Fill the grouping information from the data histogram, as described
  *     in the documentation for `SortContext` class.
  *
+ * The class is parametrized by the type `TI` of the group sizes: this is
+ * `int32_t` when sorting frames with less than 2**31 rows, and `int64_t`
+ * otherwise.
+ *
  * Internal parameters
  * -------------------
  * groups
@@ -69,25 +83,27 @@ struct radix_range {
  *     `groups[count - 1]`.
  *
  */
-// TODO: Add support for 64-bit groups
+template <typename TI>
 class GroupGatherer {
   private:
-    int32_t* groups;  // externally owned pointer
-    int32_t  count;
-    int32_t  cumsize;
+    TI* groups;  // externally owned pointer
+    TI  count;
+    TI  cumsize;
 
   public:
     GroupGatherer();
-    void init(int32_t* data, int32_t cumsize0);
+    void init(TI* data, TI cumsize0);
 
-    int32_t* data() const { return groups; }
-    int32_t  size() const { return count; }
-    int32_t  cumulative_size() const { return cumsize; }
+    TI*  data() const { return groups; }
+    TI   size() const { return count; }
+    TI   cumulative_size() const { return cumsize; }
     operator bool() const { return !!groups; }
 
     void push(size_t grp);
-    template <typename T, typename V> void from_data(const T*, V*, size_t);
-    template <typename T, typename V> void from_data(const uint8_t*, const T*, T, V*, size_t);
+    void push_distinct(size_t n);
+    void from_breaks(const std::vector<std::vector<TI>>& breaks, size_t n);
+    template <typename T> void from_data(const T*, TI*, size_t);
+    template <typename T> void from_data(const uint8_t*, const T*, T, TI*, size_t);
     void from_chunks(radix_range* rrmap, size_t nradixes);
     void from_histogram(size_t* histogram, size_t nchunks, size_t nradixes);
 };
@@ -99,42 +115,73 @@ class GroupGatherer {
 //------------------------------------------------------------------------------
 
 template <typename T, typename V>
-void insert_sort_keys(const T* x, V* o, V* oo, int n, GroupGatherer& gg);
+void insert_sort_keys(const T* x, V* o, V* oo, int n, GroupGatherer<V>& gg);
 
 template <typename T, typename V>
-void insert_sort_values(const T* x, V* o, int n, GroupGatherer& gg);
+void insert_sort_values(const T* x, V* o, int n, GroupGatherer<V>& gg);
 
 template <typename T, typename V>
-void insert_sort_keys_str(const uint8_t*, const T*, T, V*, V*, int, GroupGatherer&);
+void insert_sort_keys_str(const uint8_t*, const T*, T, V*, V*, int,
+                          GroupGatherer<V>&, bool descending, bool nalast);
 
 template <typename T, typename V>
-void insert_sort_values_str(const uint8_t*, const T*, T, V*, int, GroupGatherer&);
+void insert_sort_values_str(const uint8_t*, const T*, T, V*, int,
+                            GroupGatherer<V>&, bool descending, bool nalast);
 
 template <typename T>
 int compare_offstrings(const uint8_t*, T, T, T, T);
 
 
 
-extern template void insert_sort_keys(const uint8_t*,  int32_t*, int32_t*, int, GroupGatherer&);
-extern template void insert_sort_keys(const uint16_t*, int32_t*, int32_t*, int, GroupGatherer&);
-extern template void insert_sort_keys(const uint32_t*, int32_t*, int32_t*, int, GroupGatherer&);
-extern template void insert_sort_keys(const uint64_t*, int32_t*, int32_t*, int, GroupGatherer&);
+extern template class GroupGatherer<int32_t>;
+extern template class GroupGatherer<int64_t>;
 
-extern template void insert_sort_values(const uint8_t*,  int32_t*, int, GroupGatherer&);
-extern template void insert_sort_values(const uint16_t*, int32_t*, int, GroupGatherer&);
-extern template void insert_sort_values(const uint32_t*, int32_t*, int, GroupGatherer&);
-extern template void insert_sort_values(const uint64_t*, int32_t*, int, GroupGatherer&);
+extern template void insert_sort_keys(const uint8_t*,  int32_t*, int32_t*, int, GroupGatherer<int32_t>&);
+extern template void insert_sort_keys(const uint16_t*, int32_t*, int32_t*, int, GroupGatherer<int32_t>&);
+extern template void insert_sort_keys(const uint32_t*, int32_t*, int32_t*, int, GroupGatherer<int32_t>&);
+extern template void insert_sort_keys(const uint64_t*, int32_t*, int32_t*, int, GroupGatherer<int32_t>&);
 
-extern template void insert_sort_keys_str(const uint8_t*, const int32_t*, int32_t, int32_t*, int32_t*, int, GroupGatherer&);
-extern template void insert_sort_values_str(const uint8_t*, const int32_t*, int32_t, int32_t*, int, GroupGatherer&);
+extern template void insert_sort_values(const uint8_t*,  int32_t*, int, GroupGatherer<int32_t>&);
+extern template void insert_sort_values(const uint16_t*, int32_t*, int, GroupGatherer<int32_t>&);
+extern template void insert_sort_values(const uint32_t*, int32_t*, int, GroupGatherer<int32_t>&);
+extern template void insert_sort_values(const uint64_t*, int32_t*, int, GroupGatherer<int32_t>&);
 
-extern template int compare_offstrings(const uint8_t*, int32_t, int32_t, int32_t, int32_t);
+extern template void insert_sort_keys_str(const uint8_t*, const int32_t*, int32_t, int32_t*, int32_t*, int, GroupGatherer<int32_t>&, bool, bool);
+extern template void insert_sort_keys_str(const uint8_t*, const int64_t*, int64_t, int32_t*, int32_t*, int, GroupGatherer<int32_t>&, bool, bool);
+extern template void insert_sort_values_str(const uint8_t*, const int32_t*, int32_t, int32_t*, int, GroupGatherer<int32_t>&, bool, bool);
+extern template void insert_sort_values_str(const uint8_t*, const int64_t*, int64_t, int32_t*, int, GroupGatherer<int32_t>&, bool, bool);
 
-extern template void GroupGatherer::from_data(const uint8_t*,  int32_t*, size_t);
-extern template void GroupGatherer::from_data(const uint16_t*, int32_t*, size_t);
-extern template void GroupGatherer::from_data(const uint32_t*, int32_t*, size_t);
-extern template void GroupGatherer::from_data(const uint64_t*, int32_t*, size_t);
-extern template void GroupGatherer::from_data(const uint8_t*, const int32_t*, int32_t, int32_t*, size_t);
+extern template void GroupGatherer<int32_t>::from_data(const uint8_t*,  int32_t*, size_t);
+extern template void GroupGatherer<int32_t>::from_data(const uint16_t*, int32_t*, size_t);
+extern template void GroupGatherer<int32_t>::from_data(const uint32_t*, int32_t*, size_t);
+extern template void GroupGatherer<int32_t>::from_data(const uint64_t*, int32_t*, size_t);
+extern template void GroupGatherer<int32_t>::from_data(const uint8_t*, const int32_t*, int32_t, int32_t*, size_t);
+extern template void GroupGatherer<int32_t>::from_data(const uint8_t*, const int64_t*, int64_t, int32_t*, size_t);
+
+extern template void insert_sort_keys(const uint8_t*,  int64_t*, int64_t*, int, GroupGatherer<int64_t>&);
+extern template void insert_sort_keys(const uint16_t*, int64_t*, int64_t*, int, GroupGatherer<int64_t>&);
+extern template void insert_sort_keys(const uint32_t*, int64_t*, int64_t*, int, GroupGatherer<int64_t>&);
+extern template void insert_sort_keys(const uint64_t*, int64_t*, int64_t*, int, GroupGatherer<int64_t>&);
+
+extern template void insert_sort_values(const uint8_t*,  int64_t*, int, GroupGatherer<int64_t>&);
+extern template void insert_sort_values(const uint16_t*, int64_t*, int, GroupGatherer<int64_t>&);
+extern template void insert_sort_values(const uint32_t*, int64_t*, int, GroupGatherer<int64_t>&);
+extern template void insert_sort_values(const uint64_t*, int64_t*, int, GroupGatherer<int64_t>&);
+
+extern template void insert_sort_keys_str(const uint8_t*, const int32_t*, int32_t, int64_t*, int64_t*, int, GroupGatherer<int64_t>&, bool, bool);
+extern template void insert_sort_keys_str(const uint8_t*, const int64_t*, int64_t, int64_t*, int64_t*, int, GroupGatherer<int64_t>&, bool, bool);
+extern template void insert_sort_values_str(const uint8_t*, const int32_t*, int32_t, int64_t*, int, GroupGatherer<int64_t>&, bool, bool);
+extern template void insert_sort_values_str(const uint8_t*, const int64_t*, int64_t, int64_t*, int, GroupGatherer<int64_t>&, bool, bool);
+
+extern template void GroupGatherer<int64_t>::from_data(const uint8_t*,  int64_t*, size_t);
+extern template void GroupGatherer<int64_t>::from_data(const uint16_t*, int64_t*, size_t);
+extern template void GroupGatherer<int64_t>::from_data(const uint32_t*, int64_t*, size_t);
+extern template void GroupGatherer<int64_t>::from_data(const uint64_t*, int64_t*, size_t);
+extern template void GroupGatherer<int64_t>::from_data(const uint8_t*, const int32_t*, int32_t, int64_t*, size_t);
+extern template void GroupGatherer<int64_t>::from_data(const uint8_t*, const int64_t*, int64_t, int64_t*, size_t);
+
+extern template int compare_offstrings(const uint8_t*, int32_t, int32_t, int32_t, int32_t);
+extern template int compare_offstrings(const uint8_t*, int64_t, int64_t, int64_t, int64_t);
 
 
 #endif
@@ -8,28 +8,77 @@
 #include "sort.h"
 #include <utility>  // std::move
 #include "utils/assert.h"
+#include "utils/omp.h"
 
 
 
-GroupGatherer::GroupGatherer()
+template <typename TI>
+GroupGatherer<TI>::GroupGatherer()
   : groups(nullptr) {}
 
 
-void GroupGatherer::init(int32_t* data, int32_t cumsize0) {
+template <typename TI>
+void GroupGatherer<TI>::init(TI* data, TI cumsize0) {
   groups = data;
   count = 0;
   cumsize = cumsize0;
 }
 
 
-void GroupGatherer::push(size_t grp) {
-  cumsize += static_cast<int32_t>(grp);
+template <typename TI>
+void GroupGatherer<TI>::push(size_t grp) {
+  cumsize += static_cast<TI>(grp);
   groups[count++] = cumsize;
 }
 
 
-template <typename T, typename V>
-void GroupGatherer::from_data(const T* data, V* o, size_t n) {
+/**
+ * Add `n` groups of size 1, i.e. the case when all the elements are distinct.
+ */
+template <typename TI>
+void GroupGatherer<TI>::push_distinct(size_t n) {
+  TI* grps = groups + count;
+  TI cumsize0 = cumsize;
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < n; ++i) {
+    grps[i] = cumsize0 + static_cast<TI>(i + 1);
+  }
+  count += static_cast<TI>(n);
+  cumsize += static_cast<TI>(n);
+}
+
+
+/**
+ * Add the groups of `n` elements, given the positions where each new group
+ * starts (except the first one, which always starts at 0). The positions are
+ * collected by chunks, see `SortContext::_find_breaks()`, and the chunks are
+ * copied into the groups array in parallel.
+ */
+template <typename TI>
+void GroupGatherer<TI>::from_breaks(
+  const std::vector<std::vector<TI>>& breaks, size_t n)
+{
+  size_t nchunks = breaks.size();
+  std::vector<size_t> offsets(nchunks + 1, 0);
+  for (size_t i = 0; i < nchunks; ++i) {
+    offsets[i + 1] = offsets[i] + breaks[i].size();
+  }
+  TI* grps = groups + count;
+  TI cumsize0 = cumsize;
+  #pragma omp parallel for schedule(static, 1)
+  for (size_t i = 0; i < nchunks; ++i) {
+    TI* out = grps + offsets[i];
+    for (TI j : breaks[i]) *out++ = cumsize0 + j;
+  }
+  grps[offsets[nchunks]] = cumsize0 + static_cast<TI>(n);
+  count += static_cast<TI>(offsets[nchunks] + 1);
+  cumsize += static_cast<TI>(n);
+}
+
+
+template <typename TI>
+template <typename T>
+void GroupGatherer<TI>::from_data(const T* data, TI* o, size_t n) {
   if (n == 0) return;
   T curr_value = data[o[0]];
   size_t lasti = 0;
@@ -45,9 +94,10 @@ void GroupGatherer::from_data(const T* data, V* o, size_t n) {
 }
 
 
-template <typename T, typename V>
-void GroupGatherer::from_data(
-  const uint8_t* strdata, const T* stroffs, T start, V* o, size_t n)
+template <typename TI>
+template <typename T>
+void GroupGatherer<TI>::from_data(
+  const uint8_t* strdata, const T* stroffs, T start, TI* o, size_t n)
 {
   if (n == 0) return;
   T olast0 = std::abs(stroffs[o[0] - 1]) + start;
@@ -67,7 +117,8 @@ void GroupGatherer::from_data(
 }
 
 
-void GroupGatherer::from_chunks(radix_range* rrmap, size_t nradixes) {
+template <typename TI>
+void GroupGatherer<TI>::from_chunks(radix_range* rrmap, size_t nradixes) {
   xassert(count == 0);
   size_t dest_off = 0;
   for (size_t i = 0; i < nradixes; ++i) {
@@ -76,23 +127,24 @@ void GroupGatherer::from_chunks(radix_range* rrmap, size_t nradixes) {
     size_t grp_off = rrmap[i].offset;
     if (grp_off != dest_off) {
       std::memmove(groups + dest_off, groups + grp_off,
-                   grp_size * sizeof(int32_t));
+                   grp_size * sizeof(TI));
     }
     dest_off += grp_size;
   }
-  count = static_cast<int32_t>(dest_off);
+  count = static_cast<TI>(dest_off);
   cumsize = groups[count - 1];
 }
 
 
-void GroupGatherer::from_histogram(
+template <typename TI>
+void GroupGatherer<TI>::from_histogram(
   size_t* histogram, size_t nchunks, size_t nradixes)
 {
   xassert(count == 0);
   size_t* rrendoffsets = histogram + (nchunks - 1) * nradixes;
-  int32_t off0 = 0;
+  TI off0 = 0;
   for (size_t i = 0; i < nradixes; ++i) {
-    int32_t off1 = static_cast<int32_t>(rrendoffsets[i]);
+    TI off1 = static_cast<TI>(rrendoffsets[i]);
     if (off1 > off0) {
       groups[count++] = cumsize + off1;
       off0 = off1;
@@ -102,8 +154,19 @@ void GroupGatherer::from_histogram(
 }
 
 
-template void GroupGatherer::from_data(const uint8_t*,  int32_t*, size_t);
-template void GroupGatherer::from_data(const uint16_t*, int32_t*, size_t);
-template void GroupGatherer::from_data(const uint32_t*, int32_t*, size_t);
-template void GroupGatherer::from_data(const uint64_t*, int32_t*, size_t);
-template void GroupGatherer::from_data(const uint8_t*, const int32_t*, int32_t, int32_t*, size_t);
+template class GroupGatherer<int32_t>;
+template class GroupGatherer<int64_t>;
+
+template void GroupGatherer<int32_t>::from_data(const uint8_t*,  int32_t*, size_t);
+template void GroupGatherer<int32_t>::from_data(const uint16_t*, int32_t*, size_t);
+template void GroupGatherer<int32_t>::from_data(const uint32_t*, int32_t*, size_t);
+template void GroupGatherer<int32_t>::from_data(const uint64_t*, int32_t*, size_t);
+template void GroupGatherer<int32_t>::from_data(const uint8_t*, const int32_t*, int32_t, int32_t*, size_t);
+template void GroupGatherer<int32_t>::from_data(const uint8_t*, const int64_t*, int64_t, int32_t*, size_t);
+
+template void GroupGatherer<int64_t>::from_data(const uint8_t*,  int64_t*, size_t);
+template void GroupGatherer<int64_t>::from_data(const uint16_t*, int64_t*, size_t);
+template void GroupGatherer<int64_t>::from_data(const uint32_t*, int64_t*, size_t);
+template void GroupGatherer<int64_t>::from_data(const uint64_t*, int64_t*, size_t);
+template void GroupGatherer<int64_t>::from_data(const uint8_t*, const int32_t*, int32_t, int64_t*, size_t);
+template void GroupGatherer<int64_t>::from_data(const uint8_t*, const int64_t*, int64_t, int64_t*, size_t);
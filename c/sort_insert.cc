@@ -58,6 +58,23 @@ int compare_offstrings(
 }
 
 
+/**
+ * Same as `compare_offstrings()`, but takes into account the sorting direction
+ * and the position of NAs: when `descending` is true the order of non-NA
+ * strings is reversed, and when `nalast` is true NA strings compare greater
+ * than any other string.
+ */
+template <typename T>
+static inline int compare_offstrings_ordered(
+    const uint8_t* strdata, T aoff0, T aoff1, T boff0, T boff1,
+    bool descending, bool nalast)
+{
+  int cmp = compare_offstrings(strdata, aoff0, aoff1, boff0, boff1);
+  if (aoff1 < 0 || boff1 < 0) return nalast? -cmp : cmp;
+  return descending? -cmp : cmp;
+}
+
+
 
 //==============================================================================
 // Insertion sort of arrays with primitive C types
@@ -79,7 +96,7 @@ int compare_offstrings(
  *      usually an ordering, this type is either `int32_t` or `int64_t`.
  */
 template <typename T, typename V>
-void insert_sort_values(const T* x, V* o, int n, GroupGatherer& gg)
+void insert_sort_values(const T* x, V* o, int n, GroupGatherer<V>& gg)
 {
   o[0] = 0;
   for (int i = 1; i < n; ++i) {
@@ -115,7 +132,7 @@ void insert_sort_values(const T* x, V* o, int n, GroupGatherer& gg)
  *      usually an ordering, this type is either `int32_t` or `int64_t`.
  */
 template <typename T, typename V>
-void insert_sort_keys(const T* x, V* o, V* tmp, int n, GroupGatherer& gg)
+void insert_sort_keys(const T* x, V* o, V* tmp, int n, GroupGatherer<V>& gg)
 {
   insert_sort_values(x, tmp, n, gg);
   for (int i = 0; i < n; ++i) {
@@ -136,12 +153,13 @@ void insert_sort_keys(const T* x, V* o, V* tmp, int n, GroupGatherer& gg)
 // array of offsets within `strdata` (each `stroffs[i]` gives the end of
 // string `i`; the beginning of the first string is at offset `stroffs[-1]`).
 // Finally, parameter `strstart` instructs to compare the strings starting from
-// that byte.
+// that byte. Flags `descending` and `nalast` determine the sorting direction
+// and the position of NA strings.
 //
 template <typename T, typename V>
 void insert_sort_keys_str(
     const uint8_t* strdata, const T* stroffs, T strstart, V* o, V* tmp, int n,
-    GroupGatherer& gg)
+    GroupGatherer<V>& gg, bool descending, bool nalast)
 {
   int j;
   tmp[0] = 0;
@@ -152,7 +170,8 @@ void insert_sort_keys_str(
       V k = tmp[j - 1];
       T off0k = std::abs(stroffs[o[k]-1]) + strstart;
       T off1k = stroffs[o[k]];
-      int cmp = compare_offstrings(strdata, off0i, off1i, off0k, off1k);
+      int cmp = compare_offstrings_ordered(strdata, off0i, off1i, off0k, off1k,
+                                           descending, nalast);
       if (cmp != 1) break;
       tmp[j] = tmp[j-1];
     }
@@ -171,7 +190,7 @@ void insert_sort_keys_str(
 template <typename T, typename V>
 void insert_sort_values_str(
     const uint8_t* strdata, const T* stroffs, T strstart, V* o, int n,
-    GroupGatherer& gg)
+    GroupGatherer<V>& gg, bool descending, bool nalast)
 {
   int j;
   o[0] = 0;
@@ -182,7 +201,8 @@ void insert_sort_values_str(
       V k = o[j - 1];
       T off0k = std::abs(stroffs[k-1]) + strstart;
       T off1k = stroffs[k];
-      int cmp = compare_offstrings(strdata, off0i, off1i, off0k, off1k);
+      int cmp = compare_offstrings_ordered(strdata, off0i, off1i, off0k, off1k,
+                                           descending, nalast);
       if (cmp != 1) break;
       o[j] = o[j-1];
     }
@@ -199,16 +219,35 @@ void insert_sort_values_str(
 // Explicitly instantate template functions
 //==============================================================================
 
-template void insert_sort_keys(const uint8_t*,  int32_t*, int32_t*, int, GroupGatherer&);
-template void insert_sort_keys(const uint16_t*, int32_t*, int32_t*, int, GroupGatherer&);
-template void insert_sort_keys(const uint32_t*, int32_t*, int32_t*, int, GroupGatherer&);
-template void insert_sort_keys(const uint64_t*, int32_t*, int32_t*, int, GroupGatherer&);
+template void insert_sort_keys(const uint8_t*,  int32_t*, int32_t*, int, GroupGatherer<int32_t>&);
+template void insert_sort_keys(const uint16_t*, int32_t*, int32_t*, int, GroupGatherer<int32_t>&);
+template void insert_sort_keys(const uint32_t*, int32_t*, int32_t*, int, GroupGatherer<int32_t>&);
+template void insert_sort_keys(const uint64_t*, int32_t*, int32_t*, int, GroupGatherer<int32_t>&);
+
+template void insert_sort_values(const uint8_t*,  int32_t*, int, GroupGatherer<int32_t>&);
+template void insert_sort_values(const uint16_t*, int32_t*, int, GroupGatherer<int32_t>&);
+template void insert_sort_values(const uint32_t*, int32_t*, int, GroupGatherer<int32_t>&);
+template void insert_sort_values(const uint64_t*, int32_t*, int, GroupGatherer<int32_t>&);
+
+template void insert_sort_keys_str(const uint8_t*, const int32_t*, int32_t, int32_t*, int32_t*, int, GroupGatherer<int32_t>&, bool, bool);
+template void insert_sort_keys_str(const uint8_t*, const int64_t*, int64_t, int32_t*, int32_t*, int, GroupGatherer<int32_t>&, bool, bool);
+template void insert_sort_values_str(const uint8_t*, const int32_t*, int32_t, int32_t*, int, GroupGatherer<int32_t>&, bool, bool);
+template void insert_sort_values_str(const uint8_t*, const int64_t*, int64_t, int32_t*, int, GroupGatherer<int32_t>&, bool, bool);
+
+template void insert_sort_keys(const uint8_t*,  int64_t*, int64_t*, int, GroupGatherer<int64_t>&);
+template void insert_sort_keys(const uint16_t*, int64_t*, int64_t*, int, GroupGatherer<int64_t>&);
+template void insert_sort_keys(const uint32_t*, int64_t*, int64_t*, int, GroupGatherer<int64_t>&);
+template void insert_sort_keys(const uint64_t*, int64_t*, int64_t*, int, GroupGatherer<int64_t>&);
+
+template void insert_sort_values(const uint8_t*,  int64_t*, int, GroupGatherer<int64_t>&);
+template void insert_sort_values(const uint16_t*, int64_t*, int, GroupGatherer<int64_t>&);
+template void insert_sort_values(const uint32_t*, int64_t*, int, GroupGatherer<int64_t>&);
+template void insert_sort_values(const uint64_t*, int64_t*, int, GroupGatherer<int64_t>&);
 
-template void insert_sort_values(const uint8_t*,  int32_t*, int, GroupGatherer&);
-template void insert_sort_values(const uint16_t*, int32_t*, int, GroupGatherer&);
-template void insert_sort_values(const uint32_t*, int32_t*, int, GroupGatherer&);
-template void insert_sort_values(const uint64_t*, int32_t*, int, GroupGatherer&);
+template void insert_sort_keys_str(const uint8_t*, const int32_t*, int32_t, int64_t*, int64_t*, int, GroupGatherer<int64_t>&, bool, bool);
+template void insert_sort_keys_str(const uint8_t*, const int64_t*, int64_t, int64_t*, int64_t*, int, GroupGatherer<int64_t>&, bool, bool);
+template void insert_sort_values_str(const uint8_t*, const int32_t*, int32_t, int64_t*, int, GroupGatherer<int64_t>&, bool, bool);
+template void insert_sort_values_str(const uint8_t*, const int64_t*, int64_t, int64_t*, int, GroupGatherer<int64_t>&, bool, bool);
 
-template void insert_sort_keys_str(const uint8_t*, const int32_t*, int32_t, int32_t*, int32_t*, int, GroupGatherer&);
-template void insert_sort_values_str(const uint8_t*, const int32_t*, int32_t, int32_t*, int, GroupGatherer&);
 template int compare_offstrings(const uint8_t*, int32_t, int32_t, int32_t, int32_t);
+template int compare_offstrings(const uint8_t*, int64_t, int64_t, int64_t, int64_t);
@@ -6,11 +6,18 @@
 // © H2O.ai 2018
 //------------------------------------------------------------------------------
 #include "stats.h"
-#include <cmath>     // std::isinf, std::sqrt
+#include <algorithm> // std::sort
+#include <cmath>     // std::isinf, std::sqrt, std::log, std::ldexp
+#include <cstring>   // std::memcpy
 #include <limits>    // std::numeric_limits
+#include <vector>    // std::vector
 #include "column.h"
+#include "options.h"
 #include "rowindex.h"
+#include "sort.h"
 #include "utils.h"
+#include "utils/exceptions.h"
+#include "utils/hash.h"
 #include "utils/omp.h"
 
 
@@ -23,12 +30,195 @@ constexpr T infinity() {
 
 
 
+//==============================================================================
+// HyperLogLog
+//==============================================================================
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+  for (size_t i = 0; i < NREGISTERS; ++i) {
+    if (other.regs[i] > regs[i]) regs[i] = other.regs[i];
+  }
+}
+
+// Helper functions of the improved estimator (Ertl, 2017): the contributions
+// of the empty registers (sigma) and of the saturated ones (tau), computed as
+// converging series for x = the fraction of such registers.
+static double hll_sigma(double x) {
+  if (x == 1) return std::numeric_limits<double>::infinity();
+  double y = 1, z = x, zprev;
+  do {
+    x *= x;
+    zprev = z;
+    z += x * y;
+    y += y;
+  } while (z != zprev);
+  return z;
+}
+
+static double hll_tau(double x) {
+  if (x == 0 || x == 1) return 0;
+  double y = 1, z = 1 - x, zprev;
+  do {
+    x = std::sqrt(x);
+    zprev = z;
+    y *= 0.5;
+    z -= (1 - x) * (1 - x) * y;
+  } while (z != zprev);
+  return z / 3;
+}
+
+/**
+ * The raw HyperLogLog estimate is biased for small cardinalities, and the
+ * usual switch to "linear counting" below 2.5m leaves a bump of about +2% in
+ * the bias (and 3% in the error) around the switching point. Instead, the
+ * "improved raw estimator" of Ertl (2017) is used: it takes into account the
+ * numbers of empty and saturated registers, and is nearly unbiased over the
+ * whole range of cardinalities, with no empirical correction tables. Its
+ * relative standard error is about 1.04/sqrt(m), i.e. 1.6% for m = 4096.
+ */
+int64_t HyperLogLog::estimate() const {
+  constexpr int Q = 64 - PRECISION;
+  size_t counts[Q + 2] = {0};
+  for (uint8_t r : regs) counts[r]++;
+  double m = static_cast<double>(NREGISTERS);
+  if (counts[0] == NREGISTERS) return 0;
+  double z = m * hll_tau(1 - static_cast<double>(counts[Q + 1]) / m);
+  for (int k = Q; k >= 1; --k) {
+    z = 0.5 * (z + static_cast<double>(counts[k]));
+  }
+  z += m * hll_sigma(static_cast<double>(counts[0]) / m);
+  double est = m * m / (2 * std::log(2.0) * z);
+  return static_cast<int64_t>(est + 0.5);
+}
+
+
+
+//==============================================================================
+// KllSketch
+//==============================================================================
+
+template <typename T>
+KllSketch<T>::KllSketch(uint64_t seed_) : levels(1), n(0), seed(seed_) {}
+
+
+/**
+ * Capacity of level `h`: the top level has capacity K, and each level below
+ * it has 2/3 of the capacity of the level above, but no less than 8. The
+ * bottom level is the input buffer, and its capacity is always K.
+ */
+template <typename T>
+size_t KllSketch<T>::capacity(size_t h) const {
+  if (h == 0) return K;
+  double cap = static_cast<double>(K);
+  for (size_t i = h + 1; i < levels.size(); ++i) cap *= 2.0 / 3;
+  return std::max(size_t(8), static_cast<size_t>(cap));
+}
+
+
+template <typename T>
+void KllSketch<T>::compress() {
+  bool again = true;
+  while (again) {
+    again = false;
+    for (size_t h = 0; h < levels.size(); ++h) {
+      if (levels[h].size() < capacity(h)) continue;
+      if (h + 1 == levels.size()) levels.emplace_back();
+      std::vector<T>& lvl = levels[h];
+      std::vector<T>& up = levels[h + 1];
+      std::sort(lvl.begin(), lvl.end());
+      // xorshift64: one random bit selects whether the odd or the even items
+      // are promoted, another (for an odd number of items) selects whether
+      // the first or the last item is left behind.
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      size_t sz = lvl.size();
+      size_t offset = seed & 1;
+      size_t start = (sz & 1) && (seed & 2)? 1 : 0;
+      for (size_t i = start; i + 1 < sz; i += 2) {
+        up.push_back(lvl[i + offset]);
+      }
+      T leftover = start? lvl[0] : lvl[sz - 1];
+      lvl.clear();
+      if (sz & 1) lvl.push_back(leftover);
+      again = true;
+    }
+  }
+}
+
+
+template <typename T>
+void KllSketch<T>::merge(const KllSketch<T>& other) {
+  if (other.levels.size() > levels.size()) levels.resize(other.levels.size());
+  for (size_t h = 0; h < other.levels.size(); ++h) {
+    levels[h].insert(levels[h].end(),
+                     other.levels[h].begin(), other.levels[h].end());
+  }
+  n += other.n;
+  compress();
+}
+
+
+/**
+ * Estimate the quantile `q` of the values added into the sketch, using the
+ * same linear interpolation between the closest ranks as the exact quantile.
+ * Each item at level `h` represents 2^h consecutive ranks.
+ */
+template <typename T>
+double KllSketch<T>::quantile(double q) const {
+  if (n == 0) return GETNA<double>();
+  std::vector<std::pair<T, int64_t>> items;
+  for (size_t h = 0; h < levels.size(); ++h) {
+    int64_t w = int64_t(1) << h;
+    for (T x : levels[h]) items.push_back(std::make_pair(x, w));
+  }
+  std::sort(items.begin(), items.end());
+
+  double r = q * static_cast<double>(n - 1);
+  int64_t lo = static_cast<int64_t>(r);
+  double frac = r - static_cast<double>(lo);
+  size_t i = 0;
+  int64_t cum = items[0].second;
+  while (cum <= lo && i + 1 < items.size()) cum += items[++i].second;
+  double x0 = static_cast<double>(items[i].first);
+  if (frac == 0 || cum > lo + 1 || i + 1 == items.size()) return x0;
+  double x1 = static_cast<double>(items[i + 1].first);
+  return x0 + frac * (x1 - x0);
+}
+
+
+template <typename T>
+size_t KllSketch<T>::memory_footprint() const {
+  size_t sz = sizeof(*this);
+  for (const std::vector<T>& lvl : levels) {
+    sz += sizeof(lvl) + lvl.capacity() * sizeof(T);
+  }
+  return sz;
+}
+
+
+template class KllSketch<int8_t>;
+template class KllSketch<int16_t>;
+template class KllSketch<int32_t>;
+template class KllSketch<int64_t>;
+template class KllSketch<float>;
+template class KllSketch<double>;
+
+
+
 //==============================================================================
 // Base Stats
 //==============================================================================
 
 void Stats::reset() {
   _computed.reset();
+  _ordering = RowIndex();
+  _hll.reset();
+  _run_starts.clear();
+}
+
+void Stats::reset_ordering() {
+  _ordering = RowIndex();
 }
 
 bool Stats::is_computed(Stat s) const {
@@ -50,6 +240,139 @@ int64_t Stats::nmodal(const Column* col) {
   return _nmodal;
 }
 
+int64_t Stats::nruns(const Column* col) {
+  if (!_computed.test(Stat::NRuns)) compute_runs(col);
+  return _nruns;
+}
+
+/**
+ * If the exact number of unique values is already known, then it is returned
+ * instead of the estimate.
+ */
+int64_t Stats::nunique_approx(const Column* col) {
+  if (_computed.test(Stat::NUnique)) return _nunique;
+  if (!_computed.test(Stat::NUniqueApprox)) compute_hll(col);
+  return _nunique_approx;
+}
+
+// Quantiles are only available for numeric columns
+double Stats::quantile(const Column*, double, bool) {
+  return GETNA<double>();
+}
+
+void Stats::set_hll(std::unique_ptr<HyperLogLog> hll) {
+  _hll = std::move(hll);
+  if (_hll) {
+    _nunique_approx = _hll->estimate();
+    _computed.set(Stat::NUniqueApprox);
+  } else {
+    _computed.reset(Stat::NUniqueApprox);
+  }
+}
+
+bool Stats::is_sorted(const Column* col) {
+  if (!_computed.test(Stat::NRuns)) compute_runs(col);
+  return _is_sorted;
+}
+
+bool Stats::is_reverse_sorted(const Column* col) {
+  if (!_computed.test(Stat::NRuns)) compute_runs(col);
+  return _is_reverse_sorted;
+}
+
+
+/**
+ * Scan the column and count the number of "descents" (pairs of consecutive
+ * elements where the second is less than the first) and "non-descents" (pairs
+ * where the second is not less than the first). The comparator `cmp(i, j)`
+ * takes indices of 2 elements within the column's data buffer, and returns a
+ * negative value, zero, or a positive value if the element `i` is less than,
+ * equal to, or greater than the element `j` in the sort order.
+ *
+ * When there are no more than `config::sort_max_merge_runs` runs, the
+ * positions where they start are retained too, so that the sort which merges
+ * these runs does not have to scan the column again to find them. Each thread
+ * scans a contiguous range of rows, which keeps the positions in order.
+ */
+template <typename F>
+void Stats::compute_runs_impl(const Column* col, F cmp) {
+  const RowIndex& rowindex = col->rowindex();
+  int64_t nrows = col->nrows;
+  int64_t ndescents = 0;
+  int64_t nnondescents = 0;
+  size_t maxstarts = config::sort_max_merge_runs;
+  std::vector<std::vector<int64_t>> starts(
+      static_cast<size_t>(omp_get_max_threads()));
+
+  #pragma omp parallel reduction(+:ndescents) reduction(+:nnondescents)
+  {
+    int64_t ith = omp_get_thread_num();
+    int64_t nth = omp_get_num_threads();
+    int64_t i0 = 1 + ith * (nrows - 1) / nth;
+    int64_t i1 = 1 + (ith + 1) * (nrows - 1) / nth;
+    std::vector<int64_t>& t_starts = starts[static_cast<size_t>(ith)];
+    for (int64_t i = i0; i < i1; ++i) {
+      int64_t j0 = rowindex? rowindex.nth(i - 1) : i - 1;
+      int64_t j1 = rowindex? rowindex.nth(i) : i;
+      int c = cmp(j1, j0);
+      if (c < 0) {
+        ++ndescents;
+        if (t_starts.size() < maxstarts) t_starts.push_back(i);
+      } else {
+        ++nnondescents;
+      }
+    }
+  }
+
+  _run_starts.clear();
+  if (static_cast<size_t>(ndescents) < maxstarts) {
+    _run_starts.reserve(static_cast<size_t>(ndescents));
+    for (const std::vector<int64_t>& t_starts : starts) {
+      _run_starts.insert(_run_starts.end(), t_starts.begin(), t_starts.end());
+    }
+  }
+  _run_starts.shrink_to_fit();
+  _nruns = nrows? ndescents + 1 : 0;
+  _is_sorted = (ndescents == 0);
+  _is_reverse_sorted = (nnondescents == 0);
+  _computed.set(Stat::NRuns);
+}
+
+
+/**
+ * Build the HyperLogLog sketch of the column in a single pass over the data.
+ * Each thread fills its own sketch, and the sketches are merged at the end.
+ * The function `hash(j, &h)` takes an index of an element within the column's
+ * data buffer, stores the hash of the element into `h`, and returns false if
+ * the element is NA (NAs are not counted).
+ */
+template <typename F>
+void Stats::compute_hll_impl(const Column* col, F hash) {
+  const RowIndex& rowindex = col->rowindex();
+  int64_t nrows = col->nrows;
+  std::unique_ptr<HyperLogLog> hll(new HyperLogLog());
+
+  #pragma omp parallel
+  {
+    int ith = omp_get_thread_num();  // current thread index
+    int nth = omp_get_num_threads(); // total number of threads
+    HyperLogLog t_hll;
+
+    rowindex.strided_loop(ith, nrows, nth,
+      [&](int64_t j) {
+        uint64_t h;
+        if (hash(j, &h)) t_hll.add(hash_finalize(h));
+      });
+
+    #pragma omp critical
+    {
+      hll->merge(t_hll);
+    }
+  }
+
+  set_hll(std::move(hll));
+}
+
 
 size_t Stats::memory_footprint() const {
   return sizeof(*this);
@@ -80,7 +403,8 @@ bool Stats::verify_integrity(IntegrityCheckContext&, const std::string&) const {
  * (Source: https://www.johndcook.com/blog/standard_deviation)
  */
 template <typename T, typename A>
-void NumericalStats<T, A>::compute_numerical_stats(const Column* col) {
+void NumericalStats<T, A>::compute_numerical_stats(const Column* col,
+                                                   bool with_quantiles) {
   int64_t nrows = col->nrows;
   const RowIndex& rowindex = col->rowindex();
   T* data = static_cast<T*>(col->data());
@@ -90,6 +414,18 @@ void NumericalStats<T, A>::compute_numerical_stats(const Column* col) {
   A sum = 0;
   T min = infinity<T>();
   T max = -infinity<T>();
+  // Each thread fills its own quantile sketch. The sketches are merged in
+  // the order of thread indices once the parallel region is over: the result
+  // of a merge depends on the order of merging, and it should not depend on
+  // the order in which the threads happen to finish.
+  std::vector<KllSketch<T>> t_qsketches;
+  if (with_quantiles) {
+    size_t maxth = static_cast<size_t>(omp_get_max_threads());
+    t_qsketches.reserve(maxth);
+    for (size_t i = 0; i < maxth; ++i) {
+      t_qsketches.emplace_back(0x9E3779B97F4A7C15ULL * (i + 1));
+    }
+  }
 
   #pragma omp parallel
   {
@@ -101,11 +437,14 @@ void NumericalStats<T, A>::compute_numerical_stats(const Column* col) {
     A t_sum = 0;
     T t_min = infinity<T>();
     T t_max = -infinity<T>();
+    KllSketch<T>* t_qsketch =
+        with_quantiles? &t_qsketches[static_cast<size_t>(ith)] : nullptr;
 
     rowindex.strided_loop(ith, nrows, nth,
       [&](int64_t i) {
         T x = data[i];
         if (ISNA<T>(x)) return;
+        if (with_quantiles) t_qsketch->add(x);
         ++t_count_notna;
         t_sum += static_cast<A>(x);
         if (x < t_min) t_min = x;  // Note: these ifs are not exclusive!
@@ -149,6 +488,19 @@ void NumericalStats<T, A>::compute_numerical_stats(const Column* col) {
   _computed.set(Stat::Mean);
   _computed.set(Stat::StDev);
   _computed.set(Stat::NaCount);
+  if (with_quantiles) {
+    std::unique_ptr<KllSketch<T>> qsketch(new KllSketch<T>());
+    for (const KllSketch<T>& t_qsketch : t_qsketches) {
+      if (t_qsketch.count() > 0) qsketch->merge(t_qsketch);
+    }
+    _qt25 = qsketch->quantile(0.25);
+    _median = qsketch->quantile(0.5);
+    _qt75 = qsketch->quantile(0.75);
+    _qsketch = std::move(qsketch);
+    _computed.set(Stat::Qt25);
+    _computed.set(Stat::Median);
+    _computed.set(Stat::Qt75);
+  }
 }
 
 
@@ -156,7 +508,6 @@ template <typename T, typename A>
 void NumericalStats<T, A>::compute_sorted_stats(const Column* col) {
   T* coldata = static_cast<T*>(col->data());
   RowIndex ri = col->sort(true);
-  const arr32_t& groups = ri.get_groups();
   size_t n_groups = ri.get_ngroups();
 
   // Sorting gathers all NA elements at the top (in the first group). Thus if
@@ -164,7 +515,7 @@ void NumericalStats<T, A>::compute_sorted_stats(const Column* col) {
   // checking whether the elements in the first group are NA or not.
   if (!_computed.test(Stat::NaCount)) {
     T x0 = coldata[ri.nth(0)];
-    _countna = ISNA<T>(x0)? groups[1] : 0;
+    _countna = ISNA<T>(x0)? ri.group_offset(1) : 0;
     _computed.set(Stat::NaCount);
   }
 
@@ -175,7 +526,7 @@ void NumericalStats<T, A>::compute_sorted_stats(const Column* col) {
   int64_t max_grpsize = 0;
   size_t best_igrp = 0;
   for (size_t i = has_nas; i < n_groups; ++i) {
-    int32_t grpsize = groups[i + 1] - groups[i];
+    int64_t grpsize = ri.group_offset(i + 1) - ri.group_offset(i);
     if (grpsize > max_grpsize) {
       max_grpsize = grpsize;
       best_igrp = i;
@@ -183,27 +534,69 @@ void NumericalStats<T, A>::compute_sorted_stats(const Column* col) {
   }
 
   _nmodal = max_grpsize;
-  _mode = max_grpsize ? coldata[ri.nth(groups[best_igrp])] : GETNA<T>();
+  _mode = max_grpsize ? coldata[ri.nth(ri.group_offset(best_igrp))] : GETNA<T>();
   _computed.set(Stat::NModal);
   _computed.set(Stat::Mode);
 }
 
 
+// Map a value into an unsigned key that compares the same way as the values
+// are ordered by the sort: integer NAs are the smallest values already, while
+// the floating-point values are mapped in the same way as in `SortContext`,
+// with NAs becoming 0.
+template <typename T> static inline T runs_key(T x) { return x; }
+
+static inline uint32_t runs_key(float x) {
+  uint32_t t;
+  std::memcpy(&t, &x, sizeof(t));
+  return std::isnan(x)? 0 : t ^ (0x80000000u | -(t >> 31));
+}
+
+static inline uint64_t runs_key(double x) {
+  uint64_t t;
+  std::memcpy(&t, &x, sizeof(t));
+  return std::isnan(x)? 0 : t ^ (0x8000000000000000ULL | -(t >> 63));
+}
+
+template <typename T, typename A>
+void NumericalStats<T, A>::compute_runs(const Column* col) {
+  const T* data = static_cast<const T*>(col->data());
+  compute_runs_impl(col,
+    [=](int64_t i, int64_t j) {
+      auto a = runs_key(data[i]);
+      auto b = runs_key(data[j]);
+      return (a > b) - (a < b);
+    });
+}
+
+
+template <typename T, typename A>
+void NumericalStats<T, A>::compute_hll(const Column* col) {
+  const T* data = static_cast<const T*>(col->data());
+  compute_hll_impl(col,
+    [=](int64_t j, uint64_t* h) {
+      T x = data[j];
+      *h = key_bits<T>(x);
+      return !ISNA<T>(x);
+    });
+}
+
+
 template <typename T, typename A>
 A NumericalStats<T, A>::sum(const Column* col) {
-  if (!_computed.test(Stat::Sum)) compute_numerical_stats(col);
+  if (!_computed.test(Stat::Sum)) compute_numerical_stats(col, false);
   return _sum;
 }
 
 template <typename T, typename A>
 T NumericalStats<T, A>::min(const Column* col) {
-  if (!_computed.test(Stat::Min)) compute_numerical_stats(col);
+  if (!_computed.test(Stat::Min)) compute_numerical_stats(col, false);
   return _min;
 }
 
 template <typename T, typename A>
 T NumericalStats<T, A>::max(const Column* col) {
-  if (!_computed.test(Stat::Max)) compute_numerical_stats(col);
+  if (!_computed.test(Stat::Max)) compute_numerical_stats(col, false);
   return _max;
 }
 
@@ -215,20 +608,71 @@ T NumericalStats<T, A>::mode(const Column* col) {
 
 template <typename T, typename A>
 double NumericalStats<T, A>::mean(const Column* col) {
-  if (!_computed.test(Stat::Mean)) compute_numerical_stats(col);
+  if (!_computed.test(Stat::Mean)) compute_numerical_stats(col, false);
   return _mean;
 }
 
 template <typename T, typename A>
 double NumericalStats<T, A>::stdev(const Column* col) {
-  if (!_computed.test(Stat::StDev)) compute_numerical_stats(col);
+  if (!_computed.test(Stat::StDev)) compute_numerical_stats(col, false);
   return _sd;
 }
 
 
+template <typename T, typename A>
+double NumericalStats<T, A>::qt25(const Column* col) {
+  if (!_computed.test(Stat::Qt25)) compute_numerical_stats(col, true);
+  return _qt25;
+}
+
+template <typename T, typename A>
+double NumericalStats<T, A>::median(const Column* col) {
+  if (!_computed.test(Stat::Median)) compute_numerical_stats(col, true);
+  return _median;
+}
+
+template <typename T, typename A>
+double NumericalStats<T, A>::qt75(const Column* col) {
+  if (!_computed.test(Stat::Qt75)) compute_numerical_stats(col, true);
+  return _qt75;
+}
+
+
+/**
+ * Quantile `q` of the non-NA values in the column, interpolated linearly
+ * between the closest ranks. If `approx` is true, the quantile is estimated
+ * from the KLL sketch; otherwise it is looked up in the sorted ordering of
+ * the column (which is computed once, and then cached).
+ */
+template <typename T, typename A>
+double NumericalStats<T, A>::quantile(const Column* col, double q,
+                                      bool approx) {
+  if (approx) {
+    if (q == 0.25) return qt25(col);
+    if (q == 0.5) return median(col);
+    if (q == 0.75) return qt75(col);
+    if (!_computed.test(Stat::Median)) compute_numerical_stats(col, true);
+    if (_qsketch) return _qsketch->quantile(q);
+  }
+  if (col->nrows == 0) return GETNA<double>();
+  const T* data = static_cast<const T*>(col->data());
+  RowIndex ri = col->sort(true);
+  int64_t nna = ISNA<T>(data[ri.nth(0)])? ri.group_offset(1) : 0;
+  int64_t n = col->nrows - nna;
+  if (n == 0) return GETNA<double>();
+  double r = q * static_cast<double>(n - 1);
+  int64_t lo = static_cast<int64_t>(r);
+  double frac = r - static_cast<double>(lo);
+  double x0 = static_cast<double>(data[ri.nth(nna + lo)]);
+  if (frac == 0 || lo + 1 >= n) return x0;
+  double x1 = static_cast<double>(data[ri.nth(nna + lo + 1)]);
+  return x0 == x1? x0 : x0 + frac * (x1 - x0);
+}
+
+
 template<typename T, typename A>
 void NumericalStats<T, A>::compute_countna(const Column* col) {
-  compute_numerical_stats(col);
+  compute_numerical_stats(col, false);
 }
 
 
@@ -247,8 +691,9 @@ template class NumericalStats<double, double>;
 
 // Adds a check for infinite/NaN mean and sd.
 template <typename T>
-void RealStats<T>::compute_numerical_stats(const Column *col) {
-  NumericalStats<T, double>::compute_numerical_stats(col);
+void RealStats<T>::compute_numerical_stats(const Column *col,
+                                           bool with_quantiles) {
+  NumericalStats<T, double>::compute_numerical_stats(col, with_quantiles);
   if (std::isinf(this->_min) || std::isinf(this->_max)) {
     this->_sd = GETNA<double>();
     this->_mean = std::isinf(this->_min) && this->_min < 0 &&
@@ -287,7 +732,7 @@ template class IntegerStats<int64_t>;
  *      sd = ( ---------------------------------------- )
  *            \ (count0 + count1 - 1)(count0 + count1) /
  */
-void BooleanStats::compute_numerical_stats(const Column *col) {
+void BooleanStats::compute_numerical_stats(const Column *col, bool) {
   int64_t count0 = 0, count1 = 0;
   int8_t* data = static_cast<int8_t*>(col->data());
   int64_t nrows = col->nrows;
@@ -324,6 +769,19 @@ void BooleanStats::compute_numerical_stats(const Column *col) {
   _nunique = (!!count0) + (!!count1);
   _mode = _nunique ? (count1 >= count0) : GETNA<int8_t>();
   _nmodal = _mode == 1 ? count1 : _mode == 0 ? count0 : 0;
+  // The sorted values are `count0` zeros followed by `count1` ones, so the
+  // quantiles can be computed exactly, without the sketch.
+  auto quantile = [=](double q) -> double {
+    if (t_count == 0) return GETNA<double>();
+    double r = q * static_cast<double>(t_count - 1);
+    int64_t lo = static_cast<int64_t>(r);
+    double x0 = (lo >= count0);
+    double x1 = (lo + 1 >= count0 && lo + 1 < t_count) || x0;
+    return x0 + (r - static_cast<double>(lo)) * (x1 - x0);
+  };
+  _qt25 = quantile(0.25);
+  _median = quantile(0.5);
+  _qt75 = quantile(0.75);
   _computed.set(Stat::Max);
   _computed.set(Stat::Mean);
   _computed.set(Stat::Min);
@@ -333,10 +791,13 @@ void BooleanStats::compute_numerical_stats(const Column *col) {
   _computed.set(Stat::NUnique);
   _computed.set(Stat::StDev);
   _computed.set(Stat::Sum);
+  _computed.set(Stat::Qt25);
+  _computed.set(Stat::Median);
+  _computed.set(Stat::Qt75);
 }
 
 void BooleanStats::compute_sorted_stats(const Column *col) {
-  compute_numerical_stats(col);
+  compute_numerical_stats(col, false);
 }
 
 
@@ -380,12 +841,11 @@ void StringStats<T>::compute_sorted_stats(const Column* col) {
   const StringColumn<T>* scol = static_cast<const StringColumn<T>*>(col);
   T* offsets = scol->offsets();
   RowIndex ri = col->sort(true);
-  const arr32_t& groups = ri.get_groups();
   size_t n_groups = ri.get_ngroups();
 
   if (!_computed.test(Stat::NaCount)) {
     T off0 = offsets[ri.nth(0)];
-    _countna = off0 < 0? groups[1] : 0;
+    _countna = off0 < 0? ri.group_offset(1) : 0;
     _computed.set(Stat::NaCount);
   }
 
@@ -396,7 +856,7 @@ void StringStats<T>::compute_sorted_stats(const Column* col) {
   int64_t max_grpsize = 0;
   size_t best_igrp = 0;
   for (size_t i = has_nas; i < n_groups; ++i) {
-    int32_t grpsize = groups[i + 1] - groups[i];
+    int64_t grpsize = ri.group_offset(i + 1) - ri.group_offset(i);
     if (grpsize > max_grpsize) {
       max_grpsize = grpsize;
       best_igrp = i;
@@ -404,7 +864,7 @@ void StringStats<T>::compute_sorted_stats(const Column* col) {
   }
 
   if (max_grpsize) {
-    int64_t i = ri.nth(groups[best_igrp]);
+    int64_t i = ri.nth(ri.group_offset(best_igrp));
     T o0 = std::abs(offsets[i - 1]);
     _nmodal = max_grpsize;
     _mode.ch = scol->strdata() + o0;
@@ -419,6 +879,37 @@ void StringStats<T>::compute_sorted_stats(const Column* col) {
 }
 
 
+template <typename T>
+void StringStats<T>::compute_runs(const Column* col) {
+  const StringColumn<T>* scol = static_cast<const StringColumn<T>*>(col);
+  const T* offsets = scol->offsets();
+  const uint8_t* strdata = reinterpret_cast<const uint8_t*>(scol->strdata());
+  compute_runs_impl(col,
+    [=](int64_t i, int64_t j) {
+      // `compare_offstrings()` returns 1 if the first string is less
+      return -compare_offstrings<T>(strdata,
+                                    std::abs(offsets[i - 1]), offsets[i],
+                                    std::abs(offsets[j - 1]), offsets[j]);
+    });
+}
+
+
+template <typename T>
+void StringStats<T>::compute_hll(const Column* col) {
+  const StringColumn<T>* scol = static_cast<const StringColumn<T>*>(col);
+  const T* offsets = scol->offsets();
+  const uint8_t* strdata = reinterpret_cast<const uint8_t*>(scol->strdata());
+  compute_hll_impl(col,
+    [=](int64_t j, uint64_t* h) {
+      T end = offsets[j];
+      if (end < 0) return false;
+      T start = std::abs(offsets[j - 1]);
+      *h = hash_bytes(strdata + start, static_cast<size_t>(end - start));
+      return true;
+    });
+}
+
+
 template <typename T>
 CString StringStats<T>::mode(const Column* col) {
   if (!_computed.test(Stat::Mode)) compute_sorted_stats(col);
@@ -467,3 +958,13 @@ void PyObjectStats::compute_countna(const Column* col) {
 void PyObjectStats::compute_sorted_stats(const Column*) {
   throw NotImplError();
 }
+
+
+void PyObjectStats::compute_runs(const Column*) {
+  throw NotImplError();
+}
+
+
+void PyObjectStats::compute_hll(const Column*) {
+  throw NotImplError();
+}
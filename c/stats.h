@@ -8,8 +8,10 @@
 #ifndef dt_STATS_h
 #define dt_STATS_h
 #include <bitset>
+#include <memory>
 #include <vector>
 #include "datatable_check.h"
+#include "rowindex.h"
 #include "types.h"
 
 class Column;
@@ -28,12 +30,117 @@ enum Stat {
   Mode,
   NModal,
   NUnique,
+  NRuns,
+  NUniqueApprox,
 
   NSTATS
 };
 
 
 
+//------------------------------------------------------------------------------
+// HyperLogLog class
+//------------------------------------------------------------------------------
+
+/**
+ * HyperLogLog sketch, used for estimating the number of distinct values in a
+ * column (Flajolet et al., 2007). The sketch consists of 2^PRECISION one-byte
+ * registers; each 64-bit hash added into the sketch selects a register by its
+ * top PRECISION bits, and stores there the maximum "rank" (position of the
+ * leading 1-bit) of its remaining bits. With the default precision the sketch
+ * takes 4KB of memory, and has the relative standard error of about 1.6%.
+ *
+ * Two sketches are merged by taking the maximum of each register; the result
+ * is the same as if all values were added into a single sketch. Thus the
+ * sketches can be computed independently by each thread (or for each part of
+ * an rbound column), and then combined.
+ */
+class HyperLogLog {
+  public:
+    static constexpr int PRECISION = 12;
+    static constexpr size_t NREGISTERS = size_t(1) << PRECISION;
+
+  private:
+    std::vector<uint8_t> regs;
+
+  public:
+    HyperLogLog() : regs(NREGISTERS, 0) {}
+
+    void add(uint64_t hash) {
+      size_t idx = static_cast<size_t>(hash >> (64 - PRECISION));
+      uint64_t w = hash << PRECISION;
+      uint8_t rank = w? static_cast<uint8_t>(__builtin_clzll(w) + 1)
+                      : static_cast<uint8_t>(64 - PRECISION + 1);
+      if (rank > regs[idx]) regs[idx] = rank;
+    }
+
+    void merge(const HyperLogLog& other);
+    int64_t estimate() const;
+    size_t memory_footprint() const { return sizeof(*this) + regs.size(); }
+};
+
+
+
+//------------------------------------------------------------------------------
+// KllSketch class
+//------------------------------------------------------------------------------
+
+/**
+ * KLL quantile sketch (Karnin, Lang, Liberty, 2016), used for estimating the
+ * quantiles of a numeric column in a single pass over the data.
+ *
+ * The sketch is a stack of "compactors": level `h` holds items of weight 2^h.
+ * When a level exceeds its capacity, it is sorted and every other item (the
+ * odd or the even ones, chosen at random) is promoted into the level above,
+ * with double the weight. The capacities decrease geometrically from the top
+ * level (which has capacity K) towards the bottom, so that the sketch holds
+ * at most about 3K items regardless of the number of values added.
+ *
+ * With K = 200 the rank of the returned quantile differs from the requested
+ * rank by no more than ~1.65% of the number of values, with 99% probability.
+ * Two sketches can be merged, with the same error guarantee for the result.
+ * As long as no compaction happened (fewer than K values were added), the
+ * quantiles are exact. The compactions are driven by a pseudo-random
+ * generator initialized from `seed`, so that the results are reproducible.
+ */
+template <typename T>
+class KllSketch {
+  public:
+    static constexpr size_t K = 200;
+
+  private:
+    std::vector<std::vector<T>> levels;
+    int64_t n;
+    uint64_t seed;
+
+  public:
+    explicit KllSketch(uint64_t seed_ = 0x9E3779B97F4A7C15ULL);
+
+    void add(T x) {
+      levels[0].push_back(x);
+      ++n;
+      if (levels[0].size() >= K) compress();
+    }
+
+    void merge(const KllSketch<T>& other);
+    double quantile(double q) const;
+    int64_t count() const { return n; }
+    size_t memory_footprint() const;
+
+  private:
+    size_t capacity(size_t h) const;
+    void compress();
+};
+
+extern template class KllSketch<int8_t>;
+extern template class KllSketch<int16_t>;
+extern template class KllSketch<int32_t>;
+extern template class KllSketch<int64_t>;
+extern template class KllSketch<float>;
+extern template class KllSketch<double>;
+
+
+
 //------------------------------------------------------------------------------
 // Stats class
 //------------------------------------------------------------------------------
@@ -71,6 +178,33 @@ enum Stat {
  *       from the provided column.
  *   <S>_get() - retrieve the value of computed statistic (but the user should
  *       check its availability first).
+ *
+ * Stat `NRuns` describes the "presortedness" of the column: the number of
+ * maximal non-decreasing runs of values (in the sort order, i.e. with NAs
+ * first), together with the flags `is_sorted` (there is only one run) and
+ * `is_reverse_sorted` (the values are strictly decreasing). These are used
+ * by the sort to skip the radix sort on the data that is already ordered.
+ * When the runs are few enough to be merged, `run_starts()` also lists the
+ * rows where the second and subsequent runs begin.
+ *
+ * In addition, Stats hold the cached ordering of the column: the RowIndex
+ * (with groups) produced by sorting the column in ascending order. This
+ * ordering is computed once by `Column::sort()` (when it is asked for the
+ * groups), and then reused by all "sorted" stats, groupbys and sorts on the
+ * same column. The ordering refers to the rows of the column's data buffer,
+ * and therefore is discarded not only with `reset()`, but also via
+ * `reset_ordering()` when the column is reified.
+ *
+ * Stats `Qt25`, `Median` and `Qt75` are computed for numeric columns only,
+ * from a KLL quantile sketch built in the same pass as the other numerical
+ * stats (see `NumericalStats`). The exact quantiles can be obtained from the
+ * sorted ordering of the column instead, via `quantile(col, q, false)`.
+ *
+ * Stat `NUniqueApprox` is the estimate of the number of unique values, which
+ * requires only one hashing pass over the data instead of a sort. The
+ * HyperLogLog sketch from which the estimate is derived is retained in the
+ * Stats, so that the sketches of several columns can be combined when these
+ * columns are rbound together.
  */
 class Stats {
   protected:
@@ -78,6 +212,13 @@ class Stats {
     int64_t _countna;
     int64_t _nunique;
     int64_t _nmodal;
+    int64_t _nruns;
+    int64_t _nunique_approx;
+    bool _is_sorted;
+    bool _is_reverse_sorted;
+    RowIndex _ordering;
+    std::unique_ptr<HyperLogLog> _hll;
+    std::vector<int64_t> _run_starts;
 
   public:
     Stats() = default;
@@ -88,9 +229,20 @@ class Stats {
     int64_t countna(const Column*);
     int64_t nunique(const Column*);
     int64_t nmodal(const Column*);
+    int64_t nruns(const Column*);
+    int64_t nunique_approx(const Column*);
+    virtual double quantile(const Column*, double q, bool approx);
+    bool is_sorted(const Column*);
+    bool is_reverse_sorted(const Column*);
 
     bool is_computed(Stat s) const;
     void reset();
+    void reset_ordering();
+    const RowIndex& get_ordering() const { return _ordering; }
+    void set_ordering(const RowIndex& ri) { _ordering = ri; }
+    const std::vector<int64_t>& run_starts() const { return _run_starts; }
+    const HyperLogLog* get_hll() const { return _hll.get(); }
+    void set_hll(std::unique_ptr<HyperLogLog> hll);
     virtual void merge_stats(const Stats*);
 
     virtual size_t memory_footprint() const = 0;
@@ -100,6 +252,11 @@ class Stats {
   protected:
     virtual void compute_countna(const Column*) = 0;
     virtual void compute_sorted_stats(const Column*) = 0;
+    virtual void compute_runs(const Column*) = 0;
+    virtual void compute_hll(const Column*) = 0;
+    template <typename F> void compute_runs_impl(const Column*, F cmp);
+    template <typename F> void compute_hll_impl(const Column*, F hash);
+    size_t hll_footprint() const { return _hll? _hll->memory_footprint() : 0; }
 };
 
 
@@ -117,12 +274,21 @@ class Stats {
  *
  * This class itself is not compatible with any SType; one of its children
  * should be used instead (see the inheritance diagram above).
+ *
+ * Computing the quantile sketch makes the numerical stats pass several times
+ * slower, so it is only built when one of the quantile stats is requested;
+ * in that case all other numerical stats are computed at the same time. The
+ * sketch is retained, so that any other quantile can be estimated later.
  */
 template <typename T, typename A>
 class NumericalStats : public Stats {
   protected:
     double _mean;
     double _sd;
+    double _qt25;
+    double _median;
+    double _qt75;
+    std::unique_ptr<KllSketch<T>> _qsketch;
     A _sum;
     T _min;
     T _max;
@@ -130,7 +296,10 @@ class NumericalStats : public Stats {
     int64_t : (sizeof(A) + sizeof(T) * 3) * 56 % 64;
 
   public:
-    size_t memory_footprint() const override { return sizeof(*this); }
+    size_t memory_footprint() const override {
+      return sizeof(*this) + _ordering.memory_footprint() + hll_footprint() +
+             (_qsketch? _qsketch->memory_footprint() : 0);
+    }
 
     double mean(const Column*);
     double stdev(const Column*);
@@ -138,12 +307,19 @@ class NumericalStats : public Stats {
     T max(const Column*);
     T mode(const Column*);
     A sum(const Column*);
+    double qt25(const Column*);
+    double median(const Column*);
+    double qt75(const Column*);
+    double quantile(const Column*, double q, bool approx) override;
 
   protected:
-    // Helper method that computes min, max, sum, mean, sd, and countna
-    virtual void compute_numerical_stats(const Column*);
+    // Helper method that computes min, max, sum, mean, sd, and countna; and
+    // also the quantile sketch if `with_quantiles` is true.
+    virtual void compute_numerical_stats(const Column*, bool with_quantiles);
     virtual void compute_sorted_stats(const Column*) override;
     virtual void compute_countna(const Column*) override;
+    virtual void compute_runs(const Column*) override;
+    virtual void compute_hll(const Column*) override;
 };
 
 extern template class NumericalStats<int8_t, int64_t>;
@@ -165,7 +341,7 @@ extern template class NumericalStats<double, double>;
 template <typename T>
 class RealStats : public NumericalStats<T, double> {
   protected:
-    void compute_numerical_stats(const Column*) override;
+    void compute_numerical_stats(const Column*, bool) override;
 };
 
 extern template class RealStats<float>;
@@ -202,7 +378,7 @@ extern template class IntegerStats<int64_t>;
  */
 class BooleanStats : public NumericalStats<int8_t, int64_t> {
   protected:
-    void compute_numerical_stats(const Column *col) override;
+    void compute_numerical_stats(const Column *col, bool) override;
     void compute_sorted_stats(const Column*) override;
 };
 
@@ -222,13 +398,17 @@ class StringStats : public Stats {
     CString _mode;
 
   public:
-    virtual size_t memory_footprint() const override { return sizeof(*this); }
+    virtual size_t memory_footprint() const override {
+      return sizeof(*this) + _ordering.memory_footprint() + hll_footprint();
+    }
 
     CString mode(const Column*);
 
   protected:
     virtual void compute_countna(const Column*) override;
     virtual void compute_sorted_stats(const Column*) override;
+    virtual void compute_runs(const Column*) override;
+    virtual void compute_hll(const Column*) override;
 };
 
 extern template class StringStats<int32_t>;
@@ -242,11 +422,15 @@ extern template class StringStats<int64_t>;
 
 class PyObjectStats : public Stats {
   public:
-    virtual size_t memory_footprint() const override { return sizeof(*this); }
+    virtual size_t memory_footprint() const override {
+      return sizeof(*this) + _ordering.memory_footprint() + hll_footprint();
+    }
 
   protected:
     void compute_countna(const Column*) override;
     void compute_sorted_stats(const Column*) override;
+    void compute_runs(const Column*) override;
+    void compute_hll(const Column*) override;
 };
 
 
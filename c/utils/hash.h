@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// © H2O.ai 2018
+//------------------------------------------------------------------------------
+#ifndef dt_UTILS_HASH_H
+#define dt_UTILS_HASH_H
+#include <cmath>     // std::isnan
+#include <cstdint>   // uint64_t
+#include <cstring>   // std::memcpy
+
+
+static inline uint64_t hash_mix(uint64_t h, uint64_t v) {
+  return (h ^ v) * 0x9E3779B97F4A7C15ULL;
+}
+
+// Final avalanche step of MurmurHash3
+static inline uint64_t hash_finalize(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+
+// Convert a value into its "hashing bits": all values that should be
+// considered equal map into the same bits. In particular, all floating-point
+// NaNs are treated as NA. Same as in sorting, negative zero is considered
+// distinct from positive zero.
+template <typename T> static inline uint64_t key_bits(T x) {
+  return static_cast<uint64_t>(x);
+}
+
+template <> inline uint64_t key_bits(float x) {
+  if (std::isnan(x)) return 0x7FC00000;
+  uint32_t r;
+  std::memcpy(&r, &x, sizeof(float));
+  return r;
+}
+
+template <> inline uint64_t key_bits(double x) {
+  if (std::isnan(x)) return 0x7FF8000000000000ULL;
+  uint64_t r;
+  std::memcpy(&r, &x, sizeof(double));
+  return r;
+}
+
+
+// Hash of a string of `len` bytes, starting at `ch`.
+static inline uint64_t hash_bytes(const uint8_t* ch, size_t len) {
+  uint64_t h = len;
+  for (; len >= 8; len -= 8, ch += 8) {
+    uint64_t w;
+    std::memcpy(&w, ch, 8);
+    h = hash_mix(h, w);
+  }
+  if (len) {
+    uint64_t w = 0;
+    std::memcpy(&w, ch, len);
+    h = hash_mix(h, w);
+  }
+  return h;
+}
+
+
+#endif
@@ -8,7 +8,8 @@
 from datatable.graph.dtproxy import f
 from .__version__ import version as __version__
 from .frame import Frame
-from .expr import mean, min, max, sd, isna
+from .expr import (mean, min, max, sd, isna, isin, sum, count, first, last,
+                   median, quantile)
 from .fread import fread, GenericReader
 from .nff import save, open
 from .options import options
@@ -17,7 +18,8 @@ from .utils.typechecks import TTypeError as TypeError
 from .utils.typechecks import TValueError as ValueError
 
 __all__ = ("__version__", "Frame", "max", "mean", "min", "open", "sd",
-           "isna", "fread", "GenericReader", "save", "stype", "ltype", "f",
+           "isna", "isin", "sum", "count", "first", "last", "median",
+           "quantile", "fread", "GenericReader", "save", "stype", "ltype", "f",
            "TypeError", "ValueError", "DataTable", "options",
            "bool8", "int8", "int16", "int32", "int64",
            "float32", "float64", "str32", "str64", "obj64")
@@ -10,19 +10,29 @@ from .base_expr import BaseExpr
 from .binary_expr import BinaryOpExpr
 from .cast_expr import CastExpr
 from .column_expr import ColSelectorExpr
+from .isin_expr import isin
 from .isna_expr import isna
 from .literal_expr import LiteralExpr
 from .mean_expr import MeanReducer, mean
 from .minmax_expr import MinMaxReducer, min, max
+from .reduce_expr import (ReduceExpr, sum, count, first, last, median,
+                          quantile)
 from .relop_expr import RelationalOpExpr
 from .sd_expr import StdevReducer, sd
 from .unary_expr import UnaryOpExpr
 
 __all__ = (
+    "count",
+    "first",
+    "last",
     "max",
     "mean",
+    "median",
     "min",
+    "quantile",
     "sd",
+    "sum",
+    "isin",
     "isna",
     "BinaryOpExpr",
     "CastExpr",
@@ -32,6 +42,7 @@ __all__ = (
     "LiteralExpr",
     "MeanReducer",
     "MinMaxReducer",
+    "ReduceExpr",
     "RelationalOpExpr",
     "StdevReducer",
     "UnaryOpExpr",
@@ -44,6 +44,13 @@ class BaseExpr:
     """
     __slots__ = ["_stype"]
 
+    # True for expressions that reduce a column (or each group of a grouped
+    # column) into a single value, such as `mean()` or `sd()`. Such classes
+    # also implement method `reduce_op()`, returning the tuple of the reduce
+    # opcode, the argument expression, and the numeric parameter of the
+    # reduction (if any).
+    is_reducer = False
+
 
     def __init__(self):
         self._stype = None
@@ -60,6 +67,25 @@ class BaseExpr:
     def evaluate_eager(self, ee):
         raise NotImplementedError
 
+    def evaluate_view(self, ee):
+        """
+        Same as `evaluate_eager()`, except that the resulting column may still
+        carry a RowIndex (i.e. it need not be materialized). This is used by
+        the consumers that are able to read the data through a RowIndex: the
+        fused programs and the reducers.
+        """
+        return self.evaluate_eager(ee)
+
+    def fuse(self, program):
+        """
+        Append the instructions computing this expression to the `program`
+        (an instance of :class:`FusedProgram`). By default the expression is
+        evaluated eagerly, and the program receives its result as an input.
+        Operator nodes override this method so that the whole tree of
+        operators can be evaluated at once.
+        """
+        program.add_input(self)
+
     @property
     def stype(self):
         """
@@ -39,19 +39,26 @@ class ColSelectorExpr(BaseExpr):
         return self._colid
 
     def __str__(self):
-        # This will be used both as a key for node memoization, and the name of
-        # the variable that contains the value of the column (for `i`-th row).
-        # The name will look as follows:
-        #     d3_salary    or    d3_17
-        # where "d3" is the id of the datatable, and "salary" / "17" is the
+        # This will be used as a key for node memoization. The name will look
+        # as follows:
+        #     f3_salary    or    f3_17
+        # where "f3" is the id of the datatable, and "salary" / "17" is the
         # column name/ index.
         # The only reason we don't always use the latter form is to improve
         # code readability during debugging.
         #
+        # The variable that contains the value of the column (for `i`-th row)
+        # is named similarly, except that the frame's id is replaced with the
+        # name of the frame's variable in the generated code (see
+        # `_cvar_name()`), so that the code does not depend on the frame.
+        #
+        return str(self._dtexpr) + self._colsuffix()
+
+    def _colsuffix(self):
         colname = self._dtexpr.names[self._colid]
         if len(colname) > 12 or not colname.isalnum() or colname.isdigit():
             colname = str(self._colid)
-        return str(self._dtexpr) + "_" + colname
+        return "_" + colname
 
 
     #---------------------------------------------------------------------------
@@ -60,10 +67,9 @@ class ColSelectorExpr(BaseExpr):
 
     def _value(self, key, inode):
         self.resolve()
-        v = inode.make_keyvar(key, key, exact=True)
+        v = inode.make_keyvar(key, self._cvar_name(inode), exact=True)
         inode.check_num_rows(self._dtexpr.nrows)
-        assert v == key
-        datavar = key + "_data"
+        datavar = v + "_data"
         inode.make_keyvar(datavar, datavar, exact=True)
         inode.addto_preamble("{type}* {data} = "
                              "({type}*) dt_column_data({dt}, {idx});"
@@ -79,7 +85,8 @@ class ColSelectorExpr(BaseExpr):
     def _isna(self, key, inode):
         self.resolve()
         # TODO: use rollup stats to determine if some variable is never NA
-        v = inode.make_keyvar(key, str(self) + "_isna", exact=True)
+        v = inode.make_keyvar(key, self._cvar_name(inode) + "_isna",
+                              exact=True)
         if self.stype == stype.str32:
             inode.addto_mainloop("int {var} = ({value} < 0);"
                                  .format(var=v, value=self.value(inode)))
@@ -101,6 +108,9 @@ class ColSelectorExpr(BaseExpr):
         dt = self._dtexpr.get_datatable()
         return inode.get_dtvar(dt)
 
+    def _cvar_name(self, inode):
+        return self._get_dtvar(inode) + self._colsuffix()
+
 
     #---------------------------------------------------------------------------
     # Eager evaluation
@@ -111,3 +121,14 @@ class ColSelectorExpr(BaseExpr):
         dt = self._dtexpr.get_datatable()
         ri = ee.rowindex
         return core.expr_column(dt.internal, self._colid, ri)
+
+    def evaluate_view(self, ee):
+        self.resolve()
+        dt = self._dtexpr.get_datatable()
+        ri = ee.rowindex
+        return core.expr_column(dt.internal, self._colid, ri, False)
+
+    def fuse(self, program):
+        # The same column may appear in the expression several times
+        self.resolve()
+        program.add_input(self, key=(id(self._dtexpr), self._colid))
@@ -96,6 +96,13 @@ for st1 in stypes_ladder:
 for st in stypes_ladder:
     ops_rules[("mean", st)] = stype.float64
     ops_rules[("sd", st)] = stype.float64
+    ops_rules[("count", st)] = stype.int64
+    ops_rules[("first", st)] = st
+    ops_rules[("last", st)] = st
+    ops_rules[("sum", st)] = st if st in stype_float else stype.int64
+    ops_rules[("median", st)] = stype.float32 if st == stype.float32 else \
+                                stype.float64
+    ops_rules[("quantile", st)] = ops_rules[("median", st)]
 
 ops_rules[("+", stype.bool8, stype.bool8)] = stype.int8
 ops_rules[("-", stype.bool8, stype.bool8)] = stype.int8
@@ -132,4 +139,9 @@ reduce_opcodes = {
     "min": 2,
     "max": 3,
     "stdev": 4,
+    "sum": 5,
+    "count": 6,
+    "first": 7,
+    "last": 8,
+    "quantile": 9,
 }
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+# © H2O.ai 2018; -*- encoding: utf-8 -*-
+#   This Source Code Form is subject to the terms of the Mozilla Public
+#   License, v. 2.0. If a copy of the MPL was not distributed with this
+#   file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#-------------------------------------------------------------------------------
+from datatable.lib import core
+
+__all__ = ("FusedProgram", )
+
+
+
+class FusedProgram:
+    """
+    Program for the eager evaluation of a whole tree of operators at once.
+
+    The operators of the tree are written in postfix order, and the program is
+    then executed by the core (see "c/expr/fused.cc"), which applies all the
+    operators to one small chunk of rows at a time. Thus, none of the
+    intermediate results is ever materialized as a full-length column.
+
+    Each expression node appends itself to the program via its `fuse()`
+    method. The operator nodes add their arguments and then the instruction
+    for the operator itself; all other nodes are evaluated eagerly, and their
+    result is passed to the program as an input column.
+    """
+    __slots__ = ["_engine", "_kinds", "_args", "_inputs", "_input_keys"]
+
+    def __init__(self, ee):
+        self._engine = ee
+        self._kinds = []
+        self._args = []
+        self._inputs = []
+        self._input_keys = {}
+
+    @staticmethod
+    def evaluate(expr, ee):
+        """Evaluate the expression `expr` (using evaluation engine `ee`)."""
+        program = FusedProgram(ee)
+        expr.fuse(program)
+        return core.expr_fused(program._kinds, program._args, program._inputs)
+
+    @staticmethod
+    def filter(expr, ee, nrows, inverse=False, rowindex=None):
+        """
+        Evaluate the boolean expression `expr` over `nrows` rows, and return
+        the RowIndex of the rows where it is true (or, if `inverse` is True,
+        where it is false or NA). The `rowindex`, if given, is then applied
+        to the result (same as `.uplift(rowindex)`).
+        """
+        program = FusedProgram(ee)
+        expr.fuse(program)
+        return core.expr_fused_filter(program._kinds, program._args,
+                                      program._inputs, nrows, inverse,
+                                      rowindex)
+
+    def add_input(self, expr, key=None):
+        """
+        Evaluate `expr` eagerly, and push its result onto the stack. If `key`
+        is given, then the expressions with the same key are evaluated only
+        once. The columns of a view are not materialized: the program reads
+        them through their RowIndex.
+        """
+        if key is None or key not in self._input_keys:
+            self._inputs.append(expr.evaluate_view(self._engine))
+            if key is not None:
+                self._input_keys[key] = len(self._inputs) - 1
+            index = len(self._inputs) - 1
+        else:
+            index = self._input_keys[key]
+        self._kinds.append(0)
+        self._args.append(index)
+
+    def add_unary(self, opcode):
+        """Apply the unary operator `opcode` to the top of the stack."""
+        self._kinds.append(1)
+        self._args.append(opcode)
+
+    def add_binary(self, opcode):
+        """Apply the binary operator `opcode` to the two topmost values."""
+        self._kinds.append(2)
+        self._args.append(opcode)
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+# © H2O.ai 2018; -*- encoding: utf-8 -*-
+#   This Source Code Form is subject to the terms of the Mozilla Public
+#   License, v. 2.0. If a copy of the MPL was not distributed with this
+#   file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#-------------------------------------------------------------------------------
+import datatable
+from .base_expr import BaseExpr
+from ..utils.typechecks import TTypeError, Frame_t, is_type
+from ..types import stype
+from datatable.lib import core
+
+__all__ = ("isin", )
+
+
+class Isin(BaseExpr):
+    """
+    Set membership test: for each row, whether the value of `arg` is among
+    the `values` (a single-column Frame). The core builds a set from the
+    values once, and then probes it with all rows in a single pass.
+    """
+    __slots__ = ["_arg", "_values"]
+
+    def __init__(self, arg, values):
+        super().__init__()
+        self._arg = arg
+        self._values = values
+
+    def resolve(self):
+        self._arg.resolve()
+        self._stype = stype.bool8
+
+    def evaluate_eager(self, ee):
+        col = self._arg.evaluate_eager(ee)
+        vals = self._values.internal
+        valscol = core.expr_column(vals, 0, vals.rowindex)
+        return core.expr_isin(col, valscol)
+
+    def __str__(self):
+        return "isin(%s, <%d values>)" % (self._arg, self._values.nrows)
+
+
+
+def isin(x, values):
+    """
+    Test whether the values of expression `x` are present in `values`, which
+    may be either a list / tuple / set of python values, or a Frame with a
+    single column. The result is a boolean column, which is never NA: NA
+    values of `x` are "in" `values` only if `values` contain an NA too.
+    """
+    if not is_type(values, Frame_t):
+        values = list(values)
+        # An empty list would otherwise produce a Frame with no columns. An
+        # empty column is compatible with `x` of any type.
+        values = datatable.Frame([values] if not values else values)
+    if values.ncols != 1:
+        raise TTypeError("Frame must have a single column")
+    if isinstance(x, BaseExpr):
+        return Isin(x, values)
+    if is_type(x, Frame_t):
+        if x.ncols != 1:
+            raise TTypeError("Frame must have a single column")
+        return x(select=lambda f: isin(f[0], values))
+    return x in values.topython()[0]
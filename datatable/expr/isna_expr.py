@@ -6,10 +6,10 @@
 #-------------------------------------------------------------------------------
 import math
 from .base_expr import BaseExpr
+from .fused_expr import FusedProgram
 from .unary_expr import unary_op_codes
 from ..utils.typechecks import TTypeError, Frame_t, is_type
 from ..types import stype
-from datatable.lib import core
 
 __all__ = ("isna", )
 
@@ -26,9 +26,11 @@ class Isna(BaseExpr):
         self._stype = stype.bool8
 
     def evaluate_eager(self, ee):
-        arg = self._arg.evaluate_eager(ee)
-        opcode = unary_op_codes["isna"]
-        return core.expr_unaryop(opcode, arg)
+        return FusedProgram.evaluate(self, ee)
+
+    def fuse(self, program):
+        self._arg.fuse(program)
+        program.add_unary(unary_op_codes["isna"])
 
     def _isna(self, key, block):
         # The function always returns either True or False but never NA
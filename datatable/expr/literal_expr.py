@@ -51,15 +51,28 @@ class LiteralExpr(BaseExpr):
 
 
     def _notna(self, key, block):
-        return str(self.arg)
+        if self.arg is None:
+            return str(self.arg)
+        return self._literal_var(block)
 
 
     def _value(self, key, block):
         if self.arg is None:
             return nas_map[self.stype]
         else:
-            return str(self.arg)
+            return self._literal_var(block)
+
+
+    def _literal_var(self, block):
+        # The value is not embedded into the generated code, so that the
+        # compiled kernel may be reused with other values of the literal
+        ctype = "double" if self.stype in (stype.float32, stype.float64) \
+                else "int64_t"
+        return block.get_literal(self.arg, ctype)
 
 
     def __str__(self):
-        return self._value(None, None)
+        if self.arg is None:
+            return nas_map[self.stype]
+        else:
+            return str(self.arg)
@@ -16,6 +16,7 @@ def mean(expr, skipna=True):
 
 class MeanReducer(BaseExpr):
     __slots__ = ["expr", "skipna"]
+    is_reducer = True
 
     def __init__(self, expr, skipna=True):
         super().__init__()
@@ -33,11 +34,15 @@ class MeanReducer(BaseExpr):
 
 
     def evaluate_eager(self, ee):
-        col = self.expr.evaluate_eager(ee)
+        col = self.expr.evaluate_view(ee)
         opcode = reduce_opcodes["mean"]
         return core.expr_reduceop(opcode, col)
 
 
+    def reduce_op(self):
+        return (reduce_opcodes["mean"], self.expr, 0.0)
+
+
     def __str__(self):
         return "mean%d(%s)" % (self.skipna, self.expr)
 
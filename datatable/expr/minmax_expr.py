@@ -41,6 +41,7 @@ def max(*args, **kwds):
 
 
 class MinMaxReducer(BaseExpr):
+    is_reducer = True
 
     def __init__(self, expr, ismin, skipna=True):
         super().__init__()
@@ -55,10 +56,13 @@ class MinMaxReducer(BaseExpr):
 
 
     def evaluate_eager(self, ee):
-        col = self._arg.evaluate_eager(ee)
+        col = self._arg.evaluate_view(ee)
         opcode = reduce_opcodes[self._name]
         return core.expr_reduceop(opcode, col)
 
+    def reduce_op(self):
+        return (reduce_opcodes[self._name], self._arg, 0.0)
+
 
     def __str__(self):
         return "%s%d(%s)" % (self._name, self._skipna, self._arg)
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+# © H2O.ai 2018; -*- encoding: utf-8 -*-
+#   This Source Code Form is subject to the terms of the Mozilla Public
+#   License, v. 2.0. If a copy of the MPL was not distributed with this
+#   file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#-------------------------------------------------------------------------------
+import builtins
+
+from .base_expr import BaseExpr
+from .consts import ops_rules, reduce_opcodes
+from ..utils.typechecks import TValueError
+from datatable.lib import core
+
+__all__ = ("sum", "count", "first", "last", "median", "quantile",
+           "ReduceExpr")
+
+
+# noinspection PyShadowingBuiltins
+def sum(*args, **kwds):
+    if len(args) == 1 and isinstance(args[0], BaseExpr):
+        return ReduceExpr("sum", args[0])
+    else:
+        return builtins.sum(*args, **kwds)
+
+
+def count(expr):
+    """Number of non-NA values in `expr` (within each group)."""
+    return ReduceExpr("count", expr)
+
+
+def first(expr):
+    """The first value of `expr` (within each group)."""
+    return ReduceExpr("first", expr)
+
+
+def last(expr):
+    """The last value of `expr` (within each group)."""
+    return ReduceExpr("last", expr)
+
+
+def median(expr):
+    """Median of the non-NA values of `expr` (within each group)."""
+    return ReduceExpr("median", expr, 0.5)
+
+
+def quantile(expr, q):
+    """
+    Quantile `q` (a number between 0 and 1) of the non-NA values of `expr`
+    (within each group). The quantile is interpolated linearly between the
+    values of the closest ranks.
+    """
+    if not (isinstance(q, (int, float)) and 0 <= q <= 1):
+        raise TValueError("Quantile must be a number in the range [0; 1], "
+                          "got %r" % (q, ))
+    return ReduceExpr("quantile", expr, float(q))
+
+
+
+class ReduceExpr(BaseExpr):
+    """
+    Reduction `op` applied to expression `expr`, computed natively by
+    `core.expr_reduceop()`. The `param` is passed to reductions that
+    require an argument (such as the quantile).
+    """
+    __slots__ = ["_op", "_arg", "_param"]
+    is_reducer = True
+
+    def __init__(self, op, expr, param=0.0):
+        super().__init__()
+        self._op = op
+        self._arg = expr
+        self._param = param
+
+
+    def resolve(self):
+        self._arg.resolve()
+        arg_stype = self._arg.stype
+        self._stype = ops_rules.get((self._op, arg_stype), None)
+        if self._stype is None:
+            raise TValueError("Cannot compute %s of a variable of type %s"
+                              % (self._op, arg_stype))
+
+
+    def evaluate_eager(self, ee):
+        col = self._arg.evaluate_view(ee)
+        opcode, _, param = self.reduce_op()
+        return core.expr_reduceop(opcode, col, param)
+
+
+    def reduce_op(self):
+        op = "quantile" if self._op == "median" else self._op
+        return (reduce_opcodes[op], self._arg, self._param)
+
+
+    def __str__(self):
+        if self._op == "quantile":
+            return "quantile(%s, %r)" % (self._arg, self._param)
+        return "%s(%s)" % (self._op, self._arg)
@@ -7,10 +7,9 @@
 
 from .base_expr import BaseExpr
 from .binary_expr import binary_op_codes
+from .fused_expr import FusedProgram
 from .literal_expr import LiteralExpr
 from ..types import stype
-from datatable.utils.typechecks import TValueError
-from datatable.lib import core
 
 
 
@@ -74,13 +73,9 @@ class RelationalOpExpr(BaseExpr):
     #---------------------------------------------------------------------------
 
     def evaluate_eager(self, ee):
-        lhs = self._lhs.evaluate_eager(ee)
-        rhs = self._rhs.evaluate_eager(ee)
-        nl = lhs.nrows
-        nr = rhs.nrows
-        if nl == nr or nl == 1 or nr == 1:
-            opcode = binary_op_codes[self._op]
-            return core.expr_binaryop(opcode, lhs, rhs)
-        else:
-            raise TValueError("Cannot apply op '%s' on incompatible columns "
-                              "of sizes %d and %d" % (self._op, nl, nr))
+        return FusedProgram.evaluate(self, ee)
+
+    def fuse(self, program):
+        self._lhs.fuse(program)
+        self._rhs.fuse(program)
+        program.add_binary(binary_op_codes[self._op])
@@ -14,6 +14,7 @@ def sd(expr, skipna=True):
 
 
 class StdevReducer(BaseExpr):
+    is_reducer = True
 
     def __init__(self, expr, skipna=True):
         super().__init__()
@@ -29,10 +30,13 @@ class StdevReducer(BaseExpr):
                 % self.expr.stype)
 
     def evaluate_eager(self, ee):
-        col = self.expr.evaluate_eager(ee)
+        col = self.expr.evaluate_view(ee)
         opcode = reduce_opcodes["stdev"]
         return core.expr_reduceop(opcode, col)
 
+    def reduce_op(self):
+        return (reduce_opcodes["stdev"], self.expr, 0.0)
+
 
     def __str__(self):
         return "sd%d(%s)" % (self.skipna, self.expr)
@@ -7,6 +7,7 @@
 
 from .base_expr import BaseExpr
 from .consts import unary_ops_rules, unary_op_codes
+from .fused_expr import FusedProgram
 from ..types import stype
 from datatable.utils.typechecks import TTypeError
 from datatable.lib import core
@@ -30,9 +31,15 @@ class UnaryOpExpr(BaseExpr):
             self._op = "!"
 
     def evaluate_eager(self, ee):
-        arg = self._arg.evaluate_eager(ee)
-        opcode = unary_op_codes[self._op]
-        return core.expr_unaryop(opcode, arg)
+        if self._op == "+":
+            arg = self._arg.evaluate_eager(ee)
+            return core.expr_unaryop(unary_op_codes["+"], arg)
+        return FusedProgram.evaluate(self, ee)
+
+    def fuse(self, program):
+        self._arg.fuse(program)
+        if self._op != "+":
+            program.add_unary(unary_op_codes[self._op])
 
 
     def _isna(self, key, block):
@@ -574,23 +574,108 @@ class Frame(object):
     save = dt_save
 
 
-    @typed(by=U(str, int))
-    def sort(self, by):
+    @typed(by=U(str, int, [U(str, int)]), descending=U(bool, [bool]),
+           na_position=str)
+    def sort(self, by, descending=False, na_position="first"):
         """
-        Sort datatable by the specified column.
+        Sort datatable by the specified column(s).
 
         Parameters
         ----------
-        by: str or int
-            Name or index of the column to sort by.
+        by: str or int or list
+            Name or index of the column to sort by. This may also be a list of
+            column names / indices, in which case the datatable is sorted by
+            the first column, then the ties are resolved using the second
+            column, and so on.
+
+        descending: bool or list of bools
+            If True, sort in descending order instead of ascending. When
+            sorting by multiple columns, this may also be a list with the
+            direction for each column. The sort remains stable in either
+            direction.
+
+        na_position: "first" or "last"
+            Whether the NA values should be placed before or after all other
+            values in the sorted datatable.
 
         Returns
         -------
-        New datatable sorted by the provided column. The target datatable
+        New datatable sorted by the provided column(s). The target datatable
         remains unmodified.
         """
+        if isinstance(by, list):
+            if not by:
+                raise TValueError("At least one column must be specified "
+                                  "for sorting")
+            idx = [self.colindex(col) for col in by]
+        else:
+            idx = [self.colindex(by)]
+        if isinstance(descending, list):
+            if len(descending) != len(idx):
+                raise TValueError("The length of the `descending` list (%d) "
+                                  "does not match the number of columns to "
+                                  "sort by (%d)" % (len(descending), len(idx)))
+        else:
+            descending = [descending] * len(idx)
+        if na_position not in ("first", "last"):
+            raise TValueError("Parameter `na_position` should be either "
+                              "'first' or 'last', got %r" % na_position)
+        idx = [~i if desc else i for i, desc in zip(idx, descending)]
+        ri = self._dt.sort(idx, False, na_position == "last")
+        cs = core.columns_from_slice(self._dt, ri, 0, self._ncols, 1)
+        _dt = cs.to_datatable()
+        return Frame(_dt, names=self.names)
+
+
+    @typed(by=U(str, int), k=int, groups=bool)
+    def nsmallest(self, by, k, groups=False):
+        """
+        Return the `k` rows with the smallest values in column `by`.
+
+        The result is the same as ``self.sort(by, na_position="last")[:k, :]``,
+        however it is computed without sorting the entire datatable, which is
+        considerably faster when `k` is small compared to the number of rows.
+        NA values are selected only when there are fewer than `k` valid values
+        in the column.
+
+        Parameters
+        ----------
+        by: str or int
+            Name or index of the column by which the rows are selected.
+
+        k: int
+            The number of rows to return. If `k` exceeds the number of rows in
+            the datatable, then all rows are returned (sorted).
+
+        groups: bool
+            If True, the selected rows are also split into groups of equal
+            values in column `by`, same as with ``groupby=by``: the group
+            sizes are available via ``.internal.rowindex.group_sizes``.
+
+        Returns
+        -------
+        New datatable with `min(k, nrows)` rows, sorted by column `by`.
+        """
+        return self._topk(by, k, False, groups)
+
+
+    @typed(by=U(str, int), k=int, groups=bool)
+    def nlargest(self, by, k, groups=False):
+        """
+        Return the `k` rows with the largest values in column `by`.
+
+        The result is the same as
+        ``self.sort(by, descending=True, na_position="last")[:k, :]``; see
+        :meth:`nsmallest` for details.
+        """
+        return self._topk(by, k, True, groups)
+
+
+    def _topk(self, by, k, descending, groups):
+        if k < 0:
+            raise TValueError("Parameter `k` cannot be negative: %d" % k)
         idx = self.colindex(by)
-        ri = self._dt.sort(idx)
+        ri = self._dt.topk(~idx if descending else idx, k, groups)
         cs = core.columns_from_slice(self._dt, ri, 0, self._ncols, 1)
         _dt = cs.to_datatable()
         return Frame(_dt, names=self.names)
@@ -666,6 +751,41 @@ class Frame(object):
         """
         return Frame(self._dt.get_sd(), names=self.names)
 
+    def quantile(self, q=0.5, approx=False):
+        """
+        Get the quantile `q` of each column.
+
+        The quantile is interpolated linearly between the values of the
+        closest ranks, same as in ``datatable.quantile()``. NA values are
+        ignored.
+
+        Parameters
+        ----------
+        q: float
+            A number in the range [0; 1].
+
+        approx: bool
+            If True, the quantile is estimated from a KLL sketch, built in the
+            same pass over the data as the other numeric stats (mean, sd,
+            etc). The rank of the estimated value is within 1.65% of the
+            requested rank, with 99% probability. Otherwise the exact
+            quantile is computed by sorting the column.
+
+        Returns
+        -------
+        A new datatable of shape (1, ncols) containing the computed quantile
+        for each column (or NA if not applicable).
+        """
+        return Frame(self._dt.get_quantile(q, approx), names=self.names)
+
+    def median(self, approx=False):
+        """
+        Get the median of each column.
+
+        This is the same as ``quantile(0.5, approx)``.
+        """
+        return self.quantile(0.5, approx)
+
     def countna(self):
         """
         Get the number of NA values in each column.
@@ -677,15 +797,26 @@ class Frame(object):
         """
         return Frame(self._dt.get_countna(), names=self.names)
 
-    def nunique(self):
+    def nunique(self, approx=False):
         """
         Get the number of unique values in each column.
 
+        Parameters
+        ----------
+        approx: bool
+            If True, the number of unique values is estimated using the
+            HyperLogLog sketch, which requires only one pass over the data
+            and a few KB of memory per column. The relative standard error
+            of the estimate is about 1.6%, and the estimate is nearly
+            unbiased for any number of unique values.
+
         Returns
         -------
         A new datatable of shape (1, ncols) containing the counted number of
         unique values in each column.
         """
+        if approx:
+            return Frame(self._dt.get_nunique_approx(), names=self.names)
         return Frame(self._dt.get_nunique(), names=self.names)
 
     def nmodal(self):
@@ -717,10 +848,18 @@ class Frame(object):
     def sd1(self):
         return self._dt.sd1()
 
+    def quantile1(self, q=0.5, approx=False):
+        return self._dt.quantile1(q, approx)
+
+    def median1(self, approx=False):
+        return self._dt.quantile1(0.5, approx)
+
     def countna1(self):
         return self._dt.countna1()
 
-    def nunique1(self):
+    def nunique1(self, approx=False):
+        if approx:
+            return self._dt.nunique_approx1()
         return self._dt.nunique1()
 
     def nmodal1(self):
@@ -937,6 +1076,14 @@ options.register_option(
         "Values less than zero allow to use that fewer threads than the "
         "maximum. Finally, nthreads=1 indicates single-threaded mode.")
 
+options.register_option(
+    "simd", xtype=str, default="auto", core=True,
+    doc="The widest SIMD instruction set that may be used by the vectorized "
+        "kernels (such as the arithmetic and comparison operators): one of "
+        "'avx512', 'avx2', 'sse4.2' or 'none'. The default 'auto' selects the "
+        "widest set supported by the CPU. Sets that are not supported by the "
+        "CPU are never used, regardless of this option.")
+
 options.register_option(
     "core_logger", xtype=object, default=None, core=True,
     doc="If you set this option to a Logger object, then every call to any "
@@ -962,4 +1109,26 @@ options.register_option(
     "sort.over_radix_bits", xtype=int, default=8, core=True)
 
 options.register_option(
-    "sort.nthreads", xtype=int, default=4, core=True)
\ No newline at end of file
+    "sort.nthreads", xtype=int, default=4, core=True)
+
+options.register_option(
+    "sort.max_merge_runs", xtype=int, default=8, core=True,
+    doc="Largest number of ascending runs in the data at which sorting will "
+        "be performed by merging these runs instead of the radix sort. Data "
+        "that is already sorted consists of a single run, and is not "
+        "re-sorted: its ordering is the identity, although finding the "
+        "groups (or caching the ordering) still takes a pass over the data.")
+
+options.register_option(
+    "sort.max_memory", xtype=int, default=0, core=True,
+    doc="Largest amount of memory (in bytes) that the sorting of a frame may "
+        "use for its working arrays. Frames that need more are sorted in "
+        "chunks, which are spilled to temporary memory-mapped files in the "
+        "TMPDIR directory and then merged. The value of 0 (default) means "
+        "no limit.")
+
+options.register_option(
+    "sort.force_int64", xtype=bool, default=False, core=True,
+    doc="Use 64-bit row indices and group offsets for sorting even when the "
+        "frame is small enough for the 32-bit ones. This option is intended "
+        "for testing only.")
\ No newline at end of file
@@ -152,11 +152,49 @@ class MixedCSNode(ColumnSetNode):
             ee = self._engine
             _dt = ee.dt.internal
             _ri = ee.rowindex
-            columns = [core.expr_column(_dt, e, _ri) if isinstance(e, int) else
-                       e.evaluate_eager(ee)
-                       for e in self._elems]
+            if self._is_reduce():
+                columns = self._compute_reduced_columns()
+            else:
+                columns = [core.expr_column(_dt, e, _ri)
+                           if isinstance(e, int) else e.evaluate_eager(ee)
+                           for e in self._elems]
+            if self._is_reduce() and ee.groupby is not None:
+                # Each reducer produces one value per group: prepend the
+                # group keys so that the groups can be identified.
+                columns = ee.groupby.key_columns() + columns
+                self._column_names = (tuple(ee.groupby.key_names) +
+                                      tuple(self._column_names))
             return core.columns_from_columns(columns)
 
+    def _is_reduce(self):
+        return all(isinstance(e, BaseExpr) and e.is_reducer
+                   for e in self._elems)
+
+    def _compute_reduced_columns(self):
+        """
+        Evaluate all reducers together, in a single pass over the groups.
+        Reducers applied to the same column of the Frame share that column.
+        The columns are not materialized: the reducers read them through the
+        RowIndex of the groups.
+        """
+        ee = self._engine
+        opcodes = []
+        args = []
+        params = []
+        argcols = {}
+        for e in self._elems:
+            opcode, arg, param = e.reduce_op()
+            if isinstance(arg, ColSelectorExpr):
+                key = ("col", arg.col_index)
+            else:
+                key = ("expr", id(arg))
+            if key not in argcols:
+                argcols[key] = arg.evaluate_view(ee)
+            opcodes.append(opcode)
+            args.append(argcols[key])
+            params.append(param)
+        return core.expr_reduceops(opcodes, args, params)
+
 
 
 
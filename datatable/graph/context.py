@@ -4,6 +4,7 @@
 #   License, v. 2.0. If a copy of the MPL was not distributed with this
 #   file, You can obtain one at http://mozilla.org/MPL/2.0/.
 #-------------------------------------------------------------------------------
+import ctypes
 import datatable
 from datatable.lib import core
 from .llvm import llvm
@@ -15,11 +16,12 @@ from .llvm import llvm
 #===============================================================================
 
 class EvaluationEngine:
-    __slots__ = ["dt", "rowindex", "columns"]
+    __slots__ = ["dt", "rowindex", "groupby", "columns"]
 
     def __init__(self, dt):
         self.dt = dt
         self.rowindex = None
+        self.groupby = None
         self.columns = None
 
     def is_compiled(self):
@@ -65,11 +67,12 @@ def make_engine(engine, dt):
 class EagerEvaluationEngine(EvaluationEngine):
     """
     This engine evaluates all expressions "eagerly", i.e. all operations are
-    done sequentially, through predefined C functions. For example,
-    `f.A + f.B * 2` will be computed in 2 steps: first, column "B" will be
-    multiplied by 2 to produce a new temporary column; then column "A" will be
-    added with that temporary column; finally the resulting column will be
-    converted into a Frame and returned.
+    done through predefined C functions. A tree of operators such as
+    `f.A + f.B * 2` is evaluated as a whole (see `FusedProgram`): for each
+    small chunk of rows, column "B" is multiplied by 2 into a scratch buffer,
+    and then added with column "A" into the resulting column. Thus no
+    full-length temporary columns are created. Finally the resulting column
+    is converted into a Frame and returned.
     """
     __slots__ = []
 
@@ -92,6 +95,19 @@ class LlvmEvaluationEngine(EvaluationEngine):
 
     This engine is more efficient than "Eager" for large datasets, however it
     requires access to Clang+LLVM runtime.
+
+    The generated program does not contain any values specific to the frames
+    it is applied to: pointers to the frames (and to the internal functions of
+    the core library), as well as the literal constants of the query, are
+    stored into global variables of the compiled module right before the
+    execution. This allows the compiled kernel to be reused by all subsequent
+    queries of the same shape.
+
+    Since these global variables are shared by all queries of the same shape,
+    the engine is not reentrant: two such queries must not be executed at the
+    same time (for example from different threads). The values are re-assigned
+    each time a function of the kernel is requested via `get_result()`, so
+    that queries executed one after another in any order are safe.
     """
 
     def __init__(self, dt):
@@ -104,7 +120,11 @@ class LlvmEvaluationEngine(EvaluationEngine):
         self._global_names = set()
         self._exported_functions = []
         self._function_pointers = None
+        self._global_addresses = None
         self._nodes = []
+        self._frames = []
+        self._literals = {}
+        self._global_values = dict(_header_values)
 
     def is_compiled(self):
         return True
@@ -115,14 +135,33 @@ class LlvmEvaluationEngine(EvaluationEngine):
     def get_result(self, n) -> int:
         assert n is not None
         if not self._function_pointers:
-            cc = self._gen_module()
-            self._function_pointers = llvm.jit(cc, self._exported_functions)
+            self._compile()
+        self._bind_globals()
         if isinstance(n, str):
             n = self._exported_functions.index(n)
         assert n < len(self._function_pointers)
         return self._function_pointers[n]
 
 
+    def _compile(self):
+        cc = self._gen_module()
+        key_extra = [(dt.internal.rowindex_type, dt.stypes)
+                     for dt in self._frames]
+        funcs, gaddrs = llvm.jit(cc, self._exported_functions,
+                                 list(self._global_values), key_extra)
+        self._global_addresses = [(gaddrs[name], value) for name, value
+                                  in self._global_values.items()]
+        self._function_pointers = funcs
+
+
+    def _bind_globals(self):
+        # The kernel may have been used by another query since it was
+        # compiled: point its global variables back to this query's frames
+        # and constants
+        for addr, value in self._global_addresses:
+            ctypes.memmove(addr, ctypes.addressof(value), ctypes.sizeof(value))
+
+
     def add_function(self, name, body):
         assert name not in self._global_names
         self._functions[name] = body
@@ -154,10 +193,42 @@ class LlvmEvaluationEngine(EvaluationEngine):
         return prefix + str(self._var_counter)
 
     def get_dtvar(self, dt):
-        varname = "dt" + str(getattr(dt, "_id"))
-        if varname not in self._global_names:
-            ptr = dt.internal.datatable_ptr
-            self.add_global(varname, "void*", "(void*) %dL" % ptr)
+        """
+        Return the name of the global variable holding the pointer to frame
+        `dt`. The variables are numbered by the order in which the frames
+        appear in the query (rather than by the frames' ids), so that the
+        generated code does not depend on which particular frames the query
+        is applied to. All other identifiers related to the frame should be
+        derived from this name.
+        """
+        for i, frame in enumerate(self._frames):
+            if frame is dt:
+                return "dt%d" % i
+        varname = "dt%d" % len(self._frames)
+        # The pointer is not embedded into the code, but rather assigned to
+        # the (exported) global variable after compilation
+        self._global_declarations += "void* %s = NULL;\n" % varname
+        self._global_names.add(varname)
+        self._global_values[varname] = \
+            ctypes.c_void_p(dt.internal.datatable_ptr)
+        self._frames.append(dt)
+        return varname
+
+    def get_literal(self, value, ctype):
+        """
+        Return the name of the global variable holding the literal `value` of
+        C type `ctype` ("int64_t" or "double"). Same as frame pointers, the
+        literals are assigned after compilation, so that the queries which
+        differ only in their constants share the compiled kernel.
+        """
+        key = (ctype, repr(value))
+        varname = self._literals.get(key)
+        if varname is None:
+            varname = "lit%d" % len(self._literals)
+            self._global_declarations += "%s %s = 0;\n" % (ctype, varname)
+            self._global_names.add(varname)
+            self._global_values[varname] = _literal_ctypes[ctype](value)
+            self._literals[key] = varname
         return varname
 
 
@@ -203,14 +274,17 @@ decl_sizes = "\n".join(["typedef signed char int8_t;",
                         "typedef unsigned %s uint64_t;" % t64,
                         "typedef unsigned %s size_t;" % tsz])
 
-(ptr_dt_malloc,
- ptr_dt_realloc,
- ptr_dt_free,
- # ptr_rowindex_from_filterfn32,
- ptr_dt_column_data,
- ptr_dt_unpack_slicerowindex,
- ptr_dt_unpack_arrayrowindex) = core.get_internal_function_ptrs()
+_literal_ctypes = {"int64_t": ctypes.c_int64, "double": ctypes.c_double}
 
+_header_values = dict(zip(["dt_malloc",
+                           "dt_realloc",
+                           "dt_free",
+                           # "rowindex_from_filterfn32",
+                           "dt_column_data",
+                           "dt_unpack_slicerowindex",
+                           "dt_unpack_arrayrowindex"],
+                          map(ctypes.c_void_p,
+                              core.get_internal_function_ptrs())))
 
 _header = """
 /**
@@ -228,13 +302,13 @@ typedef void* (*ptr_3)(void*, int64_t, int);
 typedef void* (*ptr_4)(void*, int64_t);
 typedef void (*ptr_5)(void*, int64_t*, int64_t*);
 typedef void (*ptr_6)(void*, void**);
-static ptr_0 dt_malloc = (ptr_0) %dL;
-static ptr_1 dt_realloc = (ptr_1) %dL;
-static ptr_2 dt_free = (ptr_2) %dL;
-// static ptr_3 rowindex_from_filterfn32 = (ptr_3) %%dL;
-static ptr_4 dt_column_data = (ptr_4) %dL;
-static ptr_5 dt_unpack_slicerowindex = (ptr_5) %dL;
-static ptr_6 dt_unpack_arrayrowindex = (ptr_6) %dL;
+ptr_0 dt_malloc = NULL;
+ptr_1 dt_realloc = NULL;
+ptr_2 dt_free = NULL;
+// ptr_3 rowindex_from_filterfn32 = NULL;
+ptr_4 dt_column_data = NULL;
+ptr_5 dt_unpack_slicerowindex = NULL;
+ptr_6 dt_unpack_arrayrowindex = NULL;
 
 #define BIN_NAF4 0x7F8007A2u
 #define BIN_NAF8 0x7FF00000000007A2ull
@@ -254,14 +328,7 @@ static inline double _nand_(void) { double_repr x = { BIN_NAF8 }; return x.d; }
 #define NA_F4  _nanf_()
 #define NA_F8  _nand_()
 
-""" % (decl_sizes,
-       ptr_dt_malloc,
-       ptr_dt_realloc,
-       ptr_dt_free,
-       # ptr_rowindex_from_filterfn32,
-       ptr_dt_column_data,
-       ptr_dt_unpack_slicerowindex,
-       ptr_dt_unpack_arrayrowindex)
+""" % decl_sizes
 
 
 _externs = {
@@ -4,20 +4,54 @@
 #   License, v. 2.0. If a copy of the MPL was not distributed with this
 #   file, You can obtain one at http://mozilla.org/MPL/2.0/.
 #-------------------------------------------------------------------------------
+import types
+
 from .cols_node import process_column
+from datatable.lib import core
+from datatable.options import options
 from datatable.utils.typechecks import TTypeError, TValueError
 
 
 class SimpleGroupbyNode:
+    """
+    Group the rows of a Frame by the values in one or more of its columns.
+
+    With the "sort" method, the grouping is performed by sorting the Frame by
+    the key columns (in the order given), and recording the boundaries between
+    the runs of equal key tuples as the groups information of the resulting
+    RowIndex. With the "hash" method, the rows are grouped using a hash table
+    instead: the rows of each group are still contiguous in the RowIndex,
+    however the groups are not ordered by their keys.
+    """
 
-    def __init__(self, ee, col):
+    def __init__(self, ee, cols, names, method):
         self._engine = ee
-        self._col = col
+        self._cols = cols
+        self._names = names
+        self._method = method
+        self._rowindex = None
+
+    @property
+    def key_names(self):
+        return self._names
 
     def execute(self):
         df = self._engine.dt
-        rowindex = df.internal.sort(self._col, True)
+        if self._method == "hash":
+            rowindex = df.internal.hash_groupby(self._cols)
+        else:
+            rowindex = df.internal.sort(self._cols, True)
         self._engine.rowindex = rowindex
+        self._rowindex = rowindex
+
+    def key_columns(self):
+        """
+        Return the list of key columns for the grouped Frame: each column
+        contains one value per group, in the same order as the groups.
+        """
+        _dt = self._engine.dt.internal
+        firsts = self._rowindex.group_firsts()
+        return [core.expr_column(_dt, i, firsts) for i in self._cols]
 
 
 
@@ -25,10 +59,50 @@ def make_groupby(grby, ee):
     if grby is None:
         return None
 
-    # TODO: change to ee.make_columnset() when we can do multi-col sorts
-    grbycol = process_column(grby, ee.dt)
-    if not isinstance(grbycol, int):
-        raise TTypeError("Currently only single-column group-bys are "
-                         "supported")
+    method = options.groupby.method
+    if method not in ("sort", "hash"):
+        raise TValueError("Invalid groupby method %r: must be either 'sort' "
+                          "or 'hash'" % method)
+
+    if isinstance(grby, dict):
+        items = list(grby.items())
+    elif isinstance(grby, (types.GeneratorType, list, tuple)):
+        items = [(None, col) for col in grby]
+    else:
+        items = [(None, grby)]
+
+    df = ee.dt
+    cols = []
+    names = []
+    for name, col in items:
+        pcol = process_column(col, df)
+        if isinstance(pcol, int):
+            cols.append(pcol)
+            names.append(name or df.names[pcol])
+        elif isinstance(pcol, tuple):
+            start, count, step = pcol
+            for i in range(count):
+                j = start + i * step
+                cols.append(j)
+                if name is None:
+                    names.append(df.names[j])
+                else:
+                    names.append(name + str(i) if i > 0 else name)
+        else:
+            raise TTypeError("Computed columns cannot be used as groupby "
+                             "keys")
+    if not cols:
+        raise TValueError("Groupby requires at least one column")
+
+    ee.groupby = SimpleGroupbyNode(ee, cols, names, method)
+    return ee.groupby
+
+
 
-    return SimpleGroupbyNode(ee, grbycol)
+options.register_option(
+    "groupby.method", xtype=str, default="sort",
+    doc="Algorithm used to group the rows of a Frame: either 'sort' (the "
+        "groups are ordered by their keys), or 'hash' (the groups are found "
+        "using a hash table, and come in no particular order). The 'hash' "
+        "method is faster when there are many groups, and their order is "
+        "not important.")
@@ -96,6 +96,9 @@ class IteratorNode(object):
     def get_dtvar(self, dt):
         return self._cnode.get_dtvar(dt)
 
+    def get_literal(self, value, ctype):
+        return self._cnode.get_literal(value, ctype)
+
     def add_extern(self, name):
         self._cnode.add_extern(name)
 
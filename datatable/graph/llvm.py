@@ -4,10 +4,14 @@
 #   License, v. 2.0. If a copy of the MPL was not distributed with this
 #   file, You can obtain one at http://mozilla.org/MPL/2.0/.
 #-------------------------------------------------------------------------------
+import hashlib
 import os
+from collections import OrderedDict
 import re
 import subprocess
 from llvmlite import binding
+from datatable.__version__ import version as dt_version
+from datatable.options import options
 from datatable.utils.terminal import term
 from datatable.utils.typechecks import TValueError
 
@@ -16,15 +20,34 @@ __all__ = ("llvm", )
 
 
 class Llvm:
-    __slots__ = ["_clang", "_engine"]
+    """
+    Compiler of the C code generated by the LlvmEvaluationEngine.
+
+    The C code is translated into LLVM IR with the `clang` compiler, and then
+    JIT-compiled in-process with MCJIT. Compiled kernels are cached, keyed by
+    the hash of their code: a query of the same shape as some previous one
+    (even if applied to a different frame, or with different constants) thus
+    skips compilation entirely. At most `llvm.cache_size` kernels are kept:
+    when the cache is full, the least recently used kernel is removed from
+    the execution engine.
+    Optionally, the kernels can also be persisted on disk (see option
+    `llvm.cache_dir`), in which case `clang` is not invoked for them in
+    subsequent sessions (the C code is still generated, since its hash is
+    the cache key).
+
+    Note that the C code can only be translated into LLVM IR by running
+    `clang` as a subprocess: each kernel that is not found in either cache
+    still costs a `clang` invocation.
+
+    Neither `clang` nor the LLVM execution engine are initialized until the
+    first kernel has to be compiled.
+    """
+    __slots__ = ["_clang", "_engine", "_kernels"]
 
     def __init__(self):
-        self._clang = self._find_clang()
-        if self._clang:
-            self._engine = self._create_execution_engine()
-        else:
-            # LLVM/CLang engine not available
-            self._engine = None
+        self._clang = None
+        self._engine = None
+        self._kernels = OrderedDict()
 
 
     #---------------------------------------------------------------------------
@@ -33,31 +56,49 @@ class Llvm:
 
     @property
     def available(self):
-        return self._clang
+        if self._clang is None:
+            self._clang = self._find_clang() or ""
+        return self._clang or None
 
 
-    def jit(self, cc, func_names):
-        try:
-            llvmir = self._c_to_llvm(cc)
-            self._compile_llvmir(llvmir)
-        except RuntimeError as e:
-            mm = re.search(r"<stdin>:(\d+):(\d+):\s*(.*)", e.args[0])
-            if mm:
-                lineno = int(mm.group(1))
-                charno = int(mm.group(2))
-                lines = cc.split("\n")
-                for i in range(len(lines)):
-                    print(lines[i])
-                    if i == lineno - 1:
-                        print(" " * (charno - 1) +
-                              term.bold("^--- ") +
-                              term.bright_red(mm.group(3)))
-            else:
-                print("\nError while trying to compile this code:\n")
-                print(cc)
-                print()
-            raise e
-        return [self._engine.get_function_address(f) for f in func_names]
+    @property
+    def ncached(self):
+        """Number of the compiled kernels in the in-memory cache."""
+        return len(self._kernels)
+
+
+    def jit(self, cc, func_names, global_names=(), key_extra=None):
+        """
+        Compile C code `cc`, and return the list of addresses of functions
+        `func_names` in the compiled code, together with the dictionary of
+        addresses of (non-static) global variables `global_names`.
+
+        The code is compiled only if it wasn't compiled before: the cache key
+        is the hash of `cc` and `key_extra`, together with the versions of
+        datatable and of LLVM (so that the files cached on disk by a different
+        build are never reused). Since the same kernel may be reused by many
+        queries, the code should not embed any values specific to a particular
+        query (such as pointers): these should be passed via global variables
+        instead. These variables are shared by all users
+        of the kernel, so the kernel cannot be executed by two queries at the
+        same time.
+
+        Compiling a new kernel may evict the least recently used one from the
+        cache, which invalidates the addresses returned for it: these should
+        be used right away, and not kept across calls to `jit()`.
+        """
+        key = hashlib.sha1("\0".join([
+            cc, repr(key_extra), dt_version, repr(binding.llvm_version_info)
+        ]).encode()).hexdigest()
+        kernel = self._kernels.get(key)
+        if kernel is None:
+            kernel = self._compile_kernel(key, cc, func_names, global_names)
+            self._kernels[key] = kernel
+            self._evict(max(options.llvm.cache_size, 1))
+        else:
+            self._kernels.move_to_end(key)
+        funcs, gvars, _ = kernel
+        return funcs, gvars
 
 
     #---------------------------------------------------------------------------
@@ -77,6 +118,11 @@ class Llvm:
                     return clang
         return None
 
+    def _get_engine(self):
+        if self._engine is None:
+            self._engine = self._create_execution_engine()
+        return self._engine
+
     def _create_execution_engine(self):
         """
         Create an ExecutionEngine suitable for JIT code generation on the host
@@ -92,6 +138,7 @@ class Llvm:
         # And an execution engine with an empty backing module
         backing_mod = binding.parse_assembly("")
         engine = binding.create_mcjit_compiler(backing_mod, target_machine)
+        engine.set_object_cache(self._save_object, self._load_object)
         return engine
 
 
@@ -99,8 +146,64 @@ class Llvm:
     # Compiling and executing C code
     #---------------------------------------------------------------------------
 
+    def _compile_kernel(self, key, cc, func_names, global_names):
+        """
+        Compile a kernel that is not in the in-memory cache: the LLVM IR is
+        read from the on-disk cache if possible, and otherwise produced by
+        running `clang` on `cc`.
+        """
+        # All modules share the same execution engine, so the exported symbols
+        # of each kernel are made unique by appending the key to their names.
+        suffix = "_" + key[:16]
+        names = list(func_names) + list(global_names)
+        if names:
+            rx = re.compile(r"\b(%s)\b" % "|".join(re.escape(n) for n in names))
+            cc = rx.sub(lambda mm: mm.group(1) + suffix, cc)
+        llvmir = self._read_cache_file(key, ".ll")
+        if llvmir is None:
+            llvmir = self._c_to_llvm_verbose(cc)
+            self._write_cache_file(key, ".ll", llvmir)
+        else:
+            llvmir = llvmir.decode()
+        module = self._compile_llvmir(llvmir, key)
+        engine = self._engine
+        funcs = [engine.get_function_address(f + suffix) for f in func_names]
+        gvars = {g: engine.get_global_value_address(g + suffix)
+                 for g in global_names}
+        return funcs, gvars, module
+
+
+    def _evict(self, nkeep):
+        """Remove the least recently used kernels, keeping at most `nkeep`."""
+        while len(self._kernels) > nkeep:
+            _, (_, _, module) = self._kernels.popitem(last=False)
+            self._engine.remove_module(module)
+
+
+    def _c_to_llvm_verbose(self, cc):
+        try:
+            return self._c_to_llvm(cc)
+        except RuntimeError as e:
+            mm = re.search(r"<stdin>:(\d+):(\d+):\s*(.*)", e.args[0])
+            if mm:
+                lineno = int(mm.group(1))
+                charno = int(mm.group(2))
+                lines = cc.split("\n")
+                for i in range(len(lines)):
+                    print(lines[i])
+                    if i == lineno - 1:
+                        print(" " * (charno - 1) +
+                              term.bold("^--- ") +
+                              term.bright_red(mm.group(3)))
+            else:
+                print("\nError while trying to compile this code:\n")
+                print(cc)
+                print()
+            raise e
+
+
     def _c_to_llvm(self, code):
-        if self._clang is None:
+        if not self.available:
             raise TValueError("LLVM execution engine is not available")
         proc = subprocess.Popen(args=[self._clang, "-x", "c", "-S",
                                       "-emit-llvm", "-o", "-", "-"],
@@ -113,12 +216,64 @@ class Llvm:
         return out.decode()
 
 
-    def _compile_llvmir(self, llvm_code):
+    def _compile_llvmir(self, llvm_code, name):
+        engine = self._get_engine()
         m = binding.parse_assembly(llvm_code)
         m.verify()
-        self._engine.add_module(m)
-        self._engine.finalize_object()
+        # The name of the module is used as the key in the object cache
+        m.name = name
+        engine.add_module(m)
+        engine.finalize_object()
         return m
 
 
+    #---------------------------------------------------------------------------
+    # On-disk cache
+    #---------------------------------------------------------------------------
+
+    def _save_object(self, module, buf):
+        self._write_cache_file(module.name, ".o", buf)
+
+    def _load_object(self, module):
+        return self._read_cache_file(module.name, ".o")
+
+    def _read_cache_file(self, key, ext):
+        cache_dir = options.llvm.cache_dir
+        if cache_dir:
+            filename = os.path.join(os.path.expanduser(cache_dir), key + ext)
+            if os.path.isfile(filename):
+                with open(filename, "rb") as inp:
+                    return inp.read()
+        return None
+
+    def _write_cache_file(self, key, ext, content):
+        cache_dir = options.llvm.cache_dir
+        if cache_dir:
+            cache_dir = os.path.expanduser(cache_dir)
+            os.makedirs(cache_dir, exist_ok=True)
+            if isinstance(content, str):
+                content = content.encode()
+            filename = os.path.join(cache_dir, key + ext)
+            # Write into a temporary file first, so that a concurrent reader
+            # never sees a partially written file
+            tmpname = "%s.%d.tmp" % (filename, os.getpid())
+            with open(tmpname, "wb") as out:
+                out.write(content)
+            os.replace(tmpname, filename)
+
+
+
+options.register_option(
+    "llvm.cache_dir", xtype=str, default="",
+    doc="Directory where the kernels compiled by the LLVM evaluation engine "
+        "are persisted, so that they can be reused in subsequent sessions "
+        "without recompiling. The default empty string means that the "
+        "compiled kernels are cached in memory only.")
+
+options.register_option(
+    "llvm.cache_size", xtype=int, default=64,
+    doc="Largest number of the kernels compiled by the LLVM evaluation "
+        "engine that are kept in memory. When this number is exceeded, the "
+        "least recently used kernel is discarded.")
+
 llvm = Llvm()
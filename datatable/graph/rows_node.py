@@ -10,6 +10,7 @@ import datatable
 from datatable.lib import core
 from .iterator_node import IteratorNode
 from datatable.expr import BaseExpr
+from datatable.expr.fused_expr import FusedProgram
 from datatable.graph.dtproxy import f
 from .context import EvaluationEngine, LlvmEvaluationEngine
 from datatable.types import stype, ltype
@@ -328,13 +329,12 @@ class FilterExprRFNode(RFNode):
             ptr = ee.get_result(self._fnname)
             return core.rowindex_from_filterfn(ptr, nrows)
         else:
-            col = self._expr.evaluate_eager(self._engine)
-            rowindex = core.rowindex_from_column(col)
-            if self._inverse:
-                rowindex = rowindex.inverse(nrows)
-            if ee.rowindex:
-                rowindex = rowindex.uplift(ee.rowindex)
-            return rowindex
+            # The expression is evaluated chunk-by-chunk, and the selected
+            # rows are written into the RowIndex directly, in the same pass
+            # that also applies the negation and the uplifting.
+            return FusedProgram.filter(self._expr, ee, nrows,
+                                       inverse=self._inverse,
+                                       rowindex=ee.rowindex)
 
 
     def _make_source_rowindex(self):
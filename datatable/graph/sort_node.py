@@ -5,7 +5,7 @@
 #   file, You can obtain one at http://mozilla.org/MPL/2.0/.
 #-------------------------------------------------------------------------------
 
-from datatable.utils.typechecks import TTypeError
+from datatable.utils.typechecks import TTypeError, TValueError
 
 
 
@@ -35,6 +35,19 @@ class SingleColumnSortNode(SortNode):
 
 
 
+class MultiColumnSortNode(SortNode):
+
+    def __init__(self, ee, colidxs):
+        super().__init__(ee)
+        self._colidxs = colidxs
+
+    def make_rowindex(self):
+        _dt = self.engine.dt.internal
+        rowindex = _dt.sort(self._colidxs)
+        return rowindex
+
+
+
 def make_sort(sort, ee):
     if sort is None:
         return None
@@ -43,4 +56,13 @@ def make_sort(sort, ee):
         colidx = ee.dt.colindex(sort)
         return SingleColumnSortNode(ee, colidx)
 
+    if isinstance(sort, (list, tuple)):
+        if not sort:
+            raise TValueError("At least one column must be specified for "
+                              "argument `sort`")
+        colidxs = [ee.dt.colindex(col) for col in sort]
+        if len(colidxs) == 1:
+            return SingleColumnSortNode(ee, colidxs[0])
+        return MultiColumnSortNode(ee, colidxs)
+
     raise TTypeError("Invalid parameter %r for argument `rows`" % sort)
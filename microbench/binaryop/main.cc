@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// © H2O.ai 2018
+//------------------------------------------------------------------------------
+// Benchmark of `expr::binaryop()` on two columns of the same stype.
+//
+// This program links against the actual datatable core, and measures the
+// arithmetic and relational operators exactly as they are evaluated from
+// Python. For each combination of the parameters below, two random columns
+// are generated, and the operator is applied to them `iters` times. The best
+// time is reported, together with the throughput in millions of rows per
+// second, and the speedup relative to the scalar kernels (`simd=none`, which
+// is therefore always benchmarked first).
+//
+// Parameters (each one may be given as a comma-separated list of values,
+// and all combinations of these values will be benchmarked):
+//
+//   n=        Number of rows in the columns (default 10000000).
+//   stype=    Column stypes: int32, int64, float32, float64 (default: all).
+//   op=       Operators: plus, minus, multiply, divide, eq, ne, gt, lt, ge,
+//             le (default: all).
+//   simd=     Instruction sets for the vectorized kernels (the `simd`
+//             option): none, sse4.2, avx2, avx512 (default: all). Sets not
+//             supported by the CPU fall back to the widest supported one.
+//   nth=      Number of threads; 0 means all available threads (default 1).
+//   na=       Fraction of NA values in each column, in percent (default 10).
+//   iters=    Number of times each operation is repeated (default 10).
+//   seed=     Seed for the random number generator (default 1).
+//
+// Example:
+//   ./binaryop n=1e7 stype=int64,float64 op=plus,lt simd=none,avx2 nth=1
+//
+//------------------------------------------------------------------------------
+#include <chrono>     // std::chrono
+#include <cstdio>     // std::printf
+#include <random>     // std::mt19937_64
+#include <string>     // std::string
+#include <vector>     // std::vector
+#include "column.h"
+#include "expr/py_expr.h"
+#include "options.h"
+#include "types.h"
+#include "../utils.h"
+
+static std::mt19937_64 rng;
+
+// Opcodes should be in sync with the map in binary_expr.py
+static const struct { const char* name; int opcode; } all_ops[] = {
+  {"plus", 1}, {"minus", 2}, {"multiply", 3}, {"divide", 4},
+  {"eq", 12}, {"ne", 13}, {"gt", 14}, {"lt", 15}, {"ge", 16}, {"le", 17},
+};
+
+
+
+//------------------------------------------------------------------------------
+// Command-line helpers
+//------------------------------------------------------------------------------
+
+static std::vector<std::string> get_list_arg(int argc, char** argv,
+                                             const char* name,
+                                             const char* deflt)
+{
+  char* arg = nullptr;
+  getCmdLineArg(argc, argv, name, &arg);
+  std::string s(arg? arg : deflt);
+  std::vector<std::string> out;
+  size_t start = 0;
+  while (start <= s.size()) {
+    size_t end = s.find(',', start);
+    if (end == std::string::npos) end = s.size();
+    if (end > start) out.push_back(s.substr(start, end - start));
+    start = end + 1;
+  }
+  return out;
+}
+
+static std::vector<int64_t> get_int_list_arg(int argc, char** argv,
+                                             const char* name,
+                                             const char* deflt)
+{
+  std::vector<int64_t> out;
+  for (const std::string& s : get_list_arg(argc, argv, name, deflt)) {
+    out.push_back(static_cast<int64_t>(std::stod(s)));  // allows "1e7"
+  }
+  return out;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Data generators
+//------------------------------------------------------------------------------
+
+// Small values, so that the products do not overflow
+template <typename T> static T make_value(uint64_t r) {
+  return static_cast<T>(static_cast<int64_t>(r % 20001) - 10000);
+}
+template <> float make_value(uint64_t r) {
+  return static_cast<float>(static_cast<double>(r >> 11) * 0x1.0p-53 * 2e4 - 1e4);
+}
+template <> double make_value(uint64_t r) {
+  return static_cast<double>(r >> 11) * 0x1.0p-53 * 2e4 - 1e4;
+}
+
+
+template <typename T>
+static Column* make_fw_column(SType stype, size_t n, int na_pct) {
+  Column* col = Column::new_data_column(stype, static_cast<int64_t>(n));
+  T* data = static_cast<T*>(col->data());
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t r = rng();
+    data[i] = static_cast<int>((r >> 40) % 100) < na_pct? GETNA<T>()
+                                                          : make_value<T>(r);
+  }
+  return col;
+}
+
+
+static Column* make_column(const std::string& stype, size_t n, int na_pct) {
+  if (stype == "int32")   return make_fw_column<int32_t>(ST_INTEGER_I4, n, na_pct);
+  if (stype == "int64")   return make_fw_column<int64_t>(ST_INTEGER_I8, n, na_pct);
+  if (stype == "float32") return make_fw_column<float>(ST_REAL_F4, n, na_pct);
+  if (stype == "float64") return make_fw_column<double>(ST_REAL_F8, n, na_pct);
+  return nullptr;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Main
+//------------------------------------------------------------------------------
+
+static double time_binaryop(int opcode, Column* lhs, Column* rhs, int iters) {
+  double best = 0;
+  for (int i = 0; i < iters; ++i) {
+    auto t0 = std::chrono::steady_clock::now();
+    Column* res = expr::binaryop(opcode, lhs, rhs);
+    auto t1 = std::chrono::steady_clock::now();
+    delete res;
+    double t = std::chrono::duration<double>(t1 - t0).count();
+    if (i == 0 || t < best) best = t;
+  }
+  return best;
+}
+
+
+int main(int argc, char** argv) {
+  auto ns     = get_int_list_arg(argc, argv, "n", "10000000");
+  auto stypes = get_list_arg(argc, argv, "stype", "int32,int64,float32,float64");
+  auto ops    = get_list_arg(argc, argv, "op", "plus,minus,multiply,divide,"
+                                               "eq,ne,gt,lt,ge,le");
+  auto simds  = get_list_arg(argc, argv, "simd", "sse4.2,avx2,avx512");
+  auto nths   = get_int_list_arg(argc, argv, "nth", "1");
+  int na_pct  = getCmdArgInt(argc, argv, "na", 10);
+  int iters   = getCmdArgInt(argc, argv, "iters", 10);
+  int seed    = getCmdArgInt(argc, argv, "seed", 1);
+  if (iters < 1) iters = 1;
+  // The scalar kernels are the baseline for the speedups
+  simds.insert(simds.begin(), "none");
+
+  init_types();
+
+  std::printf("%-8s %-9s %10s %4s %-7s %12s %10s %8s\n",
+              "stype", "op", "n", "nth", "simd", "time(ms)", "Mrows/s",
+              "speedup");
+  for (int64_t n : ns) {
+    for (const std::string& stype : stypes) {
+      rng.seed(static_cast<uint64_t>(seed));
+      Column* lhs = make_column(stype, static_cast<size_t>(n), na_pct);
+      Column* rhs = make_column(stype, static_cast<size_t>(n), na_pct);
+      if (!lhs || !rhs) continue;
+      for (const std::string& opname : ops) {
+        int opcode = 0;
+        for (const auto& op : all_ops) {
+          if (opname == op.name) opcode = op.opcode;
+        }
+        if (!opcode) continue;
+        for (int64_t nth : nths) {
+          config::set_nthreads(static_cast<int32_t>(nth));
+          double t_scalar = 0;
+          for (const std::string& simd : simds) {
+            if (simd == "none" && &simd != &simds[0]) continue;
+            config::set_simd(simd);
+            double t = time_binaryop(opcode, lhs, rhs, iters);
+            if (simd == "none") t_scalar = t;
+            std::printf("%-8s %-9s %10lld %4d %-7s %12.3f %10.1f %7.2fx\n",
+                        stype.c_str(), opname.c_str(),
+                        static_cast<long long>(n), config::nthreads,
+                        simd.c_str(), t * 1000,
+                        static_cast<double>(n) / t / 1e6, t_scalar / t);
+            std::fflush(stdout);
+          }
+        }
+      }
+      delete lhs;
+      delete rhs;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,361 @@
+//------------------------------------------------------------------------------
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// © H2O.ai 2018
+//------------------------------------------------------------------------------
+// Benchmark of `Column::sort()` on generated data.
+//
+// Unlike the experiments in `microbench/sort`, this program links against the
+// actual datatable core, so that it measures exactly the code that is run
+// when a Frame is sorted from Python. For each combination of the parameters
+// below, a column is generated, and then sorted `iters` times (each time via
+// a fresh shallow copy, so that the ordering cached in the column's Stats is
+// not reused). The best time is reported, together with the throughput in
+// millions of rows per second and MB of column data per second.
+//
+// Parameters (each one may be given as a comma-separated list of values,
+// and all combinations of these values will be benchmarked):
+//
+//   n=        Number of rows in the column (default 1000000).
+//   stype=    Column stypes: bool, int8, int16, int32, int64, float32,
+//             float64, str32, str64 (default: all).
+//   dist=     Data distributions (default: all):
+//               uniform  - random values over the whole range of the type;
+//                          for strings: random lowercase strings of length
+//                          0 to 16;
+//               zipf     - values drawn from the Zipf distribution (s = 1.1)
+//                          with `n` distinct values;
+//               sorted   - same as `uniform`, sorted in ascending order;
+//               reverse  - same as `uniform`, sorted in descending order;
+//               fewuniq  - only 16 distinct values;
+//               allna    - all values are NAs;
+//               prefix   - (strings only) URLs sharing a long common prefix.
+//   nth=      Number of threads for sorting (`config::sort_nthreads`);
+//             0 means all available threads (default 0).
+//   bits=     Values of `config::sort_max_radix_bits` (default 8,12,16).
+//   insert=   Values of `config::sort_insert_method_threshold` (default 64).
+//   iters=    Number of times each sort is repeated (default 5).
+//   seed=     Seed for the random number generator (default 1).
+//
+// Example:
+//   ./colsort n=100000,10000000 stype=int32,str32 dist=uniform,zipf nth=1,4
+//
+//------------------------------------------------------------------------------
+#include <algorithm>  // std::sort, std::upper_bound
+#include <chrono>     // std::chrono
+#include <cmath>      // std::pow
+#include <cstdio>     // std::printf
+#include <cstring>    // std::memcpy
+#include <exception>  // std::exception
+#include <random>     // std::mt19937_64
+#include <string>     // std::string
+#include <vector>     // std::vector
+#include "column.h"
+#include "memorybuf.h"
+#include "options.h"
+#include "rowindex.h"
+#include "stats.h"
+#include "types.h"
+#include "../utils.h"
+
+static std::mt19937_64 rng;
+
+static const char* all_stypes = "bool,int8,int16,int32,int64,float32,float64,"
+                                "str32,str64";
+static const char* all_dists = "uniform,zipf,sorted,reverse,fewuniq,allna,"
+                               "prefix";
+
+
+
+//------------------------------------------------------------------------------
+// Command-line helpers
+//------------------------------------------------------------------------------
+
+static std::vector<std::string> get_list_arg(int argc, char** argv,
+                                             const char* name,
+                                             const char* deflt)
+{
+  char* arg = nullptr;
+  getCmdLineArg(argc, argv, name, &arg);
+  std::string s(arg? arg : deflt);
+  std::vector<std::string> out;
+  size_t start = 0;
+  while (start <= s.size()) {
+    size_t end = s.find(',', start);
+    if (end == std::string::npos) end = s.size();
+    if (end > start) out.push_back(s.substr(start, end - start));
+    start = end + 1;
+  }
+  return out;
+}
+
+static std::vector<int64_t> get_int_list_arg(int argc, char** argv,
+                                             const char* name,
+                                             const char* deflt)
+{
+  std::vector<int64_t> out;
+  for (const std::string& s : get_list_arg(argc, argv, name, deflt)) {
+    out.push_back(static_cast<int64_t>(std::stod(s)));  // allows "1e6"
+  }
+  return out;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Data generators
+//------------------------------------------------------------------------------
+
+/**
+ * Sampler of ranks `0 .. k-1` from the Zipf distribution with exponent `s`.
+ */
+class ZipfSampler {
+  std::vector<double> cdf;
+
+  public:
+    ZipfSampler(size_t k, double s) : cdf(k) {
+      double sum = 0;
+      for (size_t i = 0; i < k; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), s);
+        cdf[i] = sum;
+      }
+      for (size_t i = 0; i < k; ++i) cdf[i] /= sum;
+    }
+
+    size_t operator()() {
+      double u = std::uniform_real_distribution<double>(0, 1)(rng);
+      auto it = std::upper_bound(cdf.begin(), cdf.end(), u);
+      return std::min(static_cast<size_t>(it - cdf.begin()), cdf.size() - 1);
+    }
+};
+
+// Scatter the Zipf ranks over the range of values, so that the most frequent
+// values are not simply the smallest ones.
+static uint64_t scramble(uint64_t x) {
+  x ^= x >> 31;
+  x *= 0x7FB5D329728EA185ULL;
+  x ^= x >> 27;
+  return x;
+}
+
+
+/**
+ * Map random bits `r` into a valid (non-NA) value of type `T`.
+ */
+template <typename T> static T make_value(uint64_t r) {
+  T v = static_cast<T>(r);
+  return ISNA<T>(v)? T(0) : v;
+}
+template <> float make_value(uint64_t r) {
+  return static_cast<float>(static_cast<double>(r >> 11) * 0x1.0p-53 * 2e6 - 1e6);
+}
+template <> double make_value(uint64_t r) {
+  return static_cast<double>(r >> 11) * 0x1.0p-53 * 2e6 - 1e6;
+}
+
+
+template <typename T>
+static Column* make_fw_column(SType stype, const std::string& dist, size_t n,
+                              bool isbool)
+{
+  auto value = [isbool](uint64_t r) -> T {
+    return isbool? static_cast<T>(r & 1) : make_value<T>(r);
+  };
+  Column* col = Column::new_data_column(stype, static_cast<int64_t>(n));
+  T* data = static_cast<T*>(col->data());
+  if (dist == "uniform" || dist == "sorted" || dist == "reverse") {
+    for (size_t i = 0; i < n; ++i) data[i] = value(rng());
+    if (dist == "sorted") std::sort(data, data + n);
+    if (dist == "reverse") std::sort(data, data + n, [](T a, T b) { return a > b; });
+  }
+  else if (dist == "zipf") {
+    ZipfSampler zipf(n, 1.1);
+    for (size_t i = 0; i < n; ++i) data[i] = value(scramble(zipf()));
+  }
+  else if (dist == "fewuniq") {
+    T uniq[16];
+    for (size_t i = 0; i < 16; ++i) uniq[i] = value(rng());
+    for (size_t i = 0; i < n; ++i) data[i] = uniq[rng() & 15];
+  }
+  else if (dist == "allna") {
+    for (size_t i = 0; i < n; ++i) data[i] = GETNA<T>();
+  }
+  else {
+    delete col;
+    return nullptr;
+  }
+  return col;
+}
+
+
+static std::string random_string(size_t minlen, size_t maxlen) {
+  size_t len = minlen + rng() % (maxlen - minlen + 1);
+  std::string s(len, 'a');
+  for (size_t i = 0; i < len; ++i) s[i] = static_cast<char>('a' + rng() % 26);
+  return s;
+}
+
+
+template <typename T>
+static Column* make_str_column(SType stype, const std::string& dist, size_t n)
+{
+  std::vector<std::string> strs(n);
+  bool allna = false;
+  if (dist == "uniform" || dist == "sorted" || dist == "reverse") {
+    for (size_t i = 0; i < n; ++i) strs[i] = random_string(0, 16);
+    if (dist == "sorted") std::sort(strs.begin(), strs.end());
+    if (dist == "reverse") std::sort(strs.rbegin(), strs.rend());
+  }
+  else if (dist == "zipf") {
+    ZipfSampler zipf(n, 1.1);
+    for (size_t i = 0; i < n; ++i) {
+      strs[i] = "w" + std::to_string(scramble(zipf()) % 1000000007);
+    }
+  }
+  else if (dist == "fewuniq") {
+    std::string uniq[16];
+    for (size_t i = 0; i < 16; ++i) uniq[i] = random_string(1, 16);
+    for (size_t i = 0; i < n; ++i) strs[i] = uniq[rng() & 15];
+  }
+  else if (dist == "allna") {
+    allna = true;
+  }
+  else if (dist == "prefix") {
+    for (size_t i = 0; i < n; ++i) {
+      strs[i] = "https://www.example.com/products/datatable/docs/" +
+                random_string(4, 12);
+    }
+  }
+  else {
+    return nullptr;
+  }
+
+  size_t strsize = 0;
+  for (const std::string& s : strs) strsize += s.size();
+  MemoryBuffer* mbuf = new MemoryMemBuf((n + 1) * sizeof(T));
+  MemoryBuffer* strbuf = new MemoryMemBuf(strsize);
+  T* offs = static_cast<T*>(mbuf->get());
+  char* chars = static_cast<char*>(strbuf->get());
+  T off = 1;
+  offs[0] = -1;
+  for (size_t i = 0; i < n; ++i) {
+    if (allna) {
+      offs[i + 1] = -off;
+    } else {
+      std::memcpy(chars + off - 1, strs[i].data(), strs[i].size());
+      off += static_cast<T>(strs[i].size());
+      offs[i + 1] = off;
+    }
+  }
+  return Column::new_mbuf_column(stype, mbuf, strbuf);
+}
+
+
+static Column* make_column(const std::string& stype, const std::string& dist,
+                           size_t n)
+{
+  if (stype == "bool")    return make_fw_column<int8_t>(ST_BOOLEAN_I1, dist, n, true);
+  if (stype == "int8")    return make_fw_column<int8_t>(ST_INTEGER_I1, dist, n, false);
+  if (stype == "int16")   return make_fw_column<int16_t>(ST_INTEGER_I2, dist, n, false);
+  if (stype == "int32")   return make_fw_column<int32_t>(ST_INTEGER_I4, dist, n, false);
+  if (stype == "int64")   return make_fw_column<int64_t>(ST_INTEGER_I8, dist, n, false);
+  if (stype == "float32") return make_fw_column<float>(ST_REAL_F4, dist, n, false);
+  if (stype == "float64") return make_fw_column<double>(ST_REAL_F8, dist, n, false);
+  if (stype == "str32")   return make_str_column<int32_t>(ST_STRING_I4_VCHAR, dist, n);
+  if (stype == "str64")   return make_str_column<int64_t>(ST_STRING_I8_VCHAR, dist, n);
+  return nullptr;
+}
+
+
+// Size of the column's data, including the string buffer for string columns
+static size_t column_bytes(const Column* col) {
+  size_t size = col->alloc_size();
+  switch (col->stype()) {
+    case ST_STRING_I4_VCHAR:
+      return size + static_cast<const StringColumn<int32_t>*>(col)->datasize();
+    case ST_STRING_I8_VCHAR:
+      return size + static_cast<const StringColumn<int64_t>*>(col)->datasize();
+    default:
+      return size;
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+// Main
+//------------------------------------------------------------------------------
+
+static double time_sort(const Column* col, int iters) {
+  double best = 0;
+  for (int i = 0; i < iters; ++i) {
+    // The shallow copy shares the data but not the Stats of `col`, so that
+    // neither the ordering nor the stats from the previous run are reused.
+    Column* copy = col->shallowcopy();
+    auto t0 = std::chrono::steady_clock::now();
+    RowIndex ri = copy->sort(false);
+    auto t1 = std::chrono::steady_clock::now();
+    delete copy;
+    double t = std::chrono::duration<double>(t1 - t0).count();
+    if (i == 0 || t < best) best = t;
+  }
+  return best;
+}
+
+
+int main(int argc, char** argv) {
+  auto ns      = get_int_list_arg(argc, argv, "n", "1000000");
+  auto stypes  = get_list_arg(argc, argv, "stype", all_stypes);
+  auto dists   = get_list_arg(argc, argv, "dist", all_dists);
+  auto nths    = get_int_list_arg(argc, argv, "nth", "0");
+  auto bitss   = get_int_list_arg(argc, argv, "bits", "8,12,16");
+  auto inserts = get_int_list_arg(argc, argv, "insert", "64");
+  int iters    = getCmdArgInt(argc, argv, "iters", 5);
+  int seed     = getCmdArgInt(argc, argv, "seed", 1);
+  if (iters < 1) iters = 1;
+
+  init_types();
+  // Same defaults as set from datatable/frame.py
+  config::set_sort_over_radix_bits(8);
+  config::set_sort_max_chunk_length(1024);
+
+  std::printf("%-8s %-8s %10s %4s %5s %7s %12s %10s %10s\n",
+              "stype", "dist", "n", "nth", "bits", "insert",
+              "time(ms)", "Mrows/s", "MB/s");
+  for (int64_t n : ns) {
+    for (const std::string& stype : stypes) {
+      for (const std::string& dist : dists) {
+        rng.seed(static_cast<uint64_t>(seed));
+        Column* col = make_column(stype, dist, static_cast<size_t>(n));
+        if (!col) continue;  // e.g. "prefix" distribution for numeric stypes
+        double mb = static_cast<double>(column_bytes(col)) / (1 << 20);
+        for (int64_t nth : nths) {
+          config::set_sort_nthreads(static_cast<int32_t>(nth));
+          for (int64_t bits : bitss) {
+            config::set_sort_max_radix_bits(bits);
+            for (int64_t insert : inserts) {
+              config::set_sort_insert_method_threshold(insert);
+              try {
+                double t = time_sort(col, iters);
+                std::printf("%-8s %-8s %10lld %4d %5d %7lld %12.3f %10.2f %10.1f\n",
+                            stype.c_str(), dist.c_str(),
+                            static_cast<long long>(n), config::sort_nthreads,
+                            static_cast<int>(bits),
+                            static_cast<long long>(insert),
+                            t * 1000, static_cast<double>(n) / t / 1e6, mb / t);
+              } catch (const std::exception& e) {
+                std::printf("%-8s %-8s %10lld: error %s\n", stype.c_str(),
+                            dist.c_str(), static_cast<long long>(n), e.what());
+              }
+              std::fflush(stdout);
+            }
+          }
+        }
+        delete col;
+      }
+    }
+  }
+  return 0;
+}
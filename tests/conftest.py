@@ -51,6 +51,30 @@ def numpy():
         pytest.skip("Numpy module is required for this test")
 
 
+@pytest.fixture(params=[False, True], ids=["int32", "int64"])
+def sort_int64(request):
+    """
+    Run the test twice: with the default sorting, and with the 64-bit row
+    indices and group offsets forced even for small frames.
+    """
+    import datatable as dt
+    dt.options.sort.force_int64 = request.param
+    yield request.param
+    del dt.options.sort.force_int64
+
+
+@pytest.fixture(scope="session")
+def llvm():
+    """
+    This fixture returns the LLVM compiler used by the "llvm" evaluation
+    engine, or if unavailable marks test as skipped.
+    """
+    from datatable.graph.llvm import llvm
+    if not llvm.available:
+        pytest.skip("LLVM execution engine is required for this test")
+    return llvm
+
+
 @pytest.fixture(scope="session")
 def h2o():
     """
@@ -671,6 +671,25 @@ def test_chained_array(dt0):
     assert as_list(dt4) == [[1, 1, 1], [-11, -11, 9], [1, 1, 1.3]]
 
 
+def test_filter_large():
+    # Several chunks of rows, filtered in parallel
+    n = 200000
+    src = [None if i % 7 == 0 else i % 1000 for i in range(n)]
+    df0 = dt.Frame({"A": src})
+    df1 = df0[f.A * 2 > 1500, :]
+    assert df1.internal.check()
+    assert df1.topython() == [[x for x in src if x is not None and x > 750]]
+    df2 = df0[::-3, :]
+    df3 = df2[f.A < 10, :]
+    assert df3.internal.check()
+    assert df3.topython() == [[x for x in src[::-3]
+                               if x is not None and x < 10]]
+    del df2[f.A < 990, :]
+    assert df2.internal.check()
+    assert df2.topython() == [[x for x in src[::-3]
+                               if x is None or x >= 990]]
+
+
 
 #-------------------------------------------------------------------------------
 # Others
@@ -717,3 +717,29 @@ def test_issue898():
     f1.materialize()
     res = f1.topython()
     del res
+
+
+@pytest.mark.run(order=34)
+@pytest.mark.parametrize("sel", ["slice", "negslice", "array"])
+def test_materialize_large_view(sel):
+    # Large enough to be gathered in several chunks in parallel
+    n = 20000
+    src = [[None if i % 11 == 0 else i * 7 % 1000 for i in range(n)],
+           [None if i % 13 == 0 else "s" * (i % 5) for i in range(n)],
+           [None if i % 17 == 0 else i / 8 for i in range(n)]]
+    f0 = dt.Frame(src, stypes=[stype.int32, stype.str32, stype.float64])
+    f0.cbind(dt.Frame(src[1], stype=stype.str64))
+    src.append(src[1])
+    if sel == "slice":
+        rows = list(range(5, n, 3))
+        f1 = f0[5::3, :]
+    elif sel == "negslice":
+        rows = list(range(n - 1, -1, -2))
+        f1 = f0[::-2, :]
+    else:
+        rows = [(i * 7919) % n for i in range(n + 100)]
+        f1 = f0[rows, :]
+    f1.materialize()
+    assert f1.internal.isview is False
+    assert f1.internal.check()
+    assert f1.topython() == [[col[i] for i in rows] for col in src]
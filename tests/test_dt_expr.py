@@ -132,6 +132,75 @@ def test_dt_isna(src):
 
 
 
+#-------------------------------------------------------------------------------
+# isin()
+#-------------------------------------------------------------------------------
+
+@pytest.mark.parametrize("src", dt_bool | dt_int | dt_float | dt_str)
+def test_dt_isin(src):
+    values = list(src[::2])
+    dt0 = dt.Frame(src)
+    dt1 = dt0[:, dt.isin(f[0], values)]
+    assert dt1.internal.check()
+    assert dt1.stypes == (stype.bool8,)
+    assert dt1.topython()[0] == [x in values for x in src]
+
+
+@pytest.mark.parametrize("values", [range(1000), range(-10**12, 10**12, 10**9),
+                                    [0.5, 3.0, 17, -0.0]])
+def test_dt_isin_large(values):
+    n = 50021
+    a = [None if i % 101 == 0 else (i * 7919) % 4001 - 1000 for i in range(n)]
+    dt0 = dt.Frame(a)
+    dt1 = dt0[:, dt.isin(f[0], values)]
+    assert dt1.internal.check()
+    vset = set(values)
+    assert dt1.topython()[0] == [x in vset for x in a]
+
+
+def test_dt_isin_frame():
+    dt0 = dt.Frame({"A": ["a", "bc", None, "", "d", "bc", "x"],
+                    "B": [1, 2, 3, 4, 5, 6, 7]})
+    dt1 = dt.Frame(["x", "bc", "zz", "a"])[1:3, :]
+    dt2 = dt0[dt.isin(f.A, dt1), :]
+    assert dt2.internal.check()
+    assert dt2.topython() == [["bc", "bc"], [2, 6]]
+    dt3 = dt0[:, dt.isin(f.B, [None, 2.0, 7])]
+    assert dt3.topython() == [[False, True, False, False, False, False, True]]
+
+
+@pytest.mark.parametrize("src", [[1, None, 3], [0.5, None], ["a", None, ""],
+                                 [True, False, None]])
+def test_dt_isin_empty(src):
+    dt0 = dt.Frame(src)
+    dt1 = dt0[:, dt.isin(f[0], [])]
+    assert dt1.internal.check()
+    assert dt1.stypes == (stype.bool8,)
+    assert dt1.topython() == [[False] * len(src)]
+    assert dt0[:, dt.isin(f[0], set())].topython() == [[False] * len(src)]
+
+
+def test_dt_isin_large_int64():
+    # Integers above 2**53 must not be rounded into doubles when compared with
+    # the real values, or with the elements of a real column
+    big = 2**60
+    dt0 = dt.Frame([big, big + 1, 3, None])
+    dt1 = dt0[:, [dt.isin(f[0], [float(big), 3.5]),
+                  dt.isin(f[0], [float(big) + 2**8, 3.0])]]
+    assert dt1.topython() == [[True, False, False, False],
+                              [False, False, True, False]]
+    dt2 = dt.Frame([float(big), 3.0, 0.5])
+    dt3 = dt2[:, dt.isin(f[0], [big + 1, 3])]
+    assert dt3.topython() == [[False, True, False]]
+
+
+def test_dt_isin_invalid():
+    dt0 = dt.Frame(["a", "b"])
+    with pytest.raises(TypeError):
+        dt0[:, dt.isin(f[0], [1, 2])]
+
+
+
 #-------------------------------------------------------------------------------
 # type-cast
 #-------------------------------------------------------------------------------
@@ -144,3 +213,283 @@ def test_cast_to_float32(src):
     assert dt1.stypes == (dt.float32,) * dt0.ncols
     pyans = [float(x) if x is not None else None for x in src]
     assert list_equals(dt1.topython()[0], pyans)
+
+
+@pytest.mark.parametrize("st", [stype.str32, stype.str64])
+def test_cast_to_str(st):
+    n = 10007
+    a = [None if i % 11 == 0 else i * 7919 - 50000000 for i in range(n)]
+    b = [None if i % 13 == 0 else i % 3 == 0 for i in range(n)]
+    c = [None if i % 17 == 0 else i / 16 - 100 for i in range(n)]
+    dt0 = dt.Frame({"A": a, "B": b, "C": c})
+    dt1 = dt0[:, [dt.__dict__[st.name](f[i]) for i in range(3)]]
+    assert dt1.internal.check()
+    assert dt1.stypes == (st,) * 3
+    r0, r1, r2 = dt1.topython()
+    assert r0 == [None if x is None else str(x) for x in a]
+    assert r1 == [None if x is None else str(x) for x in b]
+    assert [None if x is None else float(x) for x in r2] == c
+
+
+def test_cast_from_str():
+    src = ["12", "-7", None, "abc", "", "1e3", "True", "300", " 5", "0",
+           "1.5", "false", "9999999999", "-inf"]
+    dt0 = dt.Frame(src)
+    dt1 = dt0[:, [dt.bool8(f[0]), dt.int8(f[0]), dt.int16(f[0]),
+                  dt.int32(f[0]), dt.int64(f[0]), dt.float64(f[0])]]
+    assert dt1.internal.check()
+    assert dt1.stypes == (stype.bool8, stype.int8, stype.int16, stype.int32,
+                          stype.int64, stype.float64)
+    r0, r1, r2, r3, r4, r5 = dt1.topython()
+    assert r0 == [None] * 6 + [True] + [None] * 2 + [False, None, False,
+                                                      None, None]
+    assert r1 == [12, -7] + [None] * 7 + [0] + [None] * 4
+    assert r2 == [12, -7] + [None] * 5 + [300, None, 0] + [None] * 4
+    assert r3 == r2
+    assert r4 == r2[:12] + [9999999999, None]
+    assert r5 == [12.0, -7.0, None, None, None, 1000.0, None, 300.0, None,
+                  0.0, 1.5, None, 9999999999.0, float("-inf")]
+    # Numbers that cannot be parsed by fread's own float parser
+    dt2 = dt.Frame(["1234567890123456789", "18446744073709551616", "1e-400",
+                    "1e400", "-1e400", "1e400x"])
+    dt3 = dt2[:, [dt.float64(f[0]), dt.float32(f[0])]]
+    assert dt3.internal.check()
+    assert dt3.topython()[0] == [1.2345678901234568e18, 1.8446744073709552e19,
+                                 0.0, float("inf"), float("-inf"), None]
+    assert dt3.topython()[1][2:] == [0.0, float("inf"), float("-inf"), None]
+
+
+def test_cast_from_str_not_decimal():
+    # Strings that `strtod()` would accept, but fread's parser would not
+    src = ["0x10", "-0x1p3", " 1234567890123456789", "1234567890123456789 ",
+           "infinity", "1e", "."]
+    dt0 = dt.Frame(src)
+    dt1 = dt0[:, [dt.float64(f[0]), dt.int64(f[0])]]
+    assert dt1.internal.check()
+    assert dt1.topython() == [[None] * len(src), [None] * len(src)]
+
+
+def test_cast_from_str_comma_locale():
+    import locale
+    old = locale.setlocale(locale.LC_NUMERIC)
+    for loc in ["de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "ru_RU.UTF-8"]:
+        try:
+            locale.setlocale(locale.LC_NUMERIC, loc)
+            break
+        except locale.Error:
+            pass
+    else:
+        pytest.skip("No locale with a comma decimal point")
+    try:
+        dt0 = dt.Frame(["1.2345678901234567890123", "1,5", "2.5"])
+        dt1 = dt0[:, dt.float64(f[0])]
+    finally:
+        locale.setlocale(locale.LC_NUMERIC, old)
+    assert dt1.topython() == [[1.2345678901234568, None, 2.5]]
+
+
+def test_cast_str_roundtrip():
+    n = 20011
+    a = [None if i % 7 == 0 else (i * 104729) % 200003 - 100000
+         for i in range(n)]
+    dt0 = dt.Frame(a)
+    dt1 = dt0[:, dt.str32(f[0])][:, dt.int32(f[0])]
+    assert dt1.internal.check()
+    assert dt1.topython() == [a]
+
+
+
+#-------------------------------------------------------------------------------
+# Large columns (processed in parallel chunks)
+#-------------------------------------------------------------------------------
+
+def test_dt_ops_large():
+    n = 100003
+    a = [i % 1000 - 500 for i in range(n)]
+    b = [None if i % 7 == 0 else i * 0.5 for i in range(n)]
+    c = [i for i in range(n)]
+    dt0 = dt.Frame({"A": a, "B": b, "C": c})
+    dt1 = dt0[:, [f.A * f.B + f.C, f.A > f.C - 50000, -f.A, dt.isna(f.B),
+                  f.A + 1]]
+    assert dt1.internal.check()
+    assert dt1.nrows == n
+    r0, r1, r2, r3, r4 = dt1.topython()
+    assert list_equals(r0, [None if y is None else x * y + z
+                            for x, y, z in zip(a, b, c)])
+    assert r1 == [x > z - 50000 for x, z in zip(a, c)]
+    assert r2 == [-x for x in a]
+    assert r3 == [y is None for y in b]
+    assert r4 == [x + 1 for x in a]
+
+
+@pytest.mark.parametrize("st", [stype.int32, stype.int64, stype.float32,
+                                stype.float64])
+def test_dt_ops_simd(st):
+    # Vectorized kernels must produce exactly the same results as the scalar
+    # ones, including the NAs and the rows in the tail of each chunk
+    n = 20011
+    a = [None if i % 11 == 0 else (i * 7919) % 2001 - 1000 for i in range(n)]
+    b = [None if i % 13 == 0 else (i * 104729) % 41 - 20 for i in range(n)]
+    dt0 = dt.Frame({"A": a, "B": b})
+    dt0 = dt0[:, [dt.__dict__[st.name](f.A), dt.__dict__[st.name](f.B)]]
+    assert dt0.stypes == (st, st)
+    exprs = [f[0] + f[1], f[0] - f[1], f[0] * f[1], f[0] / f[1],
+             f[0] == f[1], f[0] != f[1], f[0] > f[1], f[0] < f[1],
+             f[0] >= f[1], f[0] <= f[1]]
+    res = {}
+    try:
+        for level in ["none", "sse4.2", "avx2", "avx512"]:
+            dt.options.simd = level
+            dt1 = dt0[:, exprs]
+            assert dt1.internal.check()
+            res[level] = (dt1.stypes, dt1.topython())
+    finally:
+        dt.options.simd = "auto"
+    for level in ["sse4.2", "avx2", "avx512"]:
+        assert res[level] == res["none"]
+
+
+
+#-------------------------------------------------------------------------------
+# Fused evaluation of operator trees
+#-------------------------------------------------------------------------------
+
+def test_dt_fused_expr():
+    n = 10007
+    a = [None if i % 9 == 0 else i % 100 - 50 for i in range(n)]
+    b = [None if i % 4 == 0 else i * 0.25 for i in range(n)]
+    dt0 = dt.Frame({"A": a, "B": b})
+    dt1 = dt0[:, [(f.A * 2 + f.B - 3) * f.A > f.B,
+                  (1 + 2) * f.B - f.A / 4,
+                  dt.isna(f.A * f.B) == dt.isna(f.B),
+                  -(-f.A + 1)]]
+    assert dt1.internal.check()
+    assert dt1.stypes == (stype.bool8, stype.float64, stype.bool8, stype.int8)
+    r0, r1, r2, r3 = dt1.topython()
+    assert r0 == [x is not None and y is not None and (x * 2 + y - 3) * x > y
+                  for x, y in zip(a, b)]
+    assert list_equals(r1, [None if x is None or y is None else 3 * y - x / 4
+                            for x, y in zip(a, b)])
+    assert r2 == [(y is None) or (x is not None) for x, y in zip(a, b)]
+    assert r3 == [None if x is None else x - 1 for x in a]
+
+
+def test_dt_fused_expr_strings():
+    dt0 = dt.Frame({"A": ["a", None, "ccc", None, ""], "B": [1, 2, 3, 4, 5]})
+    dt1 = dt0[:, dt.isna(f.A) == (f.B > 2)]
+    assert dt1.internal.check()
+    assert dt1.topython() == [[True, False, False, True, False]]
+
+
+def test_dt_fused_expr_empty():
+    dt0 = dt.Frame({"A": [1, 2, 3], "B": [0.5, 1.5, 2.5]})[:0, :]
+    dt1 = dt0[:, (f.A + 1) * f.B]
+    assert dt1.internal.check()
+    assert dt1.shape == (0, 1)
+
+
+
+#-------------------------------------------------------------------------------
+# Expressions over views (columns are read through their RowIndex)
+#-------------------------------------------------------------------------------
+
+@pytest.mark.parametrize("rows", [slice(None, None, -3), slice(5, 90, 2),
+                                  [7, 3, 3, 99, 0, 50, 1]])
+def test_dt_expr_on_view(rows):
+    a = [None if i % 11 == 0 else i * 3 - 100 for i in range(100)]
+    b = [None if i % 7 == 0 else i / 8 for i in range(100)]
+    dt0 = dt.Frame({"A": a, "B": b})
+    dt1 = dt0[rows, :]
+    assert dt1.internal.isview
+    a1, b1 = dt1.topython()
+    dt2 = dt1[:, [f.A * f.B - f.B, f.B > 5, dt.isna(f.A)]]
+    assert dt2.internal.check()
+    r0, r1, r2 = dt2.topython()
+    assert list_equals(r0, [None if x is None or y is None else x * y - y
+                            for x, y in zip(a1, b1)])
+    assert r1 == [y is not None and y > 5 for y in b1]
+    assert r2 == [x is None for x in a1]
+    dt3 = dt1[:, [dt.sum(f.A), dt.min(f.B), dt.mean(f.A), dt.median(f.B)]]
+    assert dt3.internal.check()
+    nona = [x for x in a1 if x is not None]
+    assert dt3.topython()[:3] == [[sum(nona)],
+                                  [min(y for y in b1 if y is not None)],
+                                  [sum(nona) / len(nona)]]
+
+
+def test_dt_expr_on_view_late_column():
+    # Column C is first used after the register of (A + B) has been released
+    dt0 = dt.Frame({"A": [1, 2, 3, 4, 5, 6], "B": [10, 20, 30, 40, 50, 60],
+                    "C": [100, 200, 300, 400, 500, 600]})[::2, :]
+    dt1 = dt0[:, (f.A + f.B) * 2 + f.C]
+    assert dt1.internal.check()
+    assert dt1.topython() == [[122, 366, 610]]
+    dt2 = dt0[(f.A + f.B) * 2 + f.C > 300, :]
+    assert dt2.internal.check()
+    assert dt2.topython() == [[3, 5], [30, 50], [300, 500]]
+
+
+def test_dt_reduce_on_view_grouped():
+    dt0 = dt.Frame({"A": [1, 2, 1, 2, 1, 3, 2, 3],
+                    "B": [5, None, 3, 8, 1, 4, 0, 6]})
+    dt1 = dt0[::-1, :]
+    dt2 = dt1(select=[dt.sum(f.B), dt.first(f.B), dt.count(f.B + 1)],
+              groupby="A")
+    assert dt2.internal.check()
+    assert dt2.topython() == [[1, 2, 3], [9, 8, 10], [1, 0, 6], [3, 2, 2]]
+
+
+
+#-------------------------------------------------------------------------------
+# Caching of the kernels compiled by the LLVM engine
+#-------------------------------------------------------------------------------
+
+def test_dt_llvm_kernel_cache(llvm):
+    dt0 = dt.Frame({"A": [1, 2, 3, None], "B": [0.5, 1.5, None, 2.5]})
+    dt1 = dt.Frame({"A": [7, None, 5], "B": [1.0, 2.0, 3.0]})
+    res0 = dt0(select=lambda f: f.A * 2 + f.B, engine="llvm")
+    ncached = llvm.ncached
+    res1 = dt1(select=lambda f: f.A * 2 + f.B, engine="llvm")
+    assert llvm.ncached == ncached
+    assert res0.topython() == [[2.5, 5.5, None, None]]
+    assert res1.topython() == [[15.0, None, 13.0]]
+
+
+def test_dt_llvm_kernel_cache_frame_names(llvm):
+    # Names of the columns that look like the names of frame variables in the
+    # generated code are not confused with them
+    dt0 = dt.Frame({"dt1": [1, 2, 3], "f0": [4, 5, 6]})
+    dt1 = dt.Frame({"dt1": [7, 8], "f0": [9, 10]})
+    res0 = dt0(select=lambda f: f.dt1 * 10 + f.f0, engine="llvm")
+    ncached = llvm.ncached
+    res1 = dt1(select=lambda f: f.dt1 * 10 + f.f0, engine="llvm")
+    assert llvm.ncached == ncached
+    assert res0.topython() == [[14, 25, 36]]
+    assert res1.topython() == [[79, 90]]
+
+
+def test_dt_llvm_kernel_cache_literals(llvm):
+    # Queries that differ only in their constants share the kernel
+    dt0 = dt.Frame({"A": [1, 2, None], "B": [0.5, 1.5, 2.5]})
+    res0 = dt0(select=lambda f: f.A * 2 + f.B, engine="llvm")
+    ncached = llvm.ncached
+    res1 = dt0(select=lambda f: f.A * 3 + f.B, engine="llvm")
+    assert llvm.ncached == ncached
+    assert res0.topython() == [[2.5, 5.5, None]]
+    assert res1.topython() == [[3.5, 7.5, None]]
+
+
+def test_dt_llvm_kernel_cache_size(llvm):
+    dt0 = dt.Frame({"A": [1, 2, 3], "B": [4, 5, 6], "C": [7, 8, 9]})
+    dt.options.llvm.cache_size = 2
+    try:
+        dt0(select=lambda f: f.A + f.B, engine="llvm")
+        dt0(select=lambda f: f.B + f.C, engine="llvm")
+        dt0(select=lambda f: f.A + f.C, engine="llvm")
+        assert llvm.ncached == 2
+        # The evicted kernel is compiled again
+        res = dt0(select=lambda f: f.A + f.B, engine="llvm")
+        assert llvm.ncached == 2
+        assert res.topython() == [[5, 7, 9]]
+    finally:
+        del dt.options.llvm.cache_size
@@ -13,11 +13,15 @@ def test_options_all():
     # Update this test every time a new option is added
     assert repr(dt.options).startswith("<datatable.options.DtConfig:")
     assert set(dir(dt.options)) == {
-        "nthreads", "core_logger", "sort", "display"}
+        "nthreads", "core_logger", "simd", "sort", "display", "groupby",
+        "llvm"}
     assert set(dir(dt.options.sort)) == {
         "insert_method_threshold", "thread_multiplier", "max_chunk_length",
-        "max_radix_bits", "over_radix_bits", "nthreads"}
+        "max_radix_bits", "over_radix_bits", "nthreads", "max_merge_runs",
+        "max_memory", "force_int64"}
     assert set(dir(dt.options.display)) == {"interactive_hint"}
+    assert set(dir(dt.options.groupby)) == {"method"}
+    assert set(dir(dt.options.llvm)) == {"cache_dir", "cache_size"}
 
 
 @pytest.mark.run(order=1002)
@@ -4,6 +4,7 @@
 #   License, v. 2.0. If a copy of the MPL was not distributed with this
 #   file, You can obtain one at http://mozilla.org/MPL/2.0/.
 #-------------------------------------------------------------------------------
+import itertools
 import math
 import os
 import pytest
@@ -606,3 +607,552 @@ def test_str32_large6():
     dt1 = dt0(sort=0)
     assert dt1.internal.check()
     assert dt1.topython()[0] == sorted(words)
+
+
+def test_str64_small():
+    src = ["Welcome", "Welc", "", None, "Welc", "Welcome!", "Welcame"]
+    d0 = dt.Frame(src, stype="str64")
+    assert d0.stypes == (stype.str64, )
+    d1 = d0.sort(0)
+    assert d1.internal.check()
+    src.remove(None)
+    assert d1.topython() == [[None] + sorted(src)]
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32) for _ in range(3)])
+def test_str64_large(seed):
+    random.seed(seed)
+    src = [random.choice(["aa", "ab", "", None, "abc%d" % random.randint(0, 50)])
+           for _ in range(random.randint(100, 5000))]
+    d0 = dt.Frame(src, stype="str64")
+    assert d0.stypes == (stype.str64, )
+    ri = d0.internal.sort(0, True)
+    assert ri.ngroups == len(set(src))
+    d1 = d0(sort=0)
+    assert d1.internal.check()
+    assert d1.topython()[0] == sorted(src, key=lambda x: (x is not None, x or ""))
+
+
+@pytest.mark.parametrize("st", ["str32", "str64"])
+def test_str_long_common_prefix(st):
+    prefix = "https://www.example.com/products/"
+    src = [prefix + "item%d/details" % (i * 7919 % 1000) for i in range(1000)]
+    src += [prefix, prefix + "item", prefix[:-1], "https://www.example.org/"] * 30
+    random.shuffle(src)
+    d0 = dt.Frame(src, stype=st)
+    ri = d0.internal.sort(0, True)
+    assert ri.ngroups == len(set(src))
+    d1 = d0.sort(0)
+    assert d1.internal.check()
+    assert d1.topython() == [sorted(src)]
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32) for _ in range(2)])
+def test_str_large_wide_radix(seed):
+    # Large enough for sort.over_radix_bits to apply to the string keys
+    random.seed(seed)
+    n = 100000
+    src = [None if random.random() < 0.01 else
+           "".join(random.choice("abcd\xe9")
+                   for _ in range(random.randint(0, 12)))
+           for _ in range(n)]
+    d0 = dt.Frame(src)
+    ri = d0.internal.sort(0, True)
+    assert ri.ngroups == len(set(src))
+    srt = sorted(src, key=lambda x: (x is not None, x or ""))
+    assert d0.sort(0).topython() == [srt]
+    assert d0.sort(0, descending=True, na_position="last").topython() == \
+        [srt[srt.count(None):][::-1] + [None] * srt.count(None)]
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32) for _ in range(3)])
+def test_str_prefixes_desc(seed):
+    random.seed(seed)
+    n = random.randint(100, 5000)
+    src = [None if random.random() < 0.1 else
+           "".join(random.choice("ab") for _ in range(random.randint(0, 20)))
+           for _ in range(n)]
+    d0 = dt.Frame(src)
+    nas = [None] * src.count(None)
+    srt = sorted((x for x in src if x is not None), reverse=True)
+    assert d0.sort(0, descending=True).topython() == [nas + srt]
+    assert d0.sort(0, descending=True, na_position="last").topython() == \
+        [srt + nas]
+
+
+
+#-------------------------------------------------------------------------------
+# Sort by multiple columns
+#-------------------------------------------------------------------------------
+
+def test_sort_multi_small(sort_int64):
+    d0 = dt.Frame([[3, 1, 3, 1, 2, 3], [6, 5, 4, 3, 2, 1], list("abcdef")],
+                  names=["A", "B", "C"])
+    d1 = d0.sort(["A", "B"])
+    assert d1.internal.check()
+    assert d1.names == d0.names
+    assert d1.topython() == [[1, 1, 2, 3, 3, 3],
+                             [3, 5, 2, 1, 4, 6],
+                             list("dbefca")]
+
+
+def test_sort_multi_by_indices(sort_int64):
+    d0 = dt.Frame([[2, 1, 2, 1], ["x", "y", "a", None]])
+    d1 = d0.sort([0, 1])
+    d2 = d0(sort=[0, 1])
+    d3 = d0(sort=["C0", 1])
+    assert d1.internal.check()
+    assert d1.topython() == [[1, 1, 2, 2], [None, "y", "a", "x"]]
+    assert d2.topython() == d1.topython()
+    assert d3.topython() == d1.topython()
+
+
+def test_sort_multi_single_element_list():
+    d0 = dt.Frame([5, 3, 4])
+    assert d0.sort([0]).topython() == [[3, 4, 5]]
+    assert d0(sort=["C0"]).topython() == [[3, 4, 5]]
+
+
+def test_sort_multi_empty_list():
+    d0 = dt.Frame([5, 3, 4])
+    with pytest.raises(ValueError):
+        d0.sort([])
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32) for _ in range(5)])
+def test_sort_multi_random(seed, sort_int64):
+    random.seed(seed)
+    n = random.choice([10, 100, 1000, 20000])
+    a = [random.randint(0, 10) for _ in range(n)]
+    b = [random.choice([None, "", "a", "ab", "abc", "b", "bbbbbbb1"])
+         for _ in range(n)]
+    c = [random.random() * 100 - 50 for _ in range(n)]
+    d0 = dt.Frame([a, b, c, list(range(n))], names=["A", "B", "C", "D"])
+    d1 = d0.sort(["A", "B", "C"])
+    assert d1.internal.check()
+    exp = sorted(zip(a, b, c, range(n)),
+                 key=lambda t: (t[0], (t[1] is not None, t[1] or ""), t[2]))
+    assert d1.topython() == [list(col) for col in zip(*exp)]
+
+
+def test_sort_multi_view(sort_int64):
+    d0 = dt.Frame([[5, 1, 5, 1, 5, 1, 5, 1] * 20, list(range(160, 0, -1))])
+    d1 = d0[::3, :].sort([0, 1])
+    assert d1.internal.check()
+    src = list(zip(*d0.topython()))[::3]
+    assert d1.topython() == [list(col) for col in zip(*sorted(src))]
+
+
+def test_sort_multi_groups(sort_int64):
+    d0 = dt.Frame([[1, 2, 1, 2, 1, 2], [1, 1, 1, 2, 2, 2]])
+    ri = d0.internal.sort([0, 1], True)
+    assert ri.tolist() == [0, 2, 4, 1, 3, 5]
+    assert ri.ngroups == 4
+    assert ri.group_sizes == [2, 1, 1, 2]
+
+
+
+#-------------------------------------------------------------------------------
+# Descending order and NA position
+#-------------------------------------------------------------------------------
+
+def sorted_with_nas(src, descending=False, nalast=False):
+    nas = [x for x in src if x is None]
+    rest = sorted((x for x in src if x is not None), reverse=descending)
+    return rest + nas if nalast else nas + rest
+
+
+@pytest.mark.parametrize("st", [stype.bool8, stype.int8, stype.int16,
+                                stype.int32, stype.int64, stype.float32,
+                                stype.float64, stype.str32, stype.str64])
+def test_sort_descending_nalast(st):
+    if st == stype.bool8:
+        src = [True, None, False, False, None, True, True]
+    elif st in (stype.str32, stype.str64):
+        src = ["ab", None, "", "b", "a", "abc", None, "ab", "ba"]
+    elif st in (stype.float32, stype.float64):
+        src = [1.5, None, -2.25, math.inf, 0.0, -math.inf, None, 7.0]
+    else:
+        src = [5, None, -3, 0, 17, None, 5, 100, -100]
+    d0 = dt.Frame(src, stype=st)
+    for desc in (False, True):
+        for nalast in (False, True):
+            d1 = d0.sort(0, descending=desc,
+                         na_position="last" if nalast else "first")
+            assert d1.internal.check()
+            assert d1.topython() == [sorted_with_nas(src, desc, nalast)]
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32) for _ in range(5)])
+def test_sort_descending_random(seed):
+    random.seed(seed)
+    n = random.choice([10, 100, 1000, 20000])
+    a = [random.choice([None, random.randint(-1000, 1000)]) for _ in range(n)]
+    b = [random.choice([None, "", "a", "ab", "abc", "b", "bbbbbbb1"])
+         for _ in range(n)]
+    nalast = random.choice([True, False])
+    d0 = dt.Frame([a, b])
+    d1 = d0.sort(0, descending=True,
+                 na_position="last" if nalast else "first")
+    assert d1.topython()[0] == sorted_with_nas(a, True, nalast)
+    d2 = d0.sort(1, descending=True,
+                 na_position="last" if nalast else "first")
+    assert d2.topython()[1] == sorted_with_nas(b, True, nalast)
+
+
+def test_sort_descending_stable(sort_int64):
+    d0 = dt.Frame([[1, 2, 1, 2, 1, 2], list(range(6))])
+    d1 = d0.sort(0, descending=True)
+    assert d1.topython() == [[2, 2, 2, 1, 1, 1], [1, 3, 5, 0, 2, 4]]
+
+
+def test_sort_multi_descending(sort_int64):
+    d0 = dt.Frame([[3, 1, 3, 1, 2, 3], [6, 5, 4, 3, 2, 1], list("abcdef")],
+                  names=["A", "B", "C"])
+    d1 = d0.sort(["A", "B"], descending=[False, True])
+    assert d1.internal.check()
+    assert d1.topython() == [[1, 1, 2, 3, 3, 3],
+                             [5, 3, 2, 6, 4, 1],
+                             list("bdeacf")]
+    d2 = d0.sort(["A", "B"], descending=True)
+    assert d2.topython() == [[3, 3, 3, 2, 1, 1],
+                             [6, 4, 1, 2, 5, 3],
+                             list("acfebd")]
+
+
+def test_sort_descending_groups(sort_int64):
+    d0 = dt.Frame([1, None, 3, 1, 3, None, 2])
+    ri = d0.internal.sort([~0], True, True)
+    assert ri.tolist() == [2, 4, 6, 0, 3, 1, 5]
+    assert ri.group_sizes == [2, 1, 2, 2]
+
+
+def test_sort_bad_params():
+    d0 = dt.Frame([[5, 3, 4], [1, 2, 3]])
+    with pytest.raises(ValueError):
+        d0.sort([0, 1], descending=[True])
+    with pytest.raises(ValueError):
+        d0.sort(0, na_position="middle")
+
+
+
+#-------------------------------------------------------------------------------
+# Top-k selection
+#-------------------------------------------------------------------------------
+
+@pytest.mark.parametrize("st", [stype.bool8, stype.int8, stype.int32,
+                                stype.int64, stype.float64, stype.str32])
+def test_topk_small(st):
+    if st == stype.bool8:
+        src = [True, None, False, True, False, None, True]
+    elif st == stype.str32:
+        src = ["cat", None, "dog", "", "ca", None, "cat", "zebra", "c"]
+    else:
+        src = [5, None, -3, 0, 17, None, 5, 100, -100]
+    d0 = dt.Frame(src, stype=st)
+    for k in range(len(src) + 2):
+        d1 = d0.nsmallest(0, k)
+        d2 = d0.nlargest(0, k)
+        assert d1.internal.check()
+        assert d2.internal.check()
+        assert d1.topython() == [sorted_with_nas(src, False, True)[:k]]
+        assert d2.topython() == [sorted_with_nas(src, True, True)[:k]]
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32) for _ in range(5)])
+def test_topk_random(seed):
+    random.seed(seed)
+    n = random.choice([10, 1000, 20000, 100000])
+    a = [random.choice([None, random.randint(-10**6, 10**6)])
+         for _ in range(n)]
+    b = [random.choice([None, random.random() * 100 - 50]) for _ in range(n)]
+    c = ["".join(random.choice("abcde") for _ in range(random.randint(0, 5)))
+         for _ in range(n)]
+    k = random.randint(1, n)
+    d0 = dt.Frame([a, b, c, list(range(n))], names=["A", "B", "C", "D"])
+    for col in "ABC":
+        for desc in (False, True):
+            d1 = d0.nlargest(col, k) if desc else d0.nsmallest(col, k)
+            d2 = d0.sort(col, descending=desc, na_position="last")
+            assert d1.internal.check()
+            assert d1.topython() == [x[:k] for x in d2.topython()]
+
+
+def test_topk_stable():
+    d0 = dt.Frame([[2, 1, 2, 1, 2, 1, 0], list(range(7))])
+    assert d0.nsmallest(0, 3).topython() == [[0, 1, 1], [6, 1, 3]]
+    assert d0.nlargest(0, 4).topython() == [[2, 2, 2, 1], [0, 2, 4, 1]]
+
+
+def test_topk_view():
+    d0 = dt.Frame([list(range(20, 0, -1)), list(range(20))],
+                  names=["A", "B"])
+    d1 = d0[::3, :]
+    d2 = d1.nsmallest("A", 3)
+    assert d2.internal.check()
+    assert d2.topython() == [[2, 5, 8], [18, 15, 12]]
+
+
+def test_topk_groups(sort_int64):
+    d0 = dt.Frame([[3, None, 1, 3, 2, 1, 3, None, 2], list(range(9))])
+    d1 = d0.nsmallest(0, 5, groups=True)
+    assert d1.internal.check()
+    assert d1.topython() == [[1, 1, 2, 2, 3], [2, 5, 4, 8, 0]]
+    assert d1.internal.rowindex.group_sizes == [2, 2, 1]
+    d2 = d0.nlargest(0, 8, groups=True)
+    assert d2.topython() == [[3, 3, 3, 2, 2, 1, 1, None],
+                             [0, 3, 6, 4, 8, 2, 5, 1]]
+    assert d2.internal.rowindex.group_sizes == [3, 2, 2, 1]
+    d3 = d0[::2, :].nlargest(0, 3, groups=True)
+    assert d3.topython() == [[3, 3, 2], [0, 6, 4]]
+    assert d3.internal.rowindex.group_sizes == [2, 1]
+    assert d0.nsmallest(0, 5).internal.rowindex.group_sizes is None
+
+
+def test_topk_bad_params():
+    d0 = dt.Frame([[5, 3, 4], [1, 2, 3]])
+    with pytest.raises(ValueError):
+        d0.nsmallest(0, -1)
+    with pytest.raises(ValueError):
+        d0.nlargest(2, 1)
+
+
+
+#-------------------------------------------------------------------------------
+# Cached ordering
+#-------------------------------------------------------------------------------
+
+def test_sort_cache_reused():
+    d0 = dt.Frame([5, 2, None, 2, 7, 5, 5])
+    assert d0.nunique1() == 3
+    assert d0.nmodal1() == 3
+    ri1 = d0.internal.sort(0, True)
+    ri2 = d0.internal.sort(0, True)
+    assert ri1.tolist() == ri2.tolist() == [2, 1, 3, 0, 5, 6, 4]
+    assert ri1.group_sizes == [1, 2, 3, 1]
+    # Sorting without groups must not return the cached groups
+    ri3 = d0.internal.sort(0)
+    assert ri3.tolist() == ri1.tolist()
+    assert ri3.ngroups == 0
+    d1 = d0.sort(0)
+    assert d1.internal.check()
+    assert d1.topython() == [[None, 2, 2, 5, 5, 5, 7]]
+    assert d1(select=dt.mean(dt.f[0])).topython() == [[26 / 6]]
+    # The frame shares the cached indices, but not the groups
+    d1.materialize()
+    assert d1.topython() == [[None, 2, 2, 5, 5, 5, 7]]
+    assert d0.internal.sort(0, True).group_sizes == [1, 2, 3, 1]
+
+
+def test_sort_cache_invalidated_on_rbind():
+    d0 = dt.Frame([3, 1, 2])
+    assert d0.sort(0).topython() == [[1, 2, 3]]
+    assert d0.nunique1() == 3
+    d0.rbind(dt.Frame([0, 2]))
+    assert d0.sort(0).topython() == [[0, 1, 2, 2, 3]]
+    assert d0.nunique1() == 4
+
+
+def test_sort_cache_invalidated_on_reify():
+    d0 = dt.Frame([list(range(10, 0, -1)), list("abcdefghij")])
+    d1 = d0[::2, :]
+    assert d1.sort(0).topython() == [[2, 4, 6, 8, 10], list("igeca")]
+    assert d1.sort(1).topython() == [[10, 8, 6, 4, 2], list("acegi")]
+    d1.materialize()
+    assert d1.sort(0).topython() == [[2, 4, 6, 8, 10], list("igeca")]
+    assert d1.sort(1).topython() == [[10, 8, 6, 4, 2], list("acegi")]
+
+
+
+#-------------------------------------------------------------------------------
+# Presorted data
+#-------------------------------------------------------------------------------
+
+@pytest.mark.parametrize("st", [stype.bool8, stype.int32, stype.float64,
+                                stype.str32])
+def test_sort_presorted(st):
+    if st == stype.bool8:
+        src = [None, None, False, False, True]
+    elif st == stype.str32:
+        src = [None, "", "a", "a", "ab", "b", "b", "ba", "c"]
+    else:
+        src = [None, -5, -5, 0, 1, 1, 1, 7, 100]
+    d0 = dt.Frame([src, list(range(len(src)))],
+                  stypes=[st, stype.int32])
+    d1 = d0.sort(0)
+    assert d1.internal.check()
+    assert d1.topython() == [src, list(range(len(src)))]
+    ri = d0.internal.sort(0, True)
+    assert ri.tolist() == list(range(len(src)))
+    assert ri.group_sizes == [len(list(g)) for _, g in itertools.groupby(src)]
+
+
+@pytest.mark.parametrize("st", [stype.int32, stype.float64, stype.str32])
+def test_sort_reverse_sorted(st):
+    if st == stype.str32:
+        src = ["z", "xyz", "xy", "x", "d", "aa", "a", "", None]
+    else:
+        src = [100, 7, 6, 5, 1, 0, -3, -5, None]
+    d0 = dt.Frame([src, list(range(len(src)))],
+                  stypes=[st, stype.int32])
+    d1 = d0.sort(0)
+    assert d1.internal.check()
+    assert d1.topython() == [src[::-1], list(range(len(src)))[::-1]]
+    ri = d0.internal.sort(0, True)
+    assert ri.group_sizes == [1] * len(src)
+    # A view into the reverse-sorted data is sorted
+    d2 = d0[::-1, :]
+    assert d2.sort(0).topython() == d2.topython()
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32) for _ in range(5)])
+def test_sort_few_runs(seed):
+    random.seed(seed)
+    n = random.choice([10, 100, 1000, 50000])
+    nruns = random.randint(2, 8)
+    strs = random.choice([True, False])
+    if strs:
+        src = ["".join(random.choice("abc") for _ in range(random.randint(0, 4)))
+               for _ in range(n)]
+    else:
+        src = [random.choice([None, random.randint(-50, 50)]) for _ in range(n)]
+    cuts = sorted(random.sample(range(n), nruns - 1))
+    parts = [src[i:j] for i, j in zip([0] + cuts, cuts + [n])]
+    src = sum((sorted_with_nas(p, False, False) for p in parts), [])
+    d0 = dt.Frame([src, list(range(n))])
+    d1 = d0.sort(0)
+    assert d1.internal.check()
+    order = sorted(range(n), key=lambda i: (src[i] is not None, src[i] or 0)
+                                           if not strs else src[i])
+    assert d1.topython() == [[src[i] for i in order], order]
+    assert dt.Frame(src).nunique1() == len(set(src) - {None})
+
+
+@pytest.mark.parametrize("strs", [False, True])
+def test_sort_few_runs_parallel(strs):
+    # Runs and groups are found by several threads, and both cross the
+    # boundaries between the parts of the data scanned by each thread
+    n = 20000
+    src = [(i * 37) % 1000 // 10 for i in range(n)]
+    src = sorted(src[:7000]) + sorted(src[7000:])
+    if strs:
+        src = ["%03d" % x for x in src]
+    d0 = dt.Frame(src)
+    dt.options.sort.nthreads = 8
+    try:
+        ri = d0.internal.sort(0, True)
+    finally:
+        del dt.options.sort.nthreads
+    order = sorted(range(n), key=lambda i: src[i])
+    assert ri.tolist() == order
+    assert ri.group_sizes == [len(list(g)) for _, g in
+                              itertools.groupby(sorted(src))]
+
+
+
+def test_sort_few_runs_option_changed():
+    # The runs are counted while `max_merge_runs` is too small for their
+    # starts to be recorded; the sort then has to find them by itself
+    src = [5, 6, 7, 1, 2, 3, 4, 0, 9, 8, 9]
+    d0 = dt.Frame(src)
+    order = sorted(range(len(src)), key=lambda i: src[i])
+    dt.options.sort.max_merge_runs = 2
+    try:
+        assert d0.internal.sort(0, False).tolist() == order
+    finally:
+        del dt.options.sort.max_merge_runs
+    ri = d0.internal.sort(0, True)
+    assert ri.tolist() == order
+    assert ri.group_sizes == [1, 1, 1, 1, 1, 1, 1, 1, 1, 2]
+
+
+#-------------------------------------------------------------------------------
+# External sort
+#-------------------------------------------------------------------------------
+
+def sort_with_memory_limit(d, cols, nalast, limit):
+    dt.options.sort.max_memory = limit
+    try:
+        ri = d.internal.sort(cols, True, nalast)
+        return ri.tolist(), ri.group_sizes
+    finally:
+        del dt.options.sort.max_memory
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32) for _ in range(5)])
+def test_sort_external_random(seed):
+    random.seed(seed)
+    n = random.choice([10, 100, 1000, 20000])
+    k = random.choice([3, 50, 10**6])
+    src = [[random.choice([None, random.randint(-k, k)]) for _ in range(n)],
+           [random.choice([None, -0.0, 0.0, math.inf, random.random()])
+            for _ in range(n)],
+           [random.choice([None, "", "a", "abc" * 5, str(random.randint(0, k))])
+            for _ in range(n)],
+           [random.choice([None, True, False]) for _ in range(n)]]
+    d0 = dt.Frame(src)
+    if random.random() < 0.3:
+        d0 = d0[::-2, :]
+    ncols = random.randint(1, 3)
+    cols = [random.choice([i, ~i]) for i in random.sample(range(4), ncols)]
+    nalast = random.choice([False, True])
+    limit = random.choice([1, 100, 1000, 30000])
+    ri = d0.internal.sort(cols, True, nalast)
+    assert sort_with_memory_limit(d0, cols, nalast, limit) == \
+        (ri.tolist(), ri.group_sizes)
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32) for _ in range(3)])
+def test_sort_external_long_groups(seed, sort_int64):
+    # Few distinct keys, so that the groups are much longer than the parts
+    # merged by each thread, and cross the boundaries between the parts
+    random.seed(seed)
+    n = 50000
+    src = [[random.randint(0, 4) for _ in range(n)],
+           [random.choice(["a", "b", None]) for _ in range(n)]]
+    d0 = dt.Frame(src)
+    ri = d0.internal.sort([0, 1], True)
+    dt.options.sort.nthreads = 8
+    try:
+        for limit in [1000, 30000]:
+            res = sort_with_memory_limit(d0, [0, 1], False, limit)
+            assert res == (ri.tolist(), ri.group_sizes)
+    finally:
+        del dt.options.sort.nthreads
+    assert len(ri.group_sizes) == 15
+
+
+def test_sort_external_skewed_runs():
+    # The runs have different distributions (the first one holds only small
+    # values), so the splitters must come from all of them. There are many
+    # ties, which cross the boundaries between the runs and the parts.
+    n = 30000
+    src = [i % 3 for i in range(n // 3)] + \
+          [(i * 7) % 50 for i in range(n - n // 3)]
+    # Sort by 2 columns, since the ordering of a single column is cached
+    d0 = dt.Frame([src, [i % 2 for i in range(n)]])
+    ri = d0.internal.sort([0, 1], True)
+    dt.options.sort.nthreads = 8
+    try:
+        for limit in [5000, 50000]:
+            res = sort_with_memory_limit(d0, [0, 1], False, limit)
+            assert res == (ri.tolist(), ri.group_sizes)
+    finally:
+        del dt.options.sort.nthreads
+    assert ri.tolist() == sorted(range(n), key=lambda i: (src[i], i % 2))
+
+
+@pytest.mark.parametrize("st", [stype.int32, stype.float64, stype.str32])
+def test_sort_external_column(st):
+    # Single-column ascending sorts go through `Column::sort()`
+    n = 1000
+    src = [None if i % 7 == 0 else (i * 37) % 101 for i in range(n)]
+    if st == stype.float64:
+        src = [None if x is None else x / 4 for x in src]
+    if st == stype.str32:
+        src = [None if x is None else "x%03d" % x for x in src]
+    d0 = dt.Frame([src], stypes=[st])
+    order, sizes = sort_with_memory_limit(d0, 0, False, 500)
+    srtd = sorted_with_nas(src)
+    assert order == sorted(range(n), key=lambda i: srtd.index(src[i]))
+    assert sizes == [len(list(g)) for _, g in itertools.groupby(srtd)]
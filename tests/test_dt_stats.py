@@ -5,6 +5,8 @@
 #   file, You can obtain one at http://mozilla.org/MPL/2.0/.
 #-------------------------------------------------------------------------------
 import pytest
+import bisect
+import math
 import datatable as dt
 import random
 import statistics
@@ -260,6 +262,137 @@ def test_dt_n_unique(src):
     assert dtr.scalar() == dt0.nunique1()
 
 
+@pytest.mark.parametrize("src", srcs_all)
+def test_dt_n_unique_approx(src):
+    dt0 = dt.Frame(src)
+    dtr = dt0.nunique(approx=True)
+    assert dtr.internal.check()
+    assert dtr.stypes == (stype.int64, )
+    assert dtr.shape == (1, 1)
+    assert dtr.names == dt0.names
+    # For small numbers of unique values the estimate is exact
+    assert dtr.scalar() == n_unique(src)
+    assert dtr.scalar() == dt0.nunique1(approx=True)
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32)])
+def test_dt_n_unique_approx_large(seed):
+    random.seed(seed)
+    n = 500000
+    a = [random.getrandbits(17) for _ in range(n)]
+    s = ["%x" % x for x in a[:100000]]
+    df = dt.Frame({"A": a, "B": [x * 0.5 for x in a], "S": s * 5})
+    exact = [n_unique(a), n_unique(a), n_unique(s)]
+    approx = df.nunique(approx=True).topython()
+    for i in range(3):
+        assert abs(approx[i][0] - exact[i]) < 0.05 * exact[i]
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32)])
+def test_dt_n_unique_approx_error(seed):
+    # The relative standard error is about 1.6%, with no noticeable bias,
+    # including the mid-range where small-range corrections used to kick in
+    random.seed(seed)
+    for n in [2000, 6000, 10000, 14000, 30000]:
+        errs = []
+        for _ in range(20):
+            src = random.sample(range(1 << 40), n)
+            errs.append(dt.Frame(src).nunique1(approx=True) / n - 1)
+        bias = sum(errs) / len(errs)
+        rmse = math.sqrt(sum(e * e for e in errs) / len(errs))
+        assert abs(bias) < 0.012
+        assert rmse < 0.03
+
+
+def test_dt_n_unique_approx_rbind():
+    a = list(range(100000, 130000))
+    b = list(range(120000, 160000))
+    df1 = dt.Frame(a)
+    df2 = dt.Frame(b)
+    df1.nunique1(approx=True)
+    df2.nunique1(approx=True)
+    df1.rbind(df2)
+    # The merged sketch is identical to the sketch of the combined data
+    assert df1.nunique1(approx=True) == dt.Frame(a + b).nunique1(approx=True)
+    assert abs(df1.nunique1(approx=True) - 60000) < 3000
+
+
+
+#-------------------------------------------------------------------------------
+# Quantile / median functions
+#-------------------------------------------------------------------------------
+
+def t_quantile(arr, q):
+    arr = sorted(x for x in arr if x is not None and not isnan(x))
+    n = len(arr)
+    if n == 0:
+        return None
+    h = q * (n - 1)
+    lo = int(h)
+    if h == lo or arr[lo] == arr[lo + 1]:
+        return arr[lo]
+    return arr[lo] + (h - lo) * (arr[lo + 1] - arr[lo])
+
+
+@pytest.mark.parametrize("src", srcs_numeric)
+@pytest.mark.parametrize("approx", [False, True])
+def test_dt_quantile(src, approx):
+    dt0 = dt.Frame(src)
+    for q in [0, 0.25, 0.5, 0.75, 0.9, 1]:
+        dtr = dt0.quantile(q, approx=approx)
+        assert dtr.internal.check()
+        assert dtr.names == dt0.names
+        assert dtr.stypes == (stype.float64, )
+        assert dtr.shape == (1, 1)
+        # For small inputs the sketch is exact
+        assert list_equals(dtr.topython(), [[t_quantile(src, q)]])
+        assert list_equals([dt0.quantile1(q, approx)], [t_quantile(src, q)])
+    assert list_equals([dt0.median1(approx)], [t_quantile(src, 0.5)])
+
+
+def test_dt_quantile_str():
+    dt0 = dt.Frame(srcs_str[0])
+    assert dt0.median().topython() == [[None]]
+    assert dt0.median1(approx=True) is None
+
+
+def test_dt_quantile_bad():
+    dt0 = dt.Frame([1, 2, 3])
+    with pytest.raises(ValueError):
+        dt0.quantile(1.5)
+    with pytest.raises(ValueError):
+        dt0.quantile1(-0.1, approx=True)
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32)])
+def test_dt_quantile_approx_large(seed):
+    random.seed(seed)
+    n = 300000
+    a = [random.gauss(0, 1) for _ in range(n)]
+    b = [random.randint(-1000, 1000) for _ in range(n)]
+    df = dt.Frame({"A": a, "B": b})
+    sa = sorted(a)
+    sb = sorted(b)
+    for q in [0.01, 0.25, 0.5, 0.75, 0.99]:
+        ra, rb = df.quantile(q, approx=True).topython()
+        ea, eb = df.quantile(q).topython()
+        assert ea == [t_quantile(a, q)]
+        assert eb == [t_quantile(b, q)]
+        # The rank of the estimate should be within the error bound
+        for s, r in [(sa, ra[0]), (sb, rb[0])]:
+            lo = bisect.bisect_left(s, r) / n
+            hi = bisect.bisect_right(s, r) / n
+            assert lo - 0.0165 <= q <= hi + 0.0165
+
+
+def test_dt_quantile_approx_reproducible():
+    n = 200000
+    a = [(i * 7919) % 100003 for i in range(n)]
+    res = [dt.Frame(a).quantile(q, approx=True).topython()
+           for _ in range(5) for q in [0.25, 0.5, 0.75]]
+    assert res[:3] * 5 == res
+
+
 
 #-------------------------------------------------------------------------------
 # Mode function
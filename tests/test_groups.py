@@ -4,10 +4,13 @@
 #   License, v. 2.0. If a copy of the MPL was not distributed with this
 #   file, You can obtain one at http://mozilla.org/MPL/2.0/.
 #-------------------------------------------------------------------------------
+import builtins
+import math
 import datatable as dt
 import pytest
 import random
-from datatable import f, mean
+from datatable import (f, mean, min, max, sd, sum, count, first, last,
+                       median, quantile)
 
 
 
@@ -19,7 +22,7 @@ def test_groups_internal0():
     assert ri.group_offsets is None
 
 
-def test_groups_internal1():
+def test_groups_internal1(sort_int64):
     d0 = dt.Frame([2, 7, 2, 3, 7, 2, 2, 0, None, 0])
     ri = d0.internal.sort(0, True)
     assert d0.nrows == 10
@@ -28,7 +31,7 @@ def test_groups_internal1():
     assert ri.group_offsets == [0, 1, 3, 7, 8, 10]
 
 
-def test_groups_internal2():
+def test_groups_internal2(sort_int64):
     d0 = dt.DataTable([[1,   5,   3,   2,   1,    3,   1,   1,   None],
                        ["a", "b", "c", "a", None, "f", "b", "h", "d"]],
                       names=["A", "B"])
@@ -48,7 +51,7 @@ def test_groups_internal2():
                              [None, "a", "a", "b", "b", "c", "d", "f", "h"]]
 
 
-def test_groups_internal3():
+def test_groups_internal3(sort_int64):
     f0 = dt.Frame({"A": [1, 2, 1, 3, 2, 2, 2, 1, 3, 1], "B": range(10)})
     f1 = f0(select=[f.A, "B", f.A + f.B], groupby="A")
     assert f1.internal.check()
@@ -110,12 +113,278 @@ def test_groups_internal5_strs(seed):
 # Groupby on small datasets
 #-------------------------------------------------------------------------------
 
-def test_groups1():
+def test_groups1(sort_int64):
     f0 = dt.Frame({"A": [1, 2, 1, 2, 1, 3, 1, 1],
                    "B": [0, 1, 2, 3, 4, 5, 6, 7]})
     f1 = f0(select=mean(f.B), groupby=f.A)
-    assert f1.stypes == (dt.float64,)
-    assert f1.topython() == [[3.8, 2.0, 5.0]]
+    assert f1.stypes == (dt.int8, dt.float64,)
+    assert f1.names == ("A", "V0")
+    assert f1.topython() == [[1, 2, 3], [3.8, 2.0, 5.0]]
+
+
+def test_groups_multi1(sort_int64):
+    f0 = dt.Frame({"A": [1, 1, 2, 2, 1, None, 1],
+                   "B": ["x", "y", "x", "x", "x", "y", None],
+                   "C": [1, 2, 3, 4, 5, 6, 7]})
+    f1 = f0(select=[mean(f.C), max(f.C)], groupby=[f.A, "B"])
+    assert f1.internal.check()
+    assert f1.names[:2] == ("A", "B")
+    assert f1.topython() == [[None, 1, 1, 1, 2],
+                             ["y", None, "x", "y", "x"],
+                             [6.0, 7.0, 3.0, 2.0, 3.5],
+                             [6, 7, 5, 2, 4]]
+    f2 = f0(groupby=["A", "B"])
+    assert f2.internal.check()
+    assert f2.internal.rowindex.group_sizes == [1, 1, 2, 1, 2]
+    assert f2.topython() == [[None, 1, 1, 1, 1, 2, 2],
+                             ["y", None, "x", "x", "y", "x", "x"],
+                             [6, 7, 1, 5, 2, 3, 4]]
+
+
+def test_groups_multi2_renamed():
+    f0 = dt.Frame({"A": [3, 1, 3, 1], "B": [0, 0, 1, 0], "C": [1, 2, 3, 4]})
+    f1 = f0(select=sd(f.C), groupby={"a": f.A, "b": f.B})
+    assert f1.names == ("a", "b", "V0")
+    assert f1.topython() == [[1, 3, 3], [0, 0, 1], [1.4142135623730951,
+                                                    None, None]]
+    f2 = f0(select=min(f.C), groupby=slice(0, 2))
+    assert f2.names == ("A", "B", "V0")
+    assert f2.topython() == [[1, 3, 3], [0, 0, 1], [2, 1, 3]]
+
+
+def test_groups_multi_reducers():
+    # All reducers are evaluated together; those applied to the same column
+    # share it.
+    f0 = dt.Frame({"A": [1, 2, 1, 2, 1, 3, 1, 1],
+                   "B": [0, 1, 2, 3, 4, 5, 6, 7],
+                   "C": [1.5, None, 2.5, 0.5, 1.0, 3.0, None, -1.0]})
+    f1 = f0(select=[mean(f.B), min(f.C), max(f.B), mean(f.C), max(f.C),
+                    min(f.B + 1)], groupby="A")
+    assert f1.internal.check()
+    assert f1.topython() == [[1, 2, 3],
+                             [3.8, 2.0, 5.0],
+                             [-1.0, 0.5, 3.0],
+                             [7, 3, 5],
+                             [1.0, 0.5, 3.0],
+                             [2.5, 0.5, 3.0],
+                             [1, 2, 6]]
+    f2 = f0(select=[mean(f.B), max(f.C), min(f.B)])
+    assert f2.topython() == [[3.5], [3.0], [0]]
+
+
+def test_groups_reducers_sum_count_first_last():
+    f0 = dt.Frame({"A": [1, 2, 1, 2, 1, 3, 1, 1],
+                   "B": [0, 1, None, 3, 4, 5, 6, 7],
+                   "C": [1.5, None, 2.5, 0.5, 1.0, 3.0, None, -1.0]})
+    f1 = f0(select=[sum(f.B), count(f.B), first(f.B), last(f.C), sum(f.C)],
+            groupby="A")
+    assert f1.internal.check()
+    assert f1.stypes == (dt.int8, dt.int64, dt.int64, dt.int8, dt.float64,
+                         dt.float64)
+    assert f1.topython() == [[1, 2, 3],
+                             [17, 4, 5],
+                             [4, 2, 1],
+                             [0, 1, 5],
+                             [-1.0, 0.5, 3.0],
+                             [4.0, 0.5, 3.0]]
+    f2 = f0(select=[sum(f.B), count(f.C), first(f.C), last(f.B)])
+    assert f2.topython() == [[26], [6], [1.5], [7]]
+
+
+def test_groups_min_max_all_na():
+    f0 = dt.Frame({"A": [1, 2, 1, 2, 3],
+                   "B": [None, 5, None, 3, None],
+                   "C": [None, 2.5, None, None, 1.0]})
+    f1 = f0(select=[min(f.B), max(f.B), min(f.C), max(f.C)], groupby="A")
+    assert f1.internal.check()
+    assert f1.topython() == [[1, 2, 3],
+                             [None, 3, None],
+                             [None, 5, None],
+                             [None, 2.5, 1.0],
+                             [None, 2.5, 1.0]]
+    f2 = f0[f.A == 1, :](select=[min(f.B), max(f.C)])
+    assert f2.topython() == [[None], [None]]
+
+
+def test_groups_sum_int64_wraps():
+    # Overflow wraps around (without undefined behavior)
+    f0 = dt.Frame({"A": [1, 1, 2, 1], "B": [2**62, 2**62, 5, 2**62]})
+    f1 = f0(select=sum(f.B), groupby="A")
+    assert f1.topython() == [[1, 2], [-2**62, 5]]
+
+
+def test_groups_sum_builtin_fallback():
+    # `dt.sum` applied to anything other than an expression behaves as the
+    # builtin `sum`
+    assert sum is dt.sum
+    assert sum([1, 2, 3]) == 6
+    assert sum([0.5, 1.5], 10) == builtins.sum([0.5, 1.5], 10)
+
+
+def test_groups_reducers_median_quantile():
+    f0 = dt.Frame({"A": [1, 2, 1, 2, 1, 3, 1, 1],
+                   "B": [0, 1, None, 3, 4, 5, 6, 7],
+                   "C": [1.5, None, 2.5, 0.5, 1.0, 3.0, None, -1.0]})
+    f1 = f0(select=[median(f.B), quantile(f.C, 0.25), quantile(f.B, 1)],
+            groupby="A")
+    assert f1.topython() == [[1, 2, 3],
+                             [5.0, 2.0, 5.0],
+                             [0.5, 0.5, 3.0],
+                             [7.0, 3.0, 5.0]]
+    f2 = f0(select=[median(f.B), median(f.C), quantile(f.B, 0)])
+    assert f2.topython() == [[4.0], [1.25], [0.0]]
+    with pytest.raises(ValueError):
+        quantile(f.B, 1.5)
+
+
+def test_groups_quantile_large_int64():
+    big = 2**62
+    f0 = dt.Frame({"A": [1, 1, 1, 2, 2],
+                   "B": [big + 5, big + 1, big + 3, -big, big]})
+    f1 = f0(select=[median(f.B), quantile(f.B, 0.75)], groupby="A")
+    assert f1.topython() == [[1, 2],
+                             [float(big + 3), 0.0],
+                             [float(big + 4), float(big // 2)]]
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32)])
+def test_groups_large6_quantiles(seed):
+    random.seed(seed)
+    sizes = [random.choice([1, 2, 5, 100]) for _ in range(50)]
+    sizes[random.randint(0, 49)] = 200000
+    src_a = [i for i, s in enumerate(sizes) for _ in range(s)]
+    src_b = [random.random() if random.random() < 0.9 else None
+             for _ in src_a]
+    f0 = dt.Frame({"A": src_a, "B": src_b})
+    qs = [0, 0.1, 0.5, 0.77, 1]
+    f1 = f0(select=[quantile(f.B, q) for q in qs], groupby="A")
+    res = f1.topython()
+    i0 = 0
+    for g, s in enumerate(sizes):
+        vals = sorted(x for x in src_b[i0:i0 + s] if x is not None)
+        i0 += s
+        for j, q in enumerate(qs):
+            if not vals:
+                assert res[j + 1][g] is None
+                continue
+            h = (len(vals) - 1) * q
+            lo = int(h)
+            exp = vals[lo]
+            if h > lo:
+                exp += (h - lo) * (vals[lo + 1] - vals[lo])
+            assert res[j + 1][g] == pytest.approx(exp, abs=1e-15)
+
+
+def test_groups_multi_computed_key():
+    f0 = dt.Frame({"A": [1, 2, 3]})
+    with pytest.raises(TypeError):
+        f0(select=mean(f.A), groupby=[f.A, f.A + 1])
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32)])
+def test_groups_multi_random(seed):
+    random.seed(seed)
+    n = 2000
+    src_a = [random.randint(0, 5) for _ in range(n)]
+    src_b = [random.choice(["a", "b", "c", None]) for _ in range(n)]
+    src_c = [random.randint(-100, 100) for _ in range(n)]
+    f0 = dt.Frame({"A": src_a, "B": src_b, "C": src_c})
+    f1 = f0(select=max(f.C), groupby=[f.B, f.A])
+    assert f1.internal.check()
+    groups = {}
+    for a, b, c in zip(src_a, src_b, src_c):
+        key = (b is not None, b or "", a)
+        groups[key] = c if key not in groups else builtins.max(groups[key], c)
+    keys = sorted(groups)
+    assert f1.topython() == [[k[1] if k[0] else None for k in keys],
+                             [k[2] for k in keys],
+                             [groups[k] for k in keys]]
+
+
+
+#-------------------------------------------------------------------------------
+# Hash groupby
+#-------------------------------------------------------------------------------
+
+def groups_as_sets(ri):
+    rows = ri.tolist()
+    offs = ri.group_offsets
+    return sorted(sorted(rows[offs[i]:offs[i + 1]]) for i in range(ri.ngroups))
+
+
+def test_hash_groupby_internal1(sort_int64):
+    d0 = dt.Frame([2, 7, 2, 3, 7, 2, 2, 0, None, 0])
+    ri = d0.internal.hash_groupby(0)
+    assert ri.ngroups == 5
+    assert groups_as_sets(ri) == [[0, 2, 5, 6], [1, 4], [3], [7, 9], [8]]
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32)])
+def test_hash_groupby_internal2(seed, sort_int64):
+    random.seed(seed)
+    n = int(random.expovariate(0.00005)) + 2
+    src_a = [random.choice([None, 0.5, -1.0, 2.25]) for _ in range(n)]
+    src_b = ["%x" % random.getrandbits(6) if random.random() < 0.9 else None
+             for _ in range(n)]
+    src_c = [random.getrandbits(20) for _ in range(n)]
+    d0 = dt.Frame({"A": src_a, "B": src_b, "C": src_c})
+    for cols in [0, 1, 2, [0, 1], [1, 0], [2, 1, 0]]:
+        rh = d0.internal.hash_groupby(cols)
+        rs = d0.internal.sort(cols, True)
+        assert rh.ngroups == rs.ngroups
+        assert groups_as_sets(rh) == groups_as_sets(rs)
+    d1 = d0[::-3, :]
+    rh = d1.internal.hash_groupby([0, 1])
+    rs = d1.internal.sort([0, 1], True)
+    assert groups_as_sets(rh) == groups_as_sets(rs)
+
+
+@pytest.mark.parametrize("st", ["bool8", "int8", "int16", "int32", "int64",
+                                "float32", "float64", "str32", "str64"])
+def test_hash_groupby_single_key(st, sort_int64):
+    # Each stype of a single key column has its own specialized hashing
+    n = 5000
+    if st == "bool8":
+        src = [[True, False, None][i % 3] for i in range(n)]
+    elif st.startswith("str"):
+        src = [None if i % 17 == 0 else "k%d" % (i % 23) for i in range(n)]
+    else:
+        src = [None if i % 17 == 0 else (i * 7) % 41 for i in range(n)]
+    d0 = dt.Frame(src, stype=st)
+    dt.options.nthreads = 2
+    try:
+        rh = d0.internal.hash_groupby(0)
+    finally:
+        del dt.options.nthreads
+    rs = d0.internal.sort(0, True)
+    assert rh.ngroups == rs.ngroups
+    assert groups_as_sets(rh) == groups_as_sets(rs)
+
+
+def test_hash_groupby_frame(sort_int64):
+    f0 = dt.Frame({"A": [3, 1, 3, 1, None, 3], "B": ["a", "b", "a", "a", "c",
+                                                     None],
+                   "C": [1, 2, 3, 4, 5, 6]})
+    try:
+        dt.options.groupby.method = "hash"
+        f1 = f0(select=[mean(f.C), max(f.C)], groupby=["A", "B"])
+    finally:
+        del dt.options.groupby.method
+    assert f1.internal.check()
+    assert f1.names[:2] == ("A", "B")
+    res = sorted(zip(*f1.topython()), key=repr)
+    assert res == sorted([(3, "a", 2.0, 3), (1, "b", 2.0, 2), (1, "a", 4.0, 4),
+                          (None, "c", 5.0, 5), (3, None, 6.0, 6)], key=repr)
+
+
+def test_hash_groupby_bad_method():
+    f0 = dt.Frame({"A": [1, 2, 3]})
+    try:
+        dt.options.groupby.method = "random"
+        with pytest.raises(ValueError):
+            f0(select=mean(f.A), groupby="A")
+    finally:
+        del dt.options.groupby.method
 
 
 
@@ -143,3 +412,57 @@ def test_groups_large2_str(n, seed):
     f1 = f0(groupby="A")
     assert f1.internal.check()
     assert f1.internal.rowindex.ngroups == len(set(src))
+
+
+def test_groups_large3_multi_radix():
+    # Large groups get re-sorted recursively; the grouping information from
+    # all sub-ranges must be consolidated together.
+    n = 100000
+    xs = [(i * 7919) % 1001 for i in range(n)]
+    f0 = dt.Frame({"A": xs})
+    f1 = f0(groupby="A")
+    assert f1.internal.check()
+    assert f1.internal.rowindex.ngroups == 1001
+    assert f0.nunique1() == 1001
+
+
+def test_groups_large4_hash():
+    n = 251 * 4000
+    xs = [(i * 19) % 251 for i in range(n)]
+    f0 = dt.Frame({"A": xs})
+    ri = f0.internal.hash_groupby(0)
+    assert ri.ngroups == 251
+    assert ri.group_sizes == [4000] * 251
+    assert groups_as_sets(ri) == groups_as_sets(f0.internal.sort(0, True))
+
+
+@pytest.mark.parametrize("seed", [random.getrandbits(32)])
+def test_groups_large5_reducers(seed):
+    # Mix of small groups (reduced in batches) and large groups (each split
+    # into chunks that are reduced in parallel and then merged).
+    random.seed(seed)
+    sizes = [random.choice([1, 2, 10, 1000]) for _ in range(100)]
+    sizes[random.randint(0, 99)] = 300000
+    sizes[random.randint(0, 99)] = 140000
+    src_a = [i for i, s in enumerate(sizes) for _ in range(s)]
+    src_b = [random.random() * 100 if random.random() < 0.9 else None
+             for _ in src_a]
+    f0 = dt.Frame({"A": src_a, "B": src_b})
+    f1 = f0(select=[mean(f.B), sd(f.B), min(f.B), max(f.B)], groupby="A")
+    assert f1.internal.check()
+    res = f1.topython()
+    assert res[0] == list(range(100))
+    i0 = 0
+    for g, s in enumerate(sizes):
+        vals = [x for x in src_b[i0:i0 + s] if x is not None]
+        i0 += s
+        if not vals:
+            assert res[1][g] is None
+            continue
+        m = math.fsum(vals) / len(vals)
+        assert res[1][g] == pytest.approx(m, rel=1e-12)
+        if len(vals) > 1:
+            v = math.fsum((x - m)**2 for x in vals) / (len(vals) - 1)
+            assert res[2][g] == pytest.approx(math.sqrt(v), rel=1e-9)
+        assert res[3][g] == builtins.min(vals)
+        assert res[4][g] == builtins.max(vals)